@@ -0,0 +1,372 @@
+#include "AllocationTracker.h"
+#include "Physics.h"
+#include "ProfileManager.h"
+#include "ProfileWriter.h"
+#include "Simulation.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Microbenchmarks for the per-frame and per-match hot paths, written as a
+// table and, with --json FILE, as JSON to diff between commits.
+// Simulation::step is built from the physics:: calls timed here, and the
+// menu's lists from the ProfileManager page queries timed here, so
+// neither needs a window.
+// Each benchmark is calibrated to run for at least MIN_RUN_MS, then
+// repeated; the median and fastest time per operation are reported.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const double MIN_RUN_MS = 50.0;
+const int REPETITIONS = 5;
+
+// Stop the optimizer from discarding a result
+template <typename T>
+void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    std::uint64_t iterations;   // Per repetition
+    double medianNs;            // Per operation
+    double minNs;
+};
+
+// Runs benchmarks whose body performs a given number of operations
+class Harness {
+private:
+    std::string filter;
+    std::vector<Result> results;
+
+    static double runOnce(const std::function<void(std::uint64_t)>& body, std::uint64_t iterations) {
+        auto start = Clock::now();
+        body(iterations);
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+public:
+    explicit Harness(const std::string& nameFilter) : filter(nameFilter) {}
+
+    bool wants(const std::string& name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+
+    // Grow the iteration count until one run takes MIN_RUN_MS, then repeat
+    void run(const std::string& name, const std::function<void(std::uint64_t)>& body) {
+        if (!wants(name)) {
+            return;
+        }
+        std::uint64_t iterations = 1;
+        double elapsed = runOnce(body, iterations);
+        while (elapsed < MIN_RUN_MS * 1e6 && iterations < (1ULL << 40)) {
+            double scale = elapsed > 0 ? MIN_RUN_MS * 1e6 * 1.2 / elapsed : 10.0;
+            iterations = static_cast<std::uint64_t>(iterations * std::min(std::max(scale, 1.5), 100.0)) + 1;
+            elapsed = runOnce(body, iterations);
+        }
+
+        std::vector<double> perOp;
+        perOp.push_back(elapsed / iterations);
+        for (int i = 1; i < REPETITIONS; i++) {
+            perOp.push_back(runOnce(body, iterations) / iterations);
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        Result result{ name, iterations, perOp[perOp.size() / 2], perOp.front() };
+        std::printf("%-52s %14.1f %14.1f %12llu\n", name.c_str(), result.medianNs, result.minNs,
+                    static_cast<unsigned long long>(iterations));
+        std::fflush(stdout);
+        results.push_back(result);
+    }
+
+    // {"context": {...}, "benchmarks": [{"name", "iterations", "median_ns", "min_ns"}, ...]}
+    bool writeJson(const std::string& path, const std::vector<int>& sizes) const {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Failed to open " << path << std::endl;
+            return false;
+        }
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        std::fprintf(file, "{\n  \"context\": {\n    \"date\": \"%s\",\n    \"compiler\": \"%s\",\n", date, __VERSION__);
+        std::fprintf(file, "    \"allocation_tracking\": %s,\n    \"trace\": %s,\n    \"profile_counts\": [",
+                     alloc::isTracking() ? "true" : "false", trace::isCompiledIn() ? "true" : "false");
+        for (std::size_t i = 0; i < sizes.size(); i++) {
+            std::fprintf(file, "%s%d", i ? ", " : "", sizes[i]);
+        }
+        std::fprintf(file, "],\n    \"repetitions\": %d\n  },\n  \"benchmarks\": [", REPETITIONS);
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const Result& result = results[i];
+            std::fprintf(file, "%s\n    {\"name\": \"%s\", \"iterations\": %llu, \"median_ns\": %.3f, \"min_ns\": %.3f}",
+                         i ? "," : "", result.name.c_str(), static_cast<unsigned long long>(result.iterations),
+                         result.medianNs, result.minNs);
+        }
+        std::fprintf(file, "\n  ]\n}\n");
+        if (std::fclose(file) != 0) {
+            std::cerr << "Failed to write " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+// Ball and paddles as a fresh match lays them out
+SimulationState matchStart() {
+    Simulation simulation;
+    simulation.resetMatch(1);
+    return simulation.getState();
+}
+
+void benchPhysics(Harness& harness) {
+    const SimulationConfig config;
+    const SimulationState start = matchStart();
+
+    // A serve in flight, bouncing between the walls
+    harness.run("physics::updateBall", [&](std::uint64_t iterations) {
+        BallState ball = start.ball;
+        ball.vx = 240.0f;
+        ball.vy = 420.0f;
+        for (std::uint64_t i = 0; i < iterations; i++) {
+            keep(physics::updateBall(ball, 1.0f / 120, config.fieldHeight));
+            if (ball.x > config.fieldWidth) {
+                ball.x = start.ball.x;
+            }
+        }
+        keep(ball);
+    });
+
+    // Overlapping paddle 1 and moving into it, so every call bounces
+    BallState incoming = start.ball;
+    incoming.x = start.paddle1.x + start.paddle1.width - incoming.radius;
+    incoming.y = start.paddle1.y + start.paddle1.height / 3;
+    incoming.vx = -300.0f;
+    incoming.vy = 60.0f;
+    harness.run("physics::checkPaddleCollision/hit", [&](std::uint64_t iterations) {
+        for (std::uint64_t i = 0; i < iterations; i++) {
+            BallState ball = incoming;
+            keep(ball);
+            keep(physics::checkPaddleCollision(ball, start.paddle1));
+            keep(ball);
+        }
+    });
+
+    harness.run("physics::checkPaddleCollision/miss", [&](std::uint64_t iterations) {
+        BallState ball = start.ball;
+        for (std::uint64_t i = 0; i < iterations; i++) {
+            keep(ball);
+            keep(physics::checkPaddleCollision(ball, start.paddle1));
+        }
+    });
+
+    // Alternately past the top wall and in the open
+    harness.run("physics::checkWallCollision", [&](std::uint64_t iterations) {
+        BallState ball = start.ball;
+        ball.vy = -200.0f;
+        for (std::uint64_t i = 0; i < iterations; i++) {
+            ball.y = (i & 1) ? -2.0f : 300.0f;
+            keep(physics::checkWallCollision(ball, config.fieldHeight));
+            keep(ball);
+        }
+    });
+
+    harness.run("physics::resetBall", [&](std::uint64_t iterations) {
+        BallState ball = start.ball;
+        Random rng(7);
+        for (std::uint64_t i = 0; i < iterations; i++) {
+            physics::resetBall(ball, config.fieldWidth, config.fieldHeight, rng);
+            keep(ball);
+        }
+    });
+
+    // The swept step Simulation uses by default
+    harness.run("physics::sweepBall", [&](std::uint64_t iterations) {
+        BallState ball = start.ball;
+        ball.vx = 240.0f;
+        ball.vy = 420.0f;
+        bool wallHit = false;
+        bool paddleHit = false;
+        for (std::uint64_t i = 0; i < iterations; i++) {
+            physics::sweepBall(ball, start.paddle1, start.paddle2, 1.0f / 120, config.fieldHeight, wallHit, paddleHit);
+            keep(wallHit);
+            if (ball.x < 0 || ball.x > config.fieldWidth) {
+                ball.x = start.ball.x;
+            }
+        }
+        keep(ball);
+    });
+
+    // Whole ticks of an unattended match, restarted when it ends
+    harness.run("Simulation::step", [&](std::uint64_t iterations) {
+        Simulation simulation;
+        simulation.resetMatch(3);
+        SimulationInput input;
+        for (std::uint64_t i = 0; i < iterations; i++) {
+            input.player1.up = (i / 90) % 3 == 0;
+            input.player2.down = (i / 70) % 3 == 0;
+            if (simulation.step(input, simulation.getTickDuration()).matchOver) {
+                simulation.resetMatch(i);
+            }
+        }
+        keep(simulation.getState().tick);
+    });
+}
+
+// A scratch file in the system's temporary directory (the current one if
+// there is none)
+std::string scratchPath(const std::string& name) {
+    std::error_code error;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(error);
+    return ((error ? std::filesystem::path(".") : dir) / name).string();
+}
+
+// A store of count profiles with spread-out stats
+bool writeStore(const std::string& path, ProfileFormat format, int count, std::vector<std::string>& names) {
+    ProfileSnapshot snapshot;
+    snapshot.generation = 1;
+    names.clear();
+    char name[32];
+    for (int i = 0; i < count; i++) {
+        std::snprintf(name, sizeof(name), "player%08d", i);
+        UserProfile profile(name);
+        profile.wins = (i * 7) % 50;
+        profile.losses = (i * 13) % 50;
+        profile.totalGames = profile.wins + profile.losses;
+        profile.rating = UserProfile::INITIAL_RATING + (i * 37) % 400 - 200;
+        snapshot.profiles.push_back(profile);
+        names.push_back(name);
+    }
+    std::remove((path + ".journal").c_str());
+    return ProfileWriter::writeAtomically(path, ProfileWriter::serialize(snapshot, format));
+}
+
+void removeStore(const std::string& path) {
+    std::remove(path.c_str());
+    std::remove((path + ".journal").c_str());
+}
+
+void benchProfiles(Harness& harness, int count) {
+    const std::string suffix = "/" + std::to_string(count);
+    const ProfileFormat formats[2] = { ProfileFormat::JSON, ProfileFormat::BINARY };
+    std::vector<std::string> names;
+
+    for (ProfileFormat format : formats) {
+        const bool binary = format == ProfileFormat::BINARY;
+        const std::string kind = binary ? "/binary" : "/json";
+        ProfileStoreConfig config;
+        config.path = scratchPath("pong_microbench_" + std::to_string(count) + (binary ? ".bin" : ".json"));
+        config.format = format;
+        if (!writeStore(config.path, format, count, names)) {
+            std::cerr << "Could not write " << config.path << std::endl;
+            continue;
+        }
+
+        ProfileManager manager(config);
+        harness.run("ProfileManager::loadProfiles" + kind + suffix, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; i++) {
+                keep(manager.loadProfiles());
+            }
+        });
+
+        // Compaction is asynchronous; include the write so the cost is real
+        harness.run("ProfileManager::saveProfiles+flush" + kind + suffix, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; i++) {
+                manager.saveProfiles();
+                keep(manager.flush());
+            }
+        });
+
+        // One result with the leaderboards live, as after the menu has shown a rank;
+        // the journal line and any periodic compaction are queued, not waited for
+        std::size_t ranked = manager.getLeaderboardSize(LeaderboardKind::RATING);
+        keep(ranked);
+        std::uint64_t player = 0;
+        harness.run("ProfileManager::updateStats" + kind + suffix, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; i++) {
+                player = (player + 7919) % names.size();
+                manager.updateStats(names[player], (i & 1) != 0);
+            }
+        });
+        manager.flush();
+
+        // The queries behind the menu's profile list and leaderboard screens
+        std::vector<UserProfile> page;
+        harness.run("Menu profile page (getProfilesFrom)" + kind + suffix, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; i++) {
+                const std::string& first = names[(i * 7919) % names.size()];
+                keep(manager.getProfilesFrom(first, 8, page));
+            }
+        });
+        harness.run("Menu leaderboard page (getLeaderboard)" + kind + suffix, [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; i++) {
+                keep(manager.getLeaderboard(LeaderboardKind::RATING, (i * 7919) % names.size(), 7, page));
+            }
+        });
+
+        removeStore(config.path);
+    }
+}
+
+void printUsage() {
+    std::cout << "Usage: pong-bench [--json FILE] [--filter TEXT] [PROFILE_COUNT...]\n"
+              << "  --json FILE    Also write the results to FILE as JSON\n"
+              << "  --filter TEXT  Only run benchmarks whose name contains TEXT\n"
+              << "  Profile store sizes default to 1000 10000 100000\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string jsonPath;
+    std::string filter;
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::atoi(argv[i]) > 0) {
+            sizes.push_back(std::atoi(argv[i]));
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (sizes.empty()) {
+        sizes = { 1000, 10000, 100000 };
+    }
+
+    // ProfileManager reports every load; keep the table readable
+    std::ostringstream discarded;
+    std::streambuf* console = std::cout.rdbuf(discarded.rdbuf());
+
+    Harness harness(filter);
+    std::printf("%-52s %14s %14s %12s\n", "benchmark", "median (ns)", "min (ns)", "iterations");
+    benchPhysics(harness);
+    for (int count : sizes) {
+        benchProfiles(harness, count);
+        discarded.str(std::string());
+    }
+
+    std::cout.rdbuf(console);
+    if (!jsonPath.empty()) {
+        if (!harness.writeJson(jsonPath, sizes)) {
+            return 1;
+        }
+        std::cout << "Wrote " << jsonPath << std::endl;
+    }
+    return 0;
+}
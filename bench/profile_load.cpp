@@ -0,0 +1,226 @@
+#include "ProfileManager.h"
+#include "ProfileWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Startup cost of opening the profile database: wall time and peak resident
+// memory for the old whole-file DOM loader, the streaming (SAX) JSON loader
+// and the memory-mapped binary store (open plus 1000 name lookups).
+// For the two current loaders it also times the menu's type-to-filter
+// search: the slowest keystroke while typing a full name.
+// Every measurement runs in a forked child so peak RSS is not shared
+// (POSIX only).
+
+namespace {
+
+// A scratch file in the system's temporary directory (the current one if
+// there is none)
+std::string scratchPath(const std::string& name) {
+    std::error_code error;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(error);
+    return ((error ? std::filesystem::path(".") : dir) / name).string();
+}
+
+// Peak resident set size of this process in MB
+double peakRssMb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+    return usage.ru_maxrss / 1024.0;            // kilobytes
+#endif
+}
+
+// Write a snapshot with N profiles in the same layout ProfileWriter produces,
+// streamed so the generator itself stays small
+bool writeProfiles(const std::string& path, int count) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "{\n    \"generation\": 1,\n    \"lastSequence\": 0,\n    \"profiles\": [\n");
+    for (int i = 0; i < count; i++) {
+        int wins = (i * 7) % 50;
+        int losses = (i * 13) % 50;
+        std::fprintf(file, "        {\n            \"losses\": %d,\n            \"totalGames\": %d,\n"
+                           "            \"username\": \"player%08d\",\n            \"wins\": %d\n        }%s\n",
+                     losses, wins + losses, i, wins, i + 1 < count ? "," : "");
+    }
+    std::fprintf(file, "    ]\n}");
+    return std::fclose(file) == 0;
+}
+
+// The same profiles as a binary store, built in a child so the parent stays small
+void writeBinaryProfiles(const std::string& path, int count) {
+    std::cout.flush();
+    if (fork() == 0) {
+        ProfileSnapshot snapshot;
+        snapshot.generation = 1;
+        char name[32];
+        for (int i = 0; i < count; i++) {
+            std::snprintf(name, sizeof(name), "player%08d", i);
+            UserProfile profile(name);
+            profile.wins = (i * 7) % 50;
+            profile.losses = (i * 13) % 50;
+            profile.totalGames = profile.wins + profile.losses;
+            snapshot.profiles.push_back(profile);
+        }
+        bool ok = ProfileWriter::writeAtomically(path, BinaryProfileStore::encode(snapshot));
+        std::_Exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    wait(&status);
+}
+
+// The loader ProfileManager used before: parse a DOM, then copy fields out
+std::size_t loadWithDom(const std::string& path) {
+    std::map<std::string, UserProfile> profiles;
+    std::ifstream file(path);
+    json j;
+    file >> j;
+    const json& list = j.is_object() ? j["profiles"] : j;
+    for (const auto& item : list) {
+        UserProfile profile;
+        profile.username = item["username"].get<std::string>();
+        profile.wins = item["wins"].get<int>();
+        profile.losses = item["losses"].get<int>();
+        profile.totalGames = item["totalGames"].get<int>();
+        profiles[profile.username] = profile;
+    }
+    return profiles.size();
+}
+
+// Slowest search keystroke in microseconds: each one fetches a window of
+// matching profiles and checks for more above it, as the menu does
+double slowestKeystroke(const ProfileManager& manager, int count) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "player%08d", count / 3);
+    std::string prefix;
+    std::vector<UserProfile> page;
+    std::vector<UserProfile> above;
+    double slowest = 0;
+    for (const char* c = name; *c; c++) {
+        prefix += *c;
+        auto start = std::chrono::steady_clock::now();
+        manager.getProfilesFrom("", 8, page, prefix);
+        manager.getProfilesBefore(page.empty() ? "" : page.front().username, 1, above, prefix);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if (page.empty()) {
+            return -1;
+        }
+        slowest = std::max(slowest, us);
+    }
+    return slowest;
+}
+
+// The current loader
+std::size_t loadWithSax(const std::string& path, int count, double& keystrokeUs) {
+    std::cout.setstate(std::ios::failbit); // Silence "Loaded N profiles."
+    ProfileManager manager(path, 0);
+    std::cout.clear();
+    keystrokeUs = slowestKeystroke(manager, count);
+    return manager.getProfileNames().size();
+}
+
+// Map the binary store and look up a spread of names
+std::size_t loadBinary(const std::string& path, int count, double& keystrokeUs) {
+    ProfileStoreConfig config;
+    config.path = path;
+    config.format = ProfileFormat::BINARY;
+    config.compactEvery = 0;
+    
+    std::cout.setstate(std::ios::failbit);
+    ProfileManager manager(config);
+    std::cout.clear();
+    
+    char name[32];
+    for (int i = 0; i < 1000; i++) {
+        std::snprintf(name, sizeof(name), "player%08d", static_cast<int>((i * 7919LL) % count));
+        if (!manager.getProfile(name)) {
+            return 0;
+        }
+    }
+    keystrokeUs = slowestKeystroke(manager, count);
+    return manager.getProfileCount();
+}
+
+// Run one load in a child process and print its line of the table
+void measure(const std::string& path, int count, const char* mode) {
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        double baseline = peakRssMb();
+        auto start = std::chrono::steady_clock::now();
+        std::string loader = mode;
+        double keystrokeUs = 0;
+        std::size_t loaded = loader == "bin" ? loadBinary(path, count, keystrokeUs)
+                           : loader == "sax" ? loadWithSax(path, count, keystrokeUs) : loadWithDom(path);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        
+        char keystroke[32] = "-";
+        if (loader != "dom") {
+            std::snprintf(keystroke, sizeof(keystroke), "%.1f", keystrokeUs);
+        }
+        std::printf("%10d  %-4s  %10.1f  %12.1f  %14s  %s\n", count, mode, ms, peakRssMb() - baseline, keystroke,
+                    static_cast<int>(loaded) == count && keystrokeUs >= 0 ? "" : "(count mismatch!)");
+        std::fflush(stdout);
+        std::_Exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+void printUsage() {
+    std::cout << "Usage: profile-load-bench [PROFILE_COUNT...]\n"
+              << "  Profile counts must be positive; they default to 10000 100000 1000000\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) {
+        if (std::atoi(argv[i]) > 0) {
+            sizes.push_back(std::atoi(argv[i]));
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (sizes.empty()) {
+        sizes = { 10000, 100000, 1000000 };
+    }
+    
+    std::printf("%10s  %-4s  %10s  %12s  %14s\n", "profiles", "load", "time (ms)", "peak RSS (MB)", "keystroke (us)");
+    for (int count : sizes) {
+        std::string path = scratchPath("pong_profile_bench_" + std::to_string(count) + ".json");
+        if (!writeProfiles(path, count)) {
+            std::cerr << "Could not write " << path << std::endl;
+            return 1;
+        }
+        measure(path, count, "dom");
+        measure(path, count, "sax");
+        std::remove(path.c_str());
+        std::remove((path + ".journal").c_str());
+        
+        std::string binaryPath = scratchPath("pong_profile_bench_" + std::to_string(count) + ".bin");
+        writeBinaryProfiles(binaryPath, count);
+        measure(binaryPath, count, "bin");
+        std::remove(binaryPath.c_str());
+        std::remove((binaryPath + ".journal").c_str());
+    }
+    return 0;
+}
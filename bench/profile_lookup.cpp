@@ -0,0 +1,178 @@
+#include "ProfileIndex.h"
+#include "RankIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Profile lookups: ProfileIndex (open addressing, string_view keys) versus
+// the std::map<std::string, UserProfile> ProfileManager used before.
+// Names to look up arrive as string_views into a shared buffer, as they do
+// from the menu; the map has to build a std::string for each one.
+// Then the leaderboard: one player's score changes and their rank is read,
+// with the RankIndex treap versus re-sorting every player.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double nanosecondsPer(Clock::time_point start, std::size_t operations) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+}
+
+// Leaderboard update cost for count players with random win counts
+void benchLeaderboard(int count) {
+    std::vector<std::string> names(static_cast<std::size_t>(count));
+    std::vector<std::int64_t> scores(names.size());
+    std::vector<RankIndex::Key> keys;
+    std::uint64_t state = 987654321;
+    auto next = [&state]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return state >> 33;
+    };
+    char name[32];
+    for (std::size_t i = 0; i < names.size(); i++) {
+        std::snprintf(name, sizeof(name), "arcade_player_%08d", static_cast<int>(i));
+        names[i] = name;
+        scores[i] = static_cast<std::int64_t>(next() % 1000);
+        keys.push_back({ scores[i], names[i] });
+    }
+    
+    auto start = Clock::now();
+    RankIndex board;
+    board.build(keys);
+    double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    
+    // One more win for a random player, then look up their rank
+    const std::size_t updates = 200000;
+    std::size_t rankSum = 0;
+    start = Clock::now();
+    for (std::size_t i = 0; i < updates; i++) {
+        std::size_t player = next() % names.size();
+        board.erase({ scores[player], names[player] });
+        scores[player]++;
+        board.insert({ scores[player], names[player] });
+        rankSum += board.rankOf({ scores[player], names[player] });
+    }
+    double treeNs = nanosecondsPer(start, updates);
+    
+    // The same with a full re-sort per update
+    const std::size_t resorts = 3;
+    bool same = true;
+    auto before = [](const RankIndex::Key& a, const RankIndex::Key& b) {
+        return a.score != b.score ? a.score > b.score : a.name < b.name;
+    };
+    start = Clock::now();
+    for (std::size_t i = 0; i < resorts; i++) {
+        std::size_t player = next() % names.size();
+        scores[player]++;
+        keys.clear();
+        for (std::size_t j = 0; j < names.size(); j++) {
+            keys.push_back({ scores[j], names[j] });
+        }
+        std::sort(keys.begin(), keys.end(), before);
+        std::size_t rank = static_cast<std::size_t>(
+            std::find_if(keys.begin(), keys.end(), [&](const RankIndex::Key& key) { return key.name == names[player]; }) -
+            keys.begin());
+        
+        board.erase({ scores[player] - 1, names[player] });
+        board.insert({ scores[player], names[player] });
+        same = same && board.rankOf({ scores[player], names[player] }) == rank;
+    }
+    double sortNs = nanosecondsPer(start, resorts);
+    
+    std::printf("%10d  %12.1f  %17.0f  %16.0f%s\n", count, buildMs, treeNs, sortNs,
+                same && rankSum > 0 ? "" : "  (rank mismatch!)");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(std::atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes = { 10000, 100000, 1000000 };
+    }
+    const std::size_t lookups = 2000000;
+    
+    std::printf("%10s  %-5s  %12s  %14s  %14s\n", "profiles", "index", "build (ms)", "lookup (ns)", "in order (ns)");
+    for (int count : sizes) {
+        // Long, similar names (worst case for comparisons), stored back to back
+        std::string buffer;
+        std::vector<std::string_view> names;
+        char name[32];
+        for (int i = 0; i < count; i++) {
+            int length = std::snprintf(name, sizeof(name), "arcade_player_%08d", i);
+            buffer.append(name, static_cast<std::size_t>(length));
+        }
+        for (int i = 0; i < count; i++) {
+            names.emplace_back(buffer.data() + static_cast<std::size_t>(i) * 22, 22);
+        }
+        std::vector<std::uint32_t> order(lookups);
+        std::uint64_t state = 12345;
+        for (std::uint32_t& value : order) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            value = static_cast<std::uint32_t>((state >> 33) % static_cast<std::uint64_t>(count));
+        }
+        
+        // std::map
+        auto start = Clock::now();
+        std::map<std::string, UserProfile> map;
+        for (std::string_view view : names) {
+            std::string key(view);
+            map.emplace(key, UserProfile(key));
+        }
+        double mapBuild = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        
+        long long checksum = 0;
+        start = Clock::now();
+        for (std::uint32_t i : order) {
+            auto it = map.find(std::string(names[i]));
+            checksum += it->second.totalGames + static_cast<long long>(it->second.username.size());
+        }
+        double mapLookup = nanosecondsPer(start, lookups);
+        
+        start = Clock::now();
+        for (const auto& pair : map) {
+            checksum += pair.second.wins;
+        }
+        double mapIterate = nanosecondsPer(start, map.size());
+        
+        // ProfileIndex
+        start = Clock::now();
+        ProfileIndex index;
+        for (std::string_view view : names) {
+            index.insertOrAssign(UserProfile(std::string(view)));
+        }
+        double indexBuild = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        
+        start = Clock::now();
+        for (std::uint32_t i : order) {
+            const UserProfile* profile = index.find(names[i]);
+            checksum -= profile->totalGames + static_cast<long long>(profile->username.size());
+        }
+        double indexLookup = nanosecondsPer(start, lookups);
+        
+        start = Clock::now();
+        for (std::size_t rank = 0; rank < index.size(); rank++) {
+            checksum -= index.byName(rank).wins;
+        }
+        double indexIterate = nanosecondsPer(start, index.size());
+        
+        std::printf("%10d  %-5s  %12.1f  %14.1f  %14.1f\n", count, "map", mapBuild, mapLookup, mapIterate);
+        std::printf("%10d  %-5s  %12.1f  %14.1f  %14.1f%s\n", count, "hash", indexBuild, indexLookup, indexIterate,
+                    checksum == 0 ? "" : "  (checksum mismatch!)");
+    }
+    
+    std::printf("\n%10s  %12s  %17s  %16s\n", "players", "build (ms)", "treap update (ns)", "re-sort (ns)");
+    for (int count : sizes) {
+        benchLeaderboard(count);
+    }
+    return 0;
+}
@@ -48,7 +48,18 @@ if ($missingFiles.Count -gt 0) {
 Write-Host "Building Pong Clone..." -ForegroundColor Cyan
 Write-Host ""
 
-$buildCommand = "g++ src/*.cpp -Iinclude -I`"$SFMLPath/include`" -L`"$SFMLPath/lib`" -lsfml-graphics -lsfml-window -lsfml-system -lsfml-audio -std=c++17 -o pong.exe"
+# Tool and server sources stay out of the game, as in the Makefile
+# (TOOL_SOURCES and SERVER_ONLY_SOURCES)
+$excludedSources = @(
+    "BatchSimulator.cpp",
+    "BallBatch.cpp",
+    "GameServer.cpp",
+    "TimerWheel.cpp"
+)
+$sources = (Get-ChildItem "src\*.cpp" | Where-Object { $excludedSources -notcontains $_.Name } |
+    ForEach-Object { "src/$($_.Name)" }) -join " "
+
+$buildCommand = "g++ $sources -Iinclude -I`"$SFMLPath/include`" -L`"$SFMLPath/lib`" -lsfml-graphics -lsfml-window -lsfml-network -lsfml-system -lsfml-audio -std=c++17 -O2 -pthread -ffp-contract=off -o pong.exe"
 
 Write-Host "Executing: $buildCommand" -ForegroundColor Gray
 Write-Host ""
@@ -72,6 +83,7 @@ if ($LASTEXITCODE -eq 0) {
         $dlls = @(
             "sfml-graphics-2.dll",
             "sfml-window-2.dll", 
+            "sfml-network-2.dll",
             "sfml-system-2.dll",
             "sfml-audio-2.dll"
         )
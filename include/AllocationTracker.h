@@ -0,0 +1,53 @@
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Global heap allocation counters. The operator new/delete hooks are only
+// compiled in with -DPONG_TRACK_ALLOCATIONS (make FEATURE_FLAGS=...);
+// otherwise every counter stays at zero and isTracking() returns false.
+namespace alloc {
+
+    // True when the hooks are compiled in
+    bool isTracking();
+
+    // Totals since program start
+    std::uint64_t allocationCount();
+    std::uint64_t deallocationCount();
+    std::uint64_t bytesAllocated();
+
+} // namespace alloc
+
+// Allocations per frame, grouped into caller-defined buckets (one per GameState)
+class FrameAllocationStats {
+private:
+    struct Bucket {
+        std::uint64_t frames = 0;
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t maxPerFrame = 0;
+        std::uint64_t framesWithAllocations = 0;
+    };
+
+    std::vector<Bucket> buckets;
+    std::uint64_t frameStartCount;
+    std::uint64_t frameStartBytes;
+
+public:
+    // Constructor
+    explicit FrameAllocationStats(std::size_t bucketCount);
+
+    // Mark the start of a frame
+    void beginFrame();
+
+    // Close the frame and charge it to a bucket; returns its allocation count
+    std::uint64_t endFrame(std::size_t bucket);
+
+    // Print one line per bucket that saw at least one frame
+    void print(std::ostream& out, const char* const* bucketNames) const;
+};
+
+#endif // ALLOCATIONTRACKER_H
@@ -1,19 +1,16 @@
 #ifndef BALL_H
 #define BALL_H
 
-#include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
-#include "Paddle.h"
+#include <SFML/System.hpp>
+#include <string>
+#include "Simulation.h"
 
+// The ball as the game sees it: a mirror of the Simulation's state plus
+// the hit sound. Physics live in Simulation, drawing in PlayfieldRenderer.
 class Ball {
 private:
-    sf::CircleShape shape;
-    sf::Vector2f velocity;
-    float radius;
-    float baseSpeed;
-    float currentSpeed;
-    float windowWidth;
-    float windowHeight;
+    BallState state;
     
     // Sound effects
     sf::SoundBuffer hitBuffer;
@@ -21,26 +18,17 @@ private:
 
 public:
     // Constructor
-    Ball(float startX, float startY, float rad, float speed, float winWidth, float winHeight);
-
-    // Update and physics
-    void update(float deltaTime);
-    bool checkPaddleCollision(const Paddle& paddle);
-    bool checkWallCollision();
-    
-    // Check if ball went out of bounds (scoring)
-    int checkScore(); // Returns 1 if player 1 scores, 2 if player 2 scores, 0 otherwise
-
-    // Reset ball to center
-    void reset();
-
-    // Rendering
-    void render(sf::RenderWindow& window);
+    Ball(float startX, float startY, float rad, float speed);
 
     // Load sounds
     bool loadSounds(const std::string& hitSoundPath);
+    void playHitSound();
+
+    // Mirror state owned by a Simulation
+    void setState(const BallState& newState);
 
     // Getters
+    const BallState& getState() const { return state; }
     sf::Vector2f getPosition() const;
     float getRadius() const;
 };
@@ -0,0 +1,80 @@
+#ifndef BALLBATCH_H
+#define BALLBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Simulation.h"
+
+// Per-lane event flags written by the batch step
+enum BatchEvent : std::uint8_t {
+    BATCH_WALL_HIT = 1,
+    BATCH_PADDLE_HIT = 2,
+    BATCH_SCORE_P1 = 4,
+    BATCH_SCORE_P2 = 8
+};
+
+// Values shared by every lane of a batch
+struct BallBatchParams {
+    float fieldWidth;
+    float fieldHeight;
+    float radius;
+    float baseSpeed;
+    float speedUpFactor;
+    float maxSpeedFactor;
+    float paddle1X;
+    float paddle2X;
+    float paddleWidth;
+    float paddleHeight;
+    float paddleSpeed;
+    bool continuous;    // SimulationConfig::continuousCollision
+
+    static BallBatchParams fromConfig(const SimulationConfig& config);
+};
+
+// Structure-of-arrays ball and paddle state for many concurrent matches.
+// Lane i of every array belongs to the same match.
+struct BallBatch {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> speed;
+    std::vector<float> paddle1Y;
+    std::vector<float> paddle2Y;
+    std::vector<float> paddle1Target;   // Where follow() steers each paddle's center (PaddleAI's target)
+    std::vector<float> paddle2Target;
+    std::vector<float> dt;              // 0 freezes a lane's ball (countdown, idle)
+    std::vector<std::uint8_t> events;   // BatchEvent flags from the last step
+
+    void resize(std::size_t lanes);
+    std::size_t size() const { return x.size(); }
+
+    // Convert one lane to/from the scalar structs
+    BallState getBall(std::size_t lane, const BallBatchParams& params) const;
+    void setBall(std::size_t lane, const BallState& ball);
+    PaddleState getPaddle(std::size_t lane, int player, const BallBatchParams& params) const;
+};
+
+namespace batch {
+
+    // Reference path: runs physics:: on each lane, exactly like Simulation::step
+    // (swept or overlap collision, as params.continuous says)
+    void stepScalar(BallBatch& balls, const BallBatchParams& params);
+
+    // Vectorized path (AVX2 8 lanes, SSE2 4 lanes, scalar elsewhere).
+    // Produces bit-identical results to stepScalar.
+    void stepSimd(BallBatch& balls, const BallBatchParams& params);
+
+    // Steer one side's paddles (player 1 or 2) toward their targets for a
+    // tick, as PaddleAI::follow and physics::updatePaddle would: the
+    // reference path, and the vectorized one, bit-identical to it
+    void followScalar(BallBatch& balls, const BallBatchParams& params, int player, float deadZone, float deltaTime);
+    void followSimd(BallBatch& balls, const BallBatchParams& params, int player, float deadZone, float deltaTime);
+
+    // Name of the instruction set stepSimd was compiled for
+    const char* simdName();
+
+} // namespace batch
+
+#endif // BALLBATCH_H
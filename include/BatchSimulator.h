@@ -0,0 +1,83 @@
+#ifndef BATCHSIMULATOR_H
+#define BATCHSIMULATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+#include "PaddleAI.h"
+
+// What to run
+struct BatchConfig {
+    SimulationConfig simulation;
+    PaddleAIConfig ai;
+    ControllerType player1 = ControllerType::AI;
+    ControllerType player2 = ControllerType::AI;
+
+    int matches = 1000;
+    int threads = 0;                       // 0 = one per hardware thread
+    std::uint64_t seed = 1;                // Match i is seeded from (seed, i)
+    std::uint64_t maxTicksPerMatch = 120 * 60 * 30; // Give up on endless rallies
+
+    // Structure-of-arrays mode: each worker steps many matches at once
+    bool useSoa = false;
+    bool useSimd = true;       // SoA only: vector kernel instead of the scalar reference
+    int lanesPerWorker = 64;
+};
+
+// Aggregated results of a batch
+struct BatchReport {
+    int matchesPlayed = 0;
+    int unfinishedMatches = 0;
+    int threadsUsed = 0;
+    double elapsedSeconds = 0.0;
+
+    std::uint64_t totalTicks = 0;
+    std::uint64_t totalPoints = 0;
+    std::uint64_t totalPaddleHits = 0;
+    std::uint64_t longestRally = 0;
+
+    // Final score counts, indexed [score1 * (maxScore + 1) + score2]
+    int maxScore = 0;
+    std::vector<std::uint64_t> scoreCounts;
+
+    double matchesPerSecond() const;
+    double meanRallyLength() const; // Paddle hits per point
+
+    // Fold another worker's results into this one
+    void merge(const BatchReport& other);
+};
+
+// Plays many independent matches across worker threads.
+// Each worker owns its simulations and report; nothing mutable is shared.
+class BatchSimulator {
+private:
+    BatchConfig config;
+
+    void playMatch(int matchIndex, BatchReport& report) const;
+    void playMatchesSoa(std::atomic<int>& nextMatch, BatchReport& report) const;
+    static bool verifySimdMode(const SimulationConfig& config, int lanes, int steps, std::uint64_t seed,
+                               std::ostream& out);
+
+public:
+    // Constructor
+    BatchSimulator(const BatchConfig& cfg);
+
+    // Run the whole batch and block until done
+    BatchReport run() const;
+
+    // Play batch match number matchIndex alone and save it as a replay
+    bool recordMatch(int matchIndex, const std::string& path) const;
+
+    // Check the vector kernels (paddle steering, and overlap and swept
+    // collision) against the scalar reference on random states. Returns
+    // true when every lane matches bit for bit.
+    static bool verifySimd(const SimulationConfig& config, int lanes, int steps, std::uint64_t seed, std::ostream& out);
+
+    // Human-readable summary
+    static void printReport(const BatchReport& report, const BatchConfig& config, std::ostream& out);
+};
+
+#endif // BATCHSIMULATOR_H
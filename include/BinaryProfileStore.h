@@ -0,0 +1,72 @@
+#ifndef BINARYPROFILESTORE_H
+#define BINARYPROFILESTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "UserProfile.h"
+
+// On-disk format of the profile snapshot
+enum class ProfileFormat {
+    JSON,     // profiles.json: readable, used for interchange
+    BINARY    // profiles.bin: BinaryProfileStore, opened without parsing
+};
+
+// Read-only view of a binary profile snapshot.
+// Layout (little-endian): 72-byte header ("PONGPRF" magic, version,
+// byte-order mark, record size, count, generation, last journal sequence,
+// section offsets), then fixed-size records sorted by name (stats and, from
+// version 2, the rating), then a string
+// table holding the names. The file is memory-mapped, so opening it costs
+// the same for ten profiles or a million and only touched pages are read.
+// On Windows the file is read into a buffer instead.
+class BinaryProfileStore {
+private:
+    const unsigned char* data;
+    std::size_t dataSize;
+    void* mapping;
+    std::vector<unsigned char> buffer;
+
+    std::uint32_t version;
+    std::size_t count;
+    std::uint64_t generation;
+    std::uint64_t lastSequence;
+    const unsigned char* records;
+    const char* strings;
+    std::uint64_t stringsSize;
+
+    bool validate();
+
+public:
+    // Constructor and destructor
+    BinaryProfileStore();
+    ~BinaryProfileStore();
+
+    BinaryProfileStore(const BinaryProfileStore&) = delete;
+    BinaryProfileStore& operator=(const BinaryProfileStore&) = delete;
+
+    // Map a file; false if it is missing or not a valid profile store
+    bool open(const std::string& path);
+    void close();
+
+    // Records, in name order
+    std::size_t size() const { return count; }
+    std::string_view nameAt(std::size_t index) const;
+    UserProfile profileAt(std::size_t index) const;
+
+    // Binary search by name
+    bool find(std::string_view name, std::size_t& index) const;
+    std::size_t lowerBound(std::string_view name) const;
+
+    // Getters
+    bool isOpen() const { return data != nullptr; }
+    std::uint64_t getGeneration() const { return generation; }
+    std::uint64_t getLastSequence() const { return lastSequence; }
+
+    // Build a file image from a snapshot (profiles must be sorted by name)
+    static std::string encode(const ProfileSnapshot& snapshot);
+};
+
+#endif // BINARYPROFILESTORE_H
@@ -0,0 +1,43 @@
+#ifndef CACHEDTEXT_H
+#define CACHEDTEXT_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+
+// sf::Text that remembers what it last displayed. Setting the same string,
+// number or color again is just a comparison: glyph geometry is only
+// rebuilt (and memory only allocated) when the value actually changes.
+class CachedText : public sf::Drawable {
+private:
+    sf::Text text;
+    std::string value;
+    long number;
+    bool showingNumber;
+    sf::Color color;
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+public:
+    // Constructor
+    CachedText();
+
+    // Font, size and color; call once when the text is created
+    void setStyle(const sf::Font& font, unsigned size, const sf::Color& fillColor);
+
+    // Returns true when the text changed and was laid out again
+    bool setString(const std::string& newValue);
+    bool setNumber(long newNumber);
+
+    // Load the glyphs and vertex storage for these characters up front,
+    // so later changes within them never allocate
+    void preloadGlyphs(const std::string& characters);
+
+    void setFillColor(const sf::Color& fillColor);
+    void setPosition(float x, float y);
+
+    // Getters
+    const std::string& getString() const { return value; }
+    sf::FloatRect getGlobalBounds() const { return text.getGlobalBounds(); }
+};
+
+#endif // CACHEDTEXT_H
@@ -0,0 +1,94 @@
+#ifndef CLIENTPREDICTION_H
+#define CLIENTPREDICTION_H
+
+#include <cstdint>
+#include <vector>
+#include "Simulation.h"
+
+// Prediction tunables
+struct PredictionConfig {
+    int rollbackWindow = 32;     // Most ticks one correction may re-simulate (~270 ms at 120 Hz)
+    int inputMargin = 2;         // Ticks early we want our input to reach the server
+    int marginSlack = 4;         // Margin above inputMargin that is still left alone
+};
+
+// Running totals for one predicted match
+struct PredictionStats {
+    std::uint64_t ticksPredicted = 0;
+    std::uint64_t snapshotsChecked = 0;
+    std::uint64_t mispredictions = 0;      // Snapshot disagreed with our state or our guess of the opponent
+    std::uint64_t fullReplays = 0;         // Snapshot older than the window: re-simulated without saved inputs
+    std::uint64_t ticksResimulated = 0;
+    int deepestRollback = 0;
+    std::uint64_t resyncs = 0;             // Snapshot ahead of us: jumped to it
+    std::uint64_t ticksAdded = 0;          // Clock sped up: our input was reaching the server late
+    std::uint64_t ticksDropped = 0;        // Clock slowed down: our input was arriving needlessly early
+    std::uint64_t localCorrections = 0;    // Rollbacks that moved our own paddle (its input arrived late)
+    float largestBallCorrection = 0.0f;    // Pixels the ball jumped in one correction
+};
+
+// Client-side prediction for a networked match. The local paddle and the
+// ball run ahead of the server on our own Simulation, using our input as
+// soon as it is read and guessing that the opponent keeps pressing what
+// the last snapshot said. Each tick's starting state is kept (a plain
+// SimulationState copy), so when an authoritative snapshot disagrees with
+// what we predicted for its tick we restore it and re-simulate up to the
+// present with the inputs we recorded - at most rollbackWindow ticks. A
+// snapshot older than that (the round trip outgrew the window) is replayed
+// in full, with our latest input standing in for the ones no longer kept.
+//
+// The prediction runs far enough ahead that our input reaches the server
+// before its tick: snapshots report the newest tick the server has had
+// input from us for, and the tick count is nudged to keep that margin
+// over the snapshot's tick within [inputMargin, inputMargin + marginSlack].
+class ClientPrediction {
+private:
+    struct Frame {
+        std::uint64_t tick = ~0ULL;   // Which tick this slot holds; ~0 when empty
+        SimulationState state;        // State at the start of the tick
+        PaddleInput local;
+        PaddleInput remote;           // Our guess when it was stepped
+    };
+
+    PredictionConfig config;
+    Simulation simulation;
+    int localPlayer;
+    std::vector<Frame> frames;        // rollbackWindow + 1 slots, by tick
+    PaddleInput remoteInput;          // Opponent's last known input
+    PaddleInput latestLocal;          // Our input for the newest predicted tick
+    bool started;
+    std::uint64_t syncTick;           // Tick of the last clock adjustment; ~0 for none
+    int pendingAdjustment;            // > 0 run extra ticks, < 0 skip ticks
+    PredictionStats stats;
+
+    Frame& frameFor(std::uint64_t tick) { return frames[tick % frames.size()]; }
+    void restart(const SimulationState& authoritative);
+    void replay(const SimulationState& authoritative, std::uint64_t current);
+    void checkInputMargin(std::uint64_t serverTick, std::uint32_t inputTick);
+
+public:
+    // Constructor (localPlayer: 1 = left paddle, 2 = right paddle)
+    ClientPrediction(const SimulationConfig& simulationConfig, int localPlayer,
+                     const PredictionConfig& predictionConfig = PredictionConfig());
+
+    // Apply an authoritative snapshot: the state at its tick, the inputs the
+    // server stepped into it and the newest tick it had our input for
+    // (net::NO_TICK for none). The first one starts the prediction.
+    void reconcile(const SimulationState& authoritative, const SimulationInput& stepInputs, std::uint32_t inputTick);
+
+    // Ticks to run for this frame: the fixed timestep's count with any
+    // pending clock adjustment applied
+    int adjustSteps(int steps);
+
+    // Predict one tick with our input; returns what happened in it
+    StepResult advance(const PaddleInput& local);
+
+    // Getters
+    bool hasStarted() const { return started; }
+    std::uint64_t getTick() const { return simulation.getState().tick; }   // The tick advance() predicts next
+    const SimulationState& getState() const { return simulation.getState(); }
+    const SimulationConfig& getConfig() const { return simulation.getConfig(); }
+    const PredictionStats& getStats() const { return stats; }
+};
+
+#endif // CLIENTPREDICTION_H
@@ -0,0 +1,67 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Per-phase frame timing. The game thread brackets each frame with
+// beginFrame()/endFrame() and calls endPhase() as each phase finishes;
+// finished frames go into a fixed ring of the last CAPACITY frames.
+// There is one writer and no lock: a reader (the F3 overlay, or any other
+// thread) copies the ring and then drops whatever the writer may have
+// overwritten meanwhile. Nothing here allocates.
+class FrameProfiler {
+public:
+    enum Phase {
+        EVENTS,     // pollEvents
+        UPDATE,     // update
+        RENDER,     // render (building draw calls)
+        DISPLAY,    // window.display: buffer swap, vsync and framerate-limit wait
+        PHASE_COUNT
+    };
+    static const std::size_t CAPACITY = 256;
+
+    struct Frame {
+        float phaseMs[PHASE_COUNT];
+        float totalMs;
+    };
+
+    // Percentiles over the frames in the ring
+    struct Stats {
+        float p50 = 0.0f;
+        float p99 = 0.0f;
+        float max = 0.0f;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::array<Frame, CAPACITY> frames;
+    std::atomic<std::uint64_t> published;   // Frames written so far
+    Frame current;
+    Clock::time_point frameStart;
+    Clock::time_point phaseStart;
+
+public:
+    // Constructor
+    FrameProfiler();
+
+    // Frame and phase boundaries (game thread only)
+    void beginFrame();
+    void endPhase(Phase phase);
+    void endFrame();
+
+    // Copy up to maxFrames of the most recent frames, oldest first
+    std::size_t copyRecent(Frame* out, std::size_t maxFrames) const;
+
+    // Frame-time and per-phase percentiles over the ring
+    std::size_t summarize(Stats& total, Stats (&phases)[PHASE_COUNT]) const;
+
+    // Name of a phase for display
+    static const char* phaseName(Phase phase);
+};
+
+#endif // FRAMEPROFILER_H
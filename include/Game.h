@@ -3,9 +3,23 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include "Paddle.h"
 #include "Ball.h"
+#include "PlayfieldRenderer.h"
+#include "CachedText.h"
+#include "AllocationTracker.h"
+#include "FrameProfiler.h"
+#include "InputSampler.h"
+#include "LatencyHistogram.h"
+#include "ProfilerOverlay.h"
+#include "Simulation.h"
+#include "SimulationThread.h"
+#include "NetClient.h"
+#include "ClientPrediction.h"
+#include "Replay.h"
 #include "ProfileManager.h"
 #include "Menu.h"
 
@@ -16,8 +30,26 @@ enum class GameState {
     EXIT
 };
 
+// Command line options
+struct GameOptions {
+    bool fixedSeed = false;   // --seed given: match k is seeded with seed + k
+    std::uint64_t seed = 0;
+    std::string recordPath;   // --record: save each match's inputs here
+    std::string replayPath;   // --replay: play this recording instead of the keyboard
+    bool assertZeroAlloc = false; // --assert-zero-alloc: fail if steady-state PLAYING frames allocate
+    ProfileStoreConfig profileStore; // --profile-format: JSON or memory-mapped binary profiles
+    std::string connectHost;  // --connect: play against whoever pong-server pairs us with
+    unsigned short connectPort = net::DEFAULT_PORT;
+    LinkConditions link;      // --latency/--jitter/--loss: simulate a worse network when connected
+    PredictionConfig prediction; // --rollback: how far back a correction may re-simulate
+};
+
 class Game {
 private:
+    // Options
+    GameOptions options;
+    std::uint64_t matchesStarted;
+    
     // Window
     sf::RenderWindow window;
     sf::VideoMode videoMode;
@@ -26,27 +58,51 @@ private:
     // Game state
     GameState currentState;
     
-    // Game objects
+    // Game objects (rendering and sound; physics lives in simulation)
     std::unique_ptr<Paddle> paddle1;
     std::unique_ptr<Paddle> paddle2;
     std::unique_ptr<Ball> ball;
+    std::unique_ptr<PlayfieldRenderer> playfield;
+    
+    // Paddle keys, sampled on their own thread and taken per tick
+    std::unique_ptr<InputSampler> inputSampler;
+    
+    // Headless match engine, stepped at a fixed tick. Local matches and
+    // replays tick on simulationThread; simulation then holds the newest
+    // published state for the HUD, and the thread's counts of hits and
+    // points already played as sounds are kept here
+    Simulation simulation;
+    FixedTimestep timestep;
+    std::unique_ptr<SimulationThread> simulationThread;
+    std::uint32_t hitsHeard;
+    std::uint32_t pointsHeard;
+    
+    // Input recording and playback
+    ReplayRecorder recorder;
+    ReplayPlayer replayPlayer;
+    bool isReplaying;
+    
+    // Networked match (--connect): our paddle and the ball are predicted
+    // ahead of the server; simulation holds a copy of the prediction for drawing
+    std::unique_ptr<NetClient> netClient;
+    std::unique_ptr<ClientPrediction> prediction;
+    bool isOnline;
     
     // Managers
     ProfileManager profileManager;
     std::unique_ptr<Menu> menu;
     
-    // Scores
-    int score1;
-    int score2;
-    int maxScore;
-    
-    // UI elements
+    // UI elements (retained; glyphs are only laid out when a value changes)
     sf::Font font;
-    sf::Text scoreText1;
-    sf::Text scoreText2;
-    sf::Text gameOverText;
-    sf::Text instructionText;
-    sf::Text countdownText;
+    CachedText scoreText1;
+    CachedText scoreText2;
+    CachedText player1NameText;
+    CachedText player2NameText;
+    CachedText gameOverText;
+    CachedText instructionText;
+    CachedText restartText;
+    CachedText countdownText;
+    CachedText networkText;
     
     // Sound
     sf::SoundBuffer scoreBuffer;
@@ -59,23 +115,45 @@ private:
     // Delta time
     sf::Clock deltaClock;
     
-    // Countdown
-    bool isCountingDown;
-    float countdownTimer;
-    int countdownNumber;
+    // Heap allocation accounting (needs PONG_TRACK_ALLOCATIONS)
+    FrameAllocationStats allocationStats;
+    float playingTime;
+    std::uint64_t allocationFailures;
+    
+    // Per-phase frame timing, always on; F3 shows the overlay
+    FrameProfiler frameProfiler;
+    std::unique_ptr<ProfilerOverlay> profilerOverlay;
+    bool showProfiler;
+    
+    // Key change to the end of display() of the first frame showing it
+    LatencyHistogram inputLatency;
+    std::uint64_t frameKeyChange;
     
     // Private methods
     void initWindow();
     void initGame();
     void initUI();
     bool loadResources();
-    void resetRound();
+    void startMatch();
+    void startReplay();
+    void saveRecording();
+    void startOnline();
+    void updateOnline(float deltaTime);
+    void endOnline(const std::string& message);
+    void leaveOnline();
+    void startSimulationThread();
+    void updateFromSimulationThread();
+    void stopSimulationThread();
+    void recordInputLatency(GameState frameState);
+    void syncFromSimulation();
     void checkGameOver();
     void handleGameOver();
+    void checkFrameAllocations(GameState frameState, std::uint64_t allocations);
+    void printFrameTimes() const;
 
 public:
     // Constructor and destructor
-    Game();
+    Game(const GameOptions& gameOptions = GameOptions());
     virtual ~Game();
 
     // Main game loop methods
@@ -89,6 +167,9 @@ public:
     
     // Check if game is running
     bool isRunning() const;
+    
+    // False if --assert-zero-alloc caught an allocating frame
+    bool passedAllocationCheck() const { return allocationFailures == 0; }
 };
 
 #endif // GAME_H
@@ -0,0 +1,237 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include <SFML/Network.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "LatencyHistogram.h"
+#include "NetProtocol.h"
+#include "Simulation.h"
+#include "TimerWheel.h"
+
+// Server tunables
+struct ServerConfig {
+    unsigned short port = net::DEFAULT_PORT;
+    int maxMatches = 512;
+    int workers = 2;                // Threads stepping matches; each owns every workers-th slot
+    int snapshotInterval = 2;       // Ticks between snapshots (2 = 60 per second at 120 Hz)
+    float clientTimeout = 5.0f;     // Seconds of silence before a player is dropped
+    float finishedLinger = 1.0f;    // Seconds the final score is resent before BYE
+    float reportInterval = 5.0f;    // Seconds between status lines (0 = quiet)
+    std::uint64_t seed = 1;         // Each match is seeded from (seed, match id)
+    SimulationConfig simulation;
+};
+
+// Running totals since start()
+struct ServerStats {
+    std::uint64_t packetsIn = 0;
+    std::uint64_t bytesIn = 0;
+    std::uint64_t packetsOut = 0;
+    std::uint64_t bytesOut = 0;
+    std::uint64_t sendFailures = 0;
+    std::uint64_t badPackets = 0;       // Malformed, or from an unknown player
+    std::uint64_t snapshotsSent = 0;
+    std::uint64_t fullSnapshots = 0;    // Sent without a baseline
+    std::uint64_t snapshotBytes = 0;
+    std::uint64_t lateInputs = 0;       // Arrived after their tick had run; used from the next tick
+    std::uint64_t matchesStarted = 0;
+    std::uint64_t matchesFinished = 0;
+    std::uint64_t matchesAbandoned = 0;
+    std::uint64_t rejectedJoins = 0;    // Every match slot was taken
+    std::uint64_t ticks = 0;            // Match ticks run, across all matches
+    std::uint64_t ticksSkipped = 0;     // Dropped by a worker too far behind to catch up
+    LatencyHistogram tickLateness;      // How long after its deadline each match tick ran
+    int activeMatches = 0;
+};
+
+// Authoritative headless host for many concurrent matches on one UDP
+// port. Players are paired in arrival order; each pair gets a Simulation
+// stepped at the fixed tick rate with the inputs the clients sent for
+// each tick (or their latest, if a tick's input is late or lost), and
+// both receive delta-compressed snapshots against the newest state they
+// have acknowledged.
+//
+// The thread in run() owns the socket's receiving side, the endpoint map
+// and seating. Matches are stepped by a small pool of workers, each owning
+// every workers-th slot: it gets seated pairs and parsed inputs through a
+// locked inbox it drains when it wakes, so match state is only ever
+// touched by one thread. Every match has its own tick deadline (they are
+// staggered by when each started, not run in lockstep) kept in the
+// worker's timer wheel along with the match's other countdowns - the
+// finished-match linger and the player silence timeout - so a worker
+// sleeps until exactly the next thing it has to do, however many matches
+// it holds. Workers send their snapshots straight from the shared socket.
+class GameServer {
+private:
+    static const int SNAPSHOT_HISTORY = 64;   // Baselines kept per match
+    static const int INPUT_BUFFER = 64;       // Ticks of future input buffered per player
+    static const int MAX_CATCH_UP = 8;        // Ticks a late match may run back to back
+
+    enum class MatchPhase {
+        FREE,
+        PLAYING,
+        FINISHED    // Final snapshots until finishedLinger runs out
+    };
+
+    // Timers per match in its worker's wheel
+    enum TimerKind {
+        TICK_TIMER,
+        LINGER_TIMER,
+        TIMEOUT_TIMER,
+        TIMER_KINDS
+    };
+
+    // A player as the match's worker sees them
+    struct RemotePlayer {
+        bool connected = false;
+        sf::IpAddress address;
+        unsigned short port = 0;
+        std::uint64_t lastHeard = 0;        // Server nanoseconds
+        std::uint32_t ackTick = net::NO_TICK;
+        PaddleInput held;                   // Used when a tick has no input of its own
+        std::uint32_t heldTick = net::NO_TICK;
+        std::uint32_t inputTick = net::NO_TICK;    // Newest tick any INPUT carried; tells the client its margin
+        std::uint32_t bufferedTicks[INPUT_BUFFER];
+        std::uint8_t bufferedCodes[INPUT_BUFFER];
+    };
+
+    struct Snapshot {
+        std::uint32_t tick = net::NO_TICK;
+        std::uint32_t words[net::STATE_WORDS];
+    };
+
+    // Owned by the worker for slot % workers once it has been started
+    struct Match {
+        MatchPhase phase = MatchPhase::FREE;
+        std::uint32_t id = 0;
+        Simulation simulation;
+        RemotePlayer players[2];
+        Snapshot history[SNAPSHOT_HISTORY];
+        std::uint8_t stepInputs = 0;   // Both players' codes for the last step, as SnapshotHeader::inputs
+        std::uint64_t ticksRun = 0;    // Including the linger, for the snapshot cadence
+    };
+
+    // Seating, owned by the run() thread
+    struct Seat {
+        sf::IpAddress address;
+        unsigned short port = 0;
+        std::uint32_t nonce = 0;
+        std::uint64_t lastHeard = 0;
+    };
+
+    enum class SlotState {
+        FREE,
+        WAITING,    // One player, waiting for an opponent
+        STARTED     // Handed to its worker until the worker frees it
+    };
+
+    struct Slot {
+        SlotState state = SlotState::FREE;
+        std::uint32_t matchId = 0;
+        Seat seats[2];
+    };
+
+    // run() thread -> worker
+    struct Command {
+        enum class Type { START, INPUT, BYE } type = Type::INPUT;
+        int slot = 0;
+        int player = 0;                // 0 or 1
+        std::uint64_t receivedAt = 0;
+        std::uint32_t matchId = 0;     // START and BYE
+        Seat seats[2];                 // START
+        net::InputPacket input;        // INPUT
+    };
+
+    struct Worker {
+        int index = 0;
+        std::thread thread;
+
+        // Shared with the run() thread
+        std::mutex mutex;
+        std::condition_variable wake;    // Stopping, or a match to start
+        std::vector<Command> inbox;
+        std::vector<int> freedSlots;
+        ServerStats published;           // Copy of stats, refreshed while running
+
+        // The worker's own
+        std::vector<Command> commands;   // Swapped with inbox
+        std::unique_ptr<TimerWheel> wheel;
+        std::vector<std::uint32_t> expired;
+        ServerStats stats;
+        std::uint64_t lastPublished = 0;
+        std::uint8_t packet[net::MAX_PACKET_SIZE];
+    };
+
+    ServerConfig config;
+    sf::UdpSocket socket;
+    sf::SocketSelector selector;
+    std::vector<Match> matches;                        // Fixed slots, reused
+    std::vector<Slot> slots;
+    std::vector<int> freeSlots;
+    int waitingSlot;                                   // -1 when nobody is waiting
+    std::unordered_map<std::uint64_t, int> endpoints;  // address:port -> slot * 2 + player index
+    std::uint32_t nextMatchId;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::uint64_t tickLength;                          // Nanoseconds
+    std::atomic<bool> stopping;
+    ServerStats stats;                                 // The run() thread's share
+    std::chrono::steady_clock::time_point epoch;
+    std::uint8_t packet[net::MAX_PACKET_SIZE];
+
+    std::uint64_t now() const;
+    static std::uint64_t endpointKey(const sf::IpAddress& address, unsigned short port);
+    static void addStats(ServerStats& total, const ServerStats& part);
+
+    // run() thread
+    void receivePackets(std::uint64_t time);
+    void handleHello(const sf::IpAddress& address, unsigned short port, std::size_t size, std::uint64_t time);
+    void sendWelcome(int slot, int playerIndex);
+    void post(const Command& command);
+    void collectFreedSlots();
+    void freeSlot(int slot);
+    void checkWaitingTimeout(std::uint64_t time);
+    void printReport(const ServerStats& current, const ServerStats& previous, double seconds) const;
+
+    // Workers
+    void runWorker(Worker& worker);
+    void applyCommand(Worker& worker, const Command& command, std::uint64_t time);
+    void startMatch(Worker& worker, const Command& command, std::uint64_t time);
+    void handleInput(Worker& worker, Match& match, int playerIndex, const net::InputPacket& input);
+    void fireTimer(Worker& worker, std::uint32_t timer);
+    void runTicks(Worker& worker, int slot);
+    void tick(Worker& worker, int slot);
+    void sendSnapshots(Worker& worker, Match& match);
+    void endMatch(Worker& worker, int slot);
+    void publishStats(Worker& worker, std::uint64_t time, bool force);
+    std::uint32_t timerFor(int slot, TimerKind kind) const;
+    void send(std::uint8_t* data, std::size_t size, const sf::IpAddress& address, unsigned short port,
+              ServerStats& counters);
+
+public:
+    // Constructor
+    explicit GameServer(const ServerConfig& cfg = ServerConfig());
+
+    // Bind the port; false (with a message) if it can't be
+    bool start();
+
+    // Start the workers and serve until stop() is called, then say BYE to
+    // everyone and join them
+    void run();
+
+    // Ask run() to return; safe from another thread or a signal handler
+    void stop() { stopping.store(true); }
+
+    // Getters
+    unsigned short getPort() const { return socket.getLocalPort(); }
+    int getWorkerCount() const { return static_cast<int>(workers.size()); }
+    ServerStats getStats() const;   // Totals across all threads; call from run()'s thread or after it returns
+};
+
+#endif // GAMESERVER_H
@@ -0,0 +1,86 @@
+#ifndef INPUTSAMPLER_H
+#define INPUTSAMPLER_H
+
+#include <SFML/Window.hpp>
+#include <cstdint>
+#include "Simulation.h"
+#include "SpscRing.h"
+
+// One change of the gameplay keys, stamped when the game thread saw it
+struct InputEvent {
+    std::uint64_t time = 0;   // InputSampler::now()
+    SimulationInput keys;     // Both paddles' keys from then on
+};
+
+// Turns the window's KeyPressed/KeyReleased events for the four paddle
+// keys into timestamped changes, queued in a lock-free ring. The consumer
+// takes the changes as fixed ticks need them, so a tick sees the keys as
+// they were when it ended rather than whenever the frame happened to look
+// at them, and a key tapped and released within one frame still counts.
+//
+// The keys come from the game thread's own events rather than from
+// sf::Keyboard on a thread of its own: that query is not safe next to
+// the window's event processing on X11 (without XInitThreads) or macOS.
+// The price is that a change is stamped when the event is polled, so one
+// made while a frame is stalled in display() counts from the next frame.
+//
+// The ring has a single producer, the game thread, and a single consumer:
+// the methods below that take changes must only be called from one thread
+// at a time. That is the game thread for networked matches and menus, and
+// the SimulationThread while it runs a local match.
+class InputSampler {
+private:
+    static const std::size_t RING_SIZE = 256;
+
+    sf::Keyboard::Key up1;
+    sf::Keyboard::Key down1;
+    sf::Keyboard::Key up2;
+    sf::Keyboard::Key down2;
+    SpscRing<InputEvent, RING_SIZE> ring;
+
+    // Game thread only
+    SimulationInput pressed;          // Keys as the events left them
+    SimulationInput queued;           // Keys as of the last change queued
+
+    // Consumer side only
+    SimulationInput held;             // Keys after the last change taken
+    std::uint64_t firstUnshown;       // Oldest change taken since takeFirstChange(), or 0
+
+public:
+    // Constructor
+    InputSampler(sf::Keyboard::Key player1Up, sf::Keyboard::Key player1Down, sf::Keyboard::Key player2Up,
+                 sf::Keyboard::Key player2Down);
+
+    InputSampler(const InputSampler&) = delete;
+    InputSampler& operator=(const InputSampler&) = delete;
+
+    // Game thread: note a window event, queueing the change if it moves a
+    // paddle key (losing focus releases them all)
+    void handleEvent(const sf::Event& event);
+
+    // Game thread, once per frame: queue the keys again if a change was
+    // refused because the ring was full (nobody draining, e.g. in the menu)
+    void publish();
+
+    // Consumer: the keys as of a time, taking every change stamped at or before it
+    const SimulationInput& keysAt(std::uint64_t time);
+
+    // Consumer: keys for tick number step of steps run together at time
+    // (the ticks covered the time before it). Each gets the keys as of its
+    // own end; the last one gets the newest.
+    const SimulationInput& keysForStep(int step, int steps, std::uint64_t time, const FixedTimestep& timestep);
+
+    // Consumer: take everything queued without counting it as shown
+    // (the keys pressed in a menu are not input to the next match)
+    void discard();
+
+    // Consumer: time of the oldest change taken since the last call, or
+    // 0; once the frame that used it is on screen, now() minus this is the
+    // input-to-display latency
+    std::uint64_t takeFirstChange();
+
+    // Nanoseconds on the steady clock; the time base of InputEvent::time
+    static std::uint64_t now();
+};
+
+#endif // INPUTSAMPLER_H
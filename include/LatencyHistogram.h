@@ -0,0 +1,103 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstdint>
+
+// Log-linear histogram of nanosecond durations: exact below 8 ns, then 8
+// buckets per power of two (each at most 12.5% wide) up to the full
+// 64-bit range. Fixed size and plain data, so recording is an increment,
+// copies are cheap and two can be merged or subtracted for an interval.
+class LatencyHistogram {
+private:
+    static const int SUB_BITS = 3;
+    static const int SUBS = 1 << SUB_BITS;
+    static const int BUCKETS = (64 - SUB_BITS + 1) * SUBS;
+
+    std::uint64_t counts[BUCKETS];
+    std::uint64_t total;
+    std::uint64_t largest;
+
+    static int bucketOf(std::uint64_t value) {
+        if (value < static_cast<std::uint64_t>(SUBS)) {
+            return static_cast<int>(value);
+        }
+        int msb = 63;
+        while (!(value >> msb)) {
+            msb--;
+        }
+        int shift = msb - SUB_BITS;
+        return (shift + 1) * SUBS + static_cast<int>((value >> shift) & (SUBS - 1));
+    }
+
+    // Largest value that lands in a bucket
+    static std::uint64_t bucketTop(int bucket) {
+        if (bucket < SUBS) {
+            return static_cast<std::uint64_t>(bucket);
+        }
+        int shift = bucket / SUBS - 1;
+        std::uint64_t low = static_cast<std::uint64_t>(SUBS + bucket % SUBS) << shift;
+        return low + ((1ULL << shift) - 1);
+    }
+
+public:
+    // Constructor
+    LatencyHistogram() : counts(), total(0), largest(0) {}
+
+    // Count one duration
+    void record(std::uint64_t nanoseconds) {
+        counts[bucketOf(nanoseconds)]++;
+        total++;
+        if (nanoseconds > largest) {
+            largest = nanoseconds;
+        }
+    }
+
+    // Add another histogram's counts to this one
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < BUCKETS; i++) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        if (other.largest > largest) {
+            largest = other.largest;
+        }
+    }
+
+    // Counts recorded since an earlier copy of this histogram (the maximum
+    // is the overall one; it can't be taken apart)
+    LatencyHistogram since(const LatencyHistogram& earlier) const {
+        LatencyHistogram interval = *this;
+        for (int i = 0; i < BUCKETS; i++) {
+            interval.counts[i] -= earlier.counts[i];
+        }
+        interval.total -= earlier.total;
+        return interval;
+    }
+
+    // Value at or below which a fraction of the durations fall (0.99 = p99),
+    // as the top of its bucket; 0 when empty
+    std::uint64_t percentile(double fraction) const {
+        if (total == 0) {
+            return 0;
+        }
+        std::uint64_t rank = static_cast<std::uint64_t>(fraction * static_cast<double>(total));
+        if (rank >= total) {
+            rank = total - 1;
+        }
+        std::uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen > rank) {
+                std::uint64_t top = bucketTop(i);
+                return top < largest ? top : largest;
+            }
+        }
+        return largest;
+    }
+
+    // Getters
+    std::uint64_t count() const { return total; }
+    std::uint64_t max() const { return largest; }
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -5,13 +5,15 @@
 #include <string>
 #include <vector>
 #include "ProfileManager.h"
+#include "CachedText.h"
 
 enum class MenuState {
     MAIN_MENU,
     SELECT_PLAYER1,
     SELECT_PLAYER2,
     CREATE_PROFILE,
-    READY_TO_PLAY
+    READY_TO_PLAY,
+    LEADERBOARD
 };
 
 class Menu {
@@ -28,22 +30,56 @@ private:
     int selectedIndex;
     std::vector<std::string> menuItems;
     
+    // Profile list window: only the visible rows are fetched from the
+    // ProfileManager, so the selection screens cost the same for 10 or 1M profiles
+    static const int VISIBLE_PROFILES = 7;
+    std::vector<UserProfile> profilePage;
+    std::vector<UserProfile> pageScratch;
+    std::string nextProfileName;   // First name below the window ("" at the end)
+    bool moreAbove;
+    std::string searchPrefix;      // Typed filter; only names starting with it are listed
+    
+    // Leaderboard window (reuses profilePage for its rows)
+    LeaderboardKind leaderboardKind;
+    std::size_t leaderboardFirst;  // Rank of the top row
+    std::size_t leaderboardSize;
+    
     // Text input for profile creation
     std::string textInput;
     bool inputActive;
     
-    // UI elements
-    sf::Text titleText;
-    std::vector<sf::Text> menuTexts;
-    sf::Text instructionText;
-    sf::Text inputText;
+    // UI elements, laid out only when the screen's content changes
+    CachedText titleText;
+    std::vector<CachedText> menuTexts;
+    std::vector<bool> menuItemDisabled;
+    CachedText instructionText;
+    CachedText inputText;
+    CachedText player1Text;
+    CachedText player2Text;
+    CachedText moreAboveText;
+    CachedText moreBelowText;
+    CachedText subtitleText;
+    sf::RectangleShape inputBox;
+    MenuState layoutState;
+    bool layoutDirty;
 
     // Helper methods
     void updateMenuItems();
+    void showProfilePage(std::string firstName);
+    bool scrollProfileList(sf::Keyboard::Key key);
+    void editSearch(sf::Uint32 unicode);
+    void showLeaderboard(std::size_t first);
+    bool handleLeaderboardKey(sf::Keyboard::Key key);
+    std::string leaderboardLabel(std::size_t rank, const UserProfile& profile) const;
+    std::string ratingLabel(const std::string& username);
+    void layoutTexts();
+    void layoutMenuItems(unsigned size, float x, float y, float spacing);
+    void updateHighlight();
     void renderMainMenu(sf::RenderWindow& window);
-    void renderProfileSelection(sf::RenderWindow& window, const std::string& playerLabel);
+    void renderProfileSelection(sf::RenderWindow& window);
     void renderCreateProfile(sf::RenderWindow& window);
     void renderReadyScreen(sf::RenderWindow& window);
+    void renderLeaderboard(sf::RenderWindow& window);
 
 public:
     // Constructor
@@ -61,6 +97,7 @@ public:
 
     // Getters
     bool isReadyToPlay() const;
+    bool isAtMainMenu() const { return currentState == MenuState::MAIN_MENU; }
     std::string getPlayer1Name() const { return player1Name; }
     std::string getPlayer2Name() const { return player2Name; }
     
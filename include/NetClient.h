@@ -0,0 +1,138 @@
+#ifndef NETCLIENT_H
+#define NETCLIENT_H
+
+#include <SFML/Network.hpp>
+#include <cstdint>
+#include <vector>
+#include "NetProtocol.h"
+#include "Random.h"
+#include "Simulation.h"
+
+// Simulated network conditions, applied by the client to what it sends and
+// receives, so a loopback run behaves like a real link
+struct LinkConditions {
+    float latency = 0.0f;   // Seconds added to each packet, each way
+    float jitter = 0.0f;    // Up to this many more seconds, at random per packet
+    float loss = 0.0f;      // Chance of dropping each packet, 0..1
+
+    bool isActive() const { return latency > 0.0f || jitter > 0.0f || loss > 0.0f; }
+};
+
+// Running totals for one connection
+struct NetClientStats {
+    std::uint64_t packetsIn = 0;
+    std::uint64_t bytesIn = 0;
+    std::uint64_t packetsOut = 0;
+    std::uint64_t bytesOut = 0;
+    std::uint64_t snapshots = 0;
+    std::uint64_t snapshotBytes = 0;
+    std::uint64_t staleSnapshots = 0;    // Not newer than one already decoded (reordered or repeated)
+    std::uint64_t undecodable = 0;       // Baseline no longer held, or failed its checks
+    std::uint64_t linkDropped = 0;       // Lost on purpose by LinkConditions, either way
+};
+
+// One player's connection to pong-server: joins a match, sends its
+// paddle input tagged by tick (each packet repeats the last few ticks, so
+// a lost one costs nothing), and decodes the server's delta snapshots
+// against the snapshots it has already acknowledged.
+class NetClient {
+public:
+    enum class Status {
+        DISCONNECTED,
+        CONNECTING,     // HELLO sent, no WELCOME yet
+        WAITING,        // Seated, waiting for the first snapshot (HELLO still repeated as a keepalive)
+        PLAYING,
+        CLOSED          // BYE received, or the server went quiet
+    };
+
+private:
+    static const int SNAPSHOT_HISTORY = 64;   // Matches the server's baseline window
+    static const int INPUT_HISTORY = 64;
+    static const int INPUT_REDUNDANCY = 8;    // Ticks of input repeated in each packet
+
+    static const int DELAYED_CAPACITY = 128;  // Packets held back by LinkConditions; more are dropped
+
+    struct Snapshot {
+        std::uint32_t tick = net::NO_TICK;
+        std::uint32_t words[net::STATE_WORDS];
+    };
+
+    struct DelayedPacket {
+        double due;
+        bool outgoing;
+        std::size_t size;
+        std::uint8_t data[net::MAX_PACKET_SIZE];
+    };
+
+    sf::UdpSocket socket;
+    sf::IpAddress serverAddress;
+    unsigned short serverPort;
+    Status status;
+    std::uint32_t nonce;
+    std::uint32_t matchId;
+    int player;
+    SimulationConfig config;
+
+    Snapshot history[SNAPSHOT_HISTORY];   // By tick; only slots that decoded are valid
+    std::uint32_t latestTick;
+    SimulationState latestState;
+    SimulationInput latestInputs;
+    std::uint32_t latestInputTick;
+
+    std::uint8_t inputCodes[INPUT_HISTORY];
+    std::uint32_t firstInputTick;
+    std::uint32_t lastInputTick;
+
+    sf::Clock helloClock;
+    sf::Clock silenceClock;
+    float timeout;
+    NetClientStats stats;
+    std::uint8_t packet[net::MAX_PACKET_SIZE];
+
+    LinkConditions link;
+    std::vector<DelayedPacket> delayed;   // Reserved up front; in flight on the simulated link
+    Random linkRandom;
+    sf::Clock linkClock;
+
+    void sendHello();
+    void send(std::size_t size);
+    void transmit(const std::uint8_t* data, std::size_t size);
+    bool delay(bool outgoing, std::size_t size);
+    bool deliverDelayed();
+    bool handlePacket(std::size_t size);
+    bool handleSnapshot(std::size_t size);
+
+public:
+    // Constructor (timeout: seconds of silence before giving up)
+    explicit NetClient(float timeoutSeconds = 5.0f);
+
+    // Open a local port and ask the server for a seat
+    bool connect(const sf::IpAddress& address, unsigned short port);
+
+    // Receive everything queued, resend HELLO until the match starts and
+    // notice a silent server. Returns true if a newer snapshot arrived.
+    bool update();
+
+    // Our paddle's input for one tick; skipped ticks repeat the previous input
+    void sendInput(std::uint32_t tick, const PaddleInput& input);
+
+    // Tell the server we are leaving
+    void disconnect();
+
+    // Add latency, jitter and loss to this connection (for testing)
+    void setLinkConditions(const LinkConditions& conditions);
+
+    // Getters
+    Status getStatus() const { return status; }
+    int getPlayer() const { return player; }
+    std::uint32_t getMatchId() const { return matchId; }
+    const SimulationConfig& getConfig() const { return config; }
+    bool hasSnapshot() const { return latestTick != net::NO_TICK; }
+    std::uint32_t getLatestTick() const { return latestTick; }
+    const SimulationState& getLatestState() const { return latestState; }
+    const SimulationInput& getLatestInputs() const { return latestInputs; }   // Stepped into the latest tick
+    std::uint32_t getLatestInputTick() const { return latestInputTick; }     // Our input the server had by then
+    const NetClientStats& getStats() const { return stats; }
+};
+
+#endif // NETCLIENT_H
@@ -0,0 +1,110 @@
+#ifndef NETPROTOCOL_H
+#define NETPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Simulation.h"
+
+// UDP wire format shared by pong-server and its clients. No SFML in here,
+// so packets can be built and checked without a socket.
+//
+// Every datagram starts with a 4-byte header: magic "PG", version, type.
+// All integers are little-endian; floats travel as their IEEE bits, so a
+// client's copy of the match state is bit-identical to the server's.
+//
+//   HELLO     client -> server  nonce                        join the next free match (repeated
+//                                                            as a keepalive until it starts)
+//   WELCOME   server -> client  nonce, match, player, config (repeated for duplicate HELLOs)
+//   INPUT     client -> server  match, player, ack tick, last tick, count, 2-bit codes
+//                               (the last few ticks' inputs, so a lost packet costs nothing)
+//   SNAPSHOT  server -> client  match, tick, baseline tick, input tick, inputs, changed-word mask,
+//                               changed words (input tick and inputs feed client prediction)
+//   BYE       either way        match, player                the match is over or abandoned
+//
+// Snapshots are delta-compressed: the state is packed into STATE_WORDS
+// 32-bit words and only words that differ from a baseline are sent, where
+// the baseline is the newest snapshot the client has acknowledged (or all
+// zeros when there is none). In play only the ball and moving paddles
+// change between snapshots, so a typical one is about 30 bytes.
+namespace net {
+
+    const unsigned short DEFAULT_PORT = 24680;
+    const std::size_t MAX_PACKET_SIZE = 512;
+    const std::uint32_t NO_TICK = 0xffffffffu;
+    const int MAX_INPUTS_PER_PACKET = 16;
+    const int STATE_WORDS = 32;
+
+    enum class PacketType : std::uint8_t {
+        HELLO = 1,
+        WELCOME = 2,
+        INPUT = 3,
+        SNAPSHOT = 4,
+        BYE = 5
+    };
+
+    struct Hello {
+        std::uint32_t nonce = 0;   // Echoed in WELCOME so a client knows the reply is its own
+    };
+
+    struct Welcome {
+        std::uint32_t nonce = 0;
+        std::uint32_t matchId = 0;
+        std::uint8_t player = 0;   // 1 = left paddle, 2 = right paddle
+        SimulationConfig config;
+    };
+
+    // Inputs for ticks lastTick - count + 1 .. lastTick, oldest first
+    struct InputPacket {
+        std::uint32_t matchId = 0;
+        std::uint8_t player = 0;
+        std::uint32_t ackTick = NO_TICK;   // Newest snapshot the client has decoded
+        std::uint32_t lastTick = 0;
+        std::uint8_t count = 0;
+        std::uint8_t codes[MAX_INPUTS_PER_PACKET] = {};
+    };
+
+    struct SnapshotHeader {
+        std::uint32_t matchId = 0;
+        std::uint32_t tick = 0;
+        std::uint32_t baselineTick = NO_TICK;   // NO_TICK: delta against all zeros
+        std::uint32_t inputTick = NO_TICK;      // Newest tick this client has sent input for, as received
+        std::uint8_t inputs = 0;                // Codes stepped into this tick: player 1 bits 0-1, player 2 bits 2-3
+    };
+
+    struct Bye {
+        std::uint32_t matchId = 0;
+        std::uint8_t player = 0;
+    };
+
+    // Match state as words; all zeros is the implicit baseline
+    void packState(const SimulationState& state, std::uint32_t (&words)[STATE_WORDS]);
+    void unpackState(const std::uint32_t (&words)[STATE_WORDS], SimulationState& state);
+
+    // One paddle's keys as a 2-bit code
+    std::uint8_t encodePaddleInput(const PaddleInput& input);
+    PaddleInput decodePaddleInput(std::uint8_t code);
+
+    // Writers fill out (at least MAX_PACKET_SIZE bytes) and return the length
+    std::size_t writeHello(std::uint8_t* out, const Hello& hello);
+    std::size_t writeWelcome(std::uint8_t* out, const Welcome& welcome);
+    std::size_t writeInput(std::uint8_t* out, const InputPacket& input);
+    std::size_t writeSnapshot(std::uint8_t* out, const SnapshotHeader& header,
+                              const std::uint32_t (&words)[STATE_WORDS], const std::uint32_t (&baseline)[STATE_WORDS]);
+    std::size_t writeBye(std::uint8_t* out, const Bye& bye);
+
+    // Readers validate the header and length; false means drop the datagram
+    bool readType(const std::uint8_t* data, std::size_t size, PacketType& type);
+    bool readHello(const std::uint8_t* data, std::size_t size, Hello& hello);
+    bool readWelcome(const std::uint8_t* data, std::size_t size, Welcome& welcome);
+    bool readInput(const std::uint8_t* data, std::size_t size, InputPacket& input);
+    bool readBye(const std::uint8_t* data, std::size_t size, Bye& bye);
+
+    // Snapshots are read in two steps: the header names the baseline the
+    // body was encoded against, which the caller looks up and passes back
+    bool readSnapshotHeader(const std::uint8_t* data, std::size_t size, SnapshotHeader& header);
+    bool readSnapshotBody(const std::uint8_t* data, std::size_t size, const std::uint32_t (&baseline)[STATE_WORDS],
+                          std::uint32_t (&words)[STATE_WORDS]);
+
+} // namespace net
+
+#endif // NETPROTOCOL_H
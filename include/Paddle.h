@@ -2,34 +2,31 @@
 #define PADDLE_H
 
 #include <SFML/Graphics.hpp>
+#include "Simulation.h"
 
+// A paddle as the game sees it: its keys plus a mirror of the
+// Simulation's state. Physics live in Simulation, drawing in
+// PlayfieldRenderer, and the keys are read by the InputSampler.
 class Paddle {
 private:
-    sf::RectangleShape shape;
-    float speed;
+    PaddleState state;
     sf::Keyboard::Key upKey;
     sf::Keyboard::Key downKey;
-    float windowHeight;
 
 public:
     // Constructor
-    Paddle(float startX, float startY, sf::Keyboard::Key up, sf::Keyboard::Key down, float winHeight);
+    Paddle(float startX, float startY, sf::Keyboard::Key up, sf::Keyboard::Key down);
 
-    // Movement methods
-    void moveUp(float deltaTime);
-    void moveDown(float deltaTime);
-    void update(float deltaTime);
-
-    // Rendering
-    void render(sf::RenderWindow& window);
+    // Mirror state owned by a Simulation
+    void setState(const PaddleState& newState);
 
     // Getters
+    const PaddleState& getState() const { return state; }
+    sf::Keyboard::Key getUpKey() const { return upKey; }
+    sf::Keyboard::Key getDownKey() const { return downKey; }
     sf::FloatRect getBounds() const;
     sf::Vector2f getPosition() const;
     sf::Vector2f getSize() const;
-
-    // Reset position
-    void reset(float x, float y);
 };
 
 #endif // PADDLE_H
@@ -0,0 +1,54 @@
+#ifndef PADDLEAI_H
+#define PADDLEAI_H
+
+#include <cstdint>
+#include <string>
+#include "Simulation.h"
+#include "Random.h"
+
+// How a simulated paddle is driven
+enum class ControllerType {
+    AI,     // Tracks the ball with reaction delay and aim error
+    IDLE,   // Never moves
+    SWEEP   // Scripted: sweeps wall to wall regardless of the ball
+};
+
+// Tunables for the computer opponent
+struct PaddleAIConfig {
+    int reactionTicks = 8;     // Ticks between decisions
+    float aimError = 60.0f;    // Max random offset from the ball, in pixels
+    float deadZone = 6.0f;     // Don't twitch when this close to the target
+};
+
+class PaddleAI {
+private:
+    ControllerType type;
+    PaddleAIConfig config;
+    int player; // 1 = left paddle, 2 = right paddle
+
+    Random rng;
+    int ticksUntilThink;
+    float targetY;
+    bool sweepingDown;
+
+public:
+    // Constructor
+    PaddleAI(ControllerType controllerType, int playerNumber, std::uint64_t seed,
+             const PaddleAIConfig& cfg = PaddleAIConfig());
+
+    // Decide this tick's input
+    PaddleInput think(const SimulationState& state, const SimulationConfig& simConfig);
+    PaddleInput think(const BallState& ball, const PaddleState& paddle, float fieldHeight);
+
+    // The two halves of an AI decision, for callers that keep the target
+    // and reaction countdown themselves (the SoA batch): where the paddle
+    // center should go, which draws on the aim randomness, and the input
+    // that moves it there
+    float pickTarget(const BallState& ball, const PaddleState& paddle);
+    static PaddleInput follow(float center, float targetY, float deadZone);
+
+    // Parse "ai", "idle" or "sweep"; returns false on unknown names
+    static bool parseType(const std::string& name, ControllerType& out);
+};
+
+#endif // PADDLEAI_H
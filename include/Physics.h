@@ -0,0 +1,48 @@
+#ifndef PHYSICS_H
+#define PHYSICS_H
+
+#include "Simulation.h"
+#include "Random.h"
+
+// Stateless Pong physics shared by Simulation, Ball and Paddle.
+// Nothing in here touches SFML, so it runs the same with or without a window.
+namespace physics {
+
+    // Paddle movement (clamped to the field)
+    void movePaddleUp(PaddleState& paddle, float deltaTime);
+    void movePaddleDown(PaddleState& paddle, float deltaTime, float fieldHeight);
+    void updatePaddle(PaddleState& paddle, const PaddleInput& input, float deltaTime, float fieldHeight);
+
+    // Move the ball and bounce it off the top/bottom walls; returns true on a wall hit
+    bool updateBall(BallState& ball, float deltaTime, float fieldHeight);
+
+    // Clamp the ball inside the top/bottom walls; returns true if it touched one
+    bool checkWallCollision(BallState& ball, float fieldHeight);
+
+    // Bounce the ball off a paddle; returns true on a hit
+    bool checkPaddleCollision(BallState& ball, const PaddleState& paddle);
+
+    // Paddle response: reflect, angle by hit position, speed up, push clear
+    void bounceOffPaddle(BallState& ball, const PaddleState& paddle);
+
+    // Time (0..maxTime) until the moving ball first touches the paddle, or -1 if it doesn't
+    float paddleTimeOfImpact(const BallState& ball, const PaddleState& paddle, float maxTime);
+
+    // Continuous alternative to updateBall + checkPaddleCollision: moves the ball
+    // through the whole step, resolving each wall/paddle impact at its exact time
+    // so fast balls and long steps can't tunnel through a paddle
+    void sweepBall(BallState& ball, const PaddleState& paddle1, const PaddleState& paddle2,
+                   float deltaTime, float fieldHeight, bool& wallHit, bool& paddleHit);
+
+    // Returns 1 if player 1 scores, 2 if player 2 scores, 0 otherwise
+    int checkScore(const BallState& ball, float fieldWidth);
+
+    // Run the 3-2-1 countdown clock
+    void updateCountdown(bool& isCountingDown, float& countdownTimer, int& countdownNumber, float deltaTime);
+
+    // Put the ball back in the center with a random serve
+    void resetBall(BallState& ball, float fieldWidth, float fieldHeight, Random& rng);
+
+} // namespace physics
+
+#endif // PHYSICS_H
@@ -0,0 +1,30 @@
+#ifndef PLAYFIELDRENDERER_H
+#define PLAYFIELDRENDERER_H
+
+#include <SFML/Graphics.hpp>
+#include "Simulation.h"
+
+// Draws the playfield in two draw calls: a center line built once at
+// startup, and one batch holding both paddles and the ball that is
+// rewritten in place every frame (fixed size, no reallocation).
+class PlayfieldRenderer {
+private:
+    sf::VertexArray centerLine;
+    sf::VertexArray dynamicBatch;
+    unsigned ballSegments;
+
+    void buildCenterLine(float fieldWidth, float fieldHeight);
+    void writeRect(std::size_t first, float x, float y, float width, float height, const sf::Color& color);
+
+public:
+    // Constructor
+    PlayfieldRenderer(float fieldWidth, float fieldHeight, unsigned segments = 30);
+
+    // Refresh paddle and ball vertices from the simulation
+    void update(const SimulationState& state);
+
+    // Draw everything
+    void render(sf::RenderTarget& target) const;
+};
+
+#endif // PLAYFIELDRENDERER_H
@@ -0,0 +1,102 @@
+#ifndef PROFILEINDEX_H
+#define PROFILEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "UserProfile.h"
+
+// In-memory profile container: an open-addressing (linear probing) hash
+// table for lookups by name, plus a side array of entry numbers kept in
+// name order for listing and prefix/range queries. Lookups take a
+// std::string_view, so callers never build a std::string to search.
+//
+// Profiles are stored in fixed-size blocks that a View can share with
+// another thread. Taking a view copies no profiles; modifying a profile
+// whose block a view still holds copies that one block first
+// (copy-on-write), so a view never changes. Profiles are never removed,
+// and a pointer returned by find() stays valid until clear() or until the
+// next view() (after which the block may be copied). Names are kept once
+// more outside the blocks and never move, for callers that keep them.
+class ProfileIndex {
+private:
+    struct Slot {
+        std::uint32_t hash;
+        std::uint32_t entry;   // EMPTY when unused
+    };
+    static const std::uint32_t EMPTY = 0xffffffffu;
+    static const std::size_t BLOCK_SIZE = 256;
+
+    struct Block {
+        UserProfile profiles[BLOCK_SIZE];
+    };
+
+    std::vector<std::shared_ptr<Block>> blocks;
+    std::deque<std::string> names;                  // By entry number
+    std::vector<Slot> slots;                        // Power-of-two size
+    std::shared_ptr<std::vector<std::uint32_t>> sorted;  // Entry numbers in name order
+
+    static std::size_t hashName(std::string_view name);
+    std::size_t findSlot(std::string_view name, std::size_t hash) const;
+    void grow();
+    const UserProfile& entryAt(std::uint32_t entry) const {
+        return blocks[entry / BLOCK_SIZE]->profiles[entry % BLOCK_SIZE];
+    }
+    UserProfile& writableEntry(std::uint32_t entry);
+
+public:
+    // Read-only snapshot of the profiles, in name order. Shares the blocks
+    // with the index, so it is cheap to take and may be read on any thread
+    // while the index goes on changing.
+    class View {
+    private:
+        std::vector<std::shared_ptr<const Block>> blocks;
+        std::shared_ptr<const std::vector<std::uint32_t>> sorted;
+
+    public:
+        std::size_t size() const { return sorted ? sorted->size() : 0; }
+        const UserProfile& byName(std::size_t rank) const {
+            std::uint32_t entry = (*sorted)[rank];
+            return blocks[entry / BLOCK_SIZE]->profiles[entry % BLOCK_SIZE];
+        }
+
+        friend class ProfileIndex;
+    };
+
+    // Constructor
+    ProfileIndex();
+
+    // Size
+    std::size_t size() const { return names.size(); }
+    bool empty() const { return names.empty(); }
+    void clear();
+    void reserve(std::size_t count);
+
+    // Lookup by name (nullptr if absent)
+    UserProfile* find(std::string_view name);
+    const UserProfile* find(std::string_view name) const;
+
+    // Add a profile, or overwrite the one with the same name; returns the stored copy.
+    // Adding names in ascending order (as snapshots are) keeps this O(1).
+    UserProfile& insertOrAssign(UserProfile profile);
+
+    // Profile at a position in name order
+    UserProfile& byName(std::size_t rank) { return writableEntry((*sorted)[rank]); }
+    const UserProfile& byName(std::size_t rank) const { return entryAt((*sorted)[rank]); }
+
+    // First position in name order whose name is not less than the given one
+    std::size_t lowerBound(std::string_view name) const;
+
+    // The index's own copy of a stored name (empty if absent), which stays
+    // put until clear() even when the profile's block is copied
+    std::string_view storedName(std::string_view name) const;
+
+    // Share the profiles as they are now
+    View view() const;
+};
+
+#endif // PROFILEINDEX_H
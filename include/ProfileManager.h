@@ -1,46 +1,147 @@
 #ifndef PROFILEMANAGER_H
 #define PROFILEMANAGER_H
 
+#include <cstdint>
 #include <string>
-#include <map>
+#include <string_view>
+#include <memory>
 #include <vector>
 #include "nlohmann/json.hpp"
+#include "UserProfile.h"
+#include "BinaryProfileStore.h"
+#include "ProfileIndex.h"
+#include "RankIndex.h"
 
 using json = nlohmann::json;
 
-struct UserProfile {
-    std::string username;
-    int wins;
-    int losses;
-    int totalGames;
+// Where and how profiles are stored
+struct ProfileStoreConfig {
+    std::string path = "assets/profiles.json";
+    ProfileFormat format = ProfileFormat::JSON;
+    std::uint64_t compactEvery = 1000;   // Journal entries between snapshot rewrites (0 = never)
+};
+
+// Leaderboard orderings
+enum class LeaderboardKind {
+    WINS,       // Most wins
+    WIN_RATE,   // Best win rate (then most games), among profiles with enough games
+    RATING      // Highest Elo rating
+};
+const std::size_t LEADERBOARD_KINDS = 3;
 
-    UserProfile() : username(""), wins(0), losses(0), totalGames(0) {}
-    UserProfile(const std::string& name) : username(name), wins(0), losses(0), totalGames(0) {}
+class ProfileWriter;
+
+// What a snapshot is built from: the mapped base and a view of the overlay,
+// neither of which changes, so the writer merges them on its own thread
+struct ProfileSnapshotSource {
+    std::shared_ptr<const BinaryProfileStore> base;
+    ProfileIndex::View overlay;
+    std::uint64_t generation = 0;
+    std::uint64_t lastSequence = 0;
+
+    // Every profile in name order, the overlay shadowing the base
+    ProfileSnapshot collect() const;
 };
 
+// Profiles live in a snapshot file (profiles.json or profiles.bin) plus an
+// append-only journal of changes made since (<snapshot>.journal, one JSON
+// object per line, each with a sequence number). Changes only append a
+// journal line; every compactEvery entries the full snapshot is rewritten
+// and the journal emptied. Loading reads the snapshot, replays the journal
+// entries newer than it, and compacts if the journal was not empty.
+//
+// A JSON snapshot is parsed into the in-memory index. A binary snapshot is
+// mapped as a read-only base instead; the index then only holds the overlay
+// of profiles that were created or touched since, which shadow the base.
 class ProfileManager {
 private:
-    std::map<std::string, UserProfile> profiles;
+    std::shared_ptr<const BinaryProfileStore> base;   // Shared with queued snapshots
+    ProfileIndex profiles;
     std::string filepath;
+    std::string journalPath;
+    ProfileFormat format;
+    std::unique_ptr<ProfileWriter> writer;
+    
+    // Journal state
+    std::uint64_t generation;
+    std::uint64_t nextSequence;
+    std::uint64_t journalEntries;
+    std::uint64_t compactEvery;
+    
+    // Leaderboards, built on first use and then updated with every result.
+    // Keys point at names in the base or the overlay's stored names, so
+    // both must stay put while the boards are built (they are dropped on
+    // load and import).
+    RankIndex leaderboards[LEADERBOARD_KINDS];
+    bool leaderboardsBuilt;
+
+    bool loadSnapshot();
+    bool loadBinarySnapshot();
+    ProfileSnapshotSource shareSnapshot() const;
+    bool replayJournal(std::uint64_t snapshotSequence);
+    bool applyEntry(const json& entry);
+    void applyResult(std::string_view username, bool won);
+    void applyMatch(std::string_view winner, std::string_view loser);
+    bool readProfile(std::string_view username, UserProfile& profile) const;
+    static bool leaderboardKey(LeaderboardKind kind, const UserProfile& profile, std::string_view name,
+                               RankIndex::Key& key);
+    void buildLeaderboards();
+    void dropLeaderboards();
+    void rankProfile(const UserProfile& profile);
+    void unrankProfile(const UserProfile& profile);
+    void appendEntry(json entry);
 
 public:
-    // Constructor
-    ProfileManager(const std::string& profilePath = "assets/profiles.json");
+    // Constructors and destructor (the destructor waits for pending writes)
+    ProfileManager(const std::string& profilePath = "assets/profiles.json", std::uint64_t compactInterval = 1000);
+    explicit ProfileManager(const ProfileStoreConfig& config);
+    ~ProfileManager();
 
-    // Load and save profiles
+    // Load and save profiles. saveProfiles() compacts: it hands a full
+    // snapshot to the background writer and returns immediately.
+    // flush() waits until everything queued is on disk.
     bool loadProfiles();
     bool saveProfiles();
+    bool flush();
+    
+    // JSON interchange: importJson merges a profiles.json (either layout)
+    // into this store; exportJson writes every profile as profiles.json
+    bool importJson(const std::string& path);
+    bool exportJson(const std::string& path) const;
 
     // Profile management
-    UserProfile* getProfile(const std::string& username);
+    UserProfile* getProfile(std::string_view username);
     bool createProfile(const std::string& username);
     void updateStats(const std::string& username, bool won);
     
+    // Record both sides of a finished match with a single save
+    void recordMatchResult(const std::string& winner, const std::string& loser);
+    
     // Get all profile names
     std::vector<std::string> getProfileNames() const;
+    std::size_t getProfileCount() const;
+    
+    // Page through profiles in name order without touching the rest:
+    // up to count profiles whose names are >= name ("" = from the first),
+    // or < name ("" = up to the last), replacing page's contents in
+    // ascending order. With a prefix only names starting with it count.
+    // O(log n + count) however many profiles match; returns the number found.
+    std::size_t getProfilesFrom(std::string_view name, std::size_t count, std::vector<UserProfile>& page,
+                                std::string_view prefix = std::string_view()) const;
+    std::size_t getProfilesBefore(std::string_view name, std::size_t count, std::vector<UserProfile>& page,
+                                  std::string_view prefix = std::string_view()) const;
 
     // Check if profile exists
-    bool profileExists(const std::string& username) const;
+    bool profileExists(std::string_view username) const;
+    
+    // Leaderboards, best first with ties by name. Built on the first call,
+    // then kept current by every result, so a rank lookup is O(log n) and a
+    // page of count rows O(count log n). Win rate only ranks profiles with
+    // at least WIN_RATE_MIN_GAMES games.
+    static const int WIN_RATE_MIN_GAMES = 10;
+    std::size_t getLeaderboardSize(LeaderboardKind kind);
+    std::size_t getLeaderboard(LeaderboardKind kind, std::size_t first, std::size_t count, std::vector<UserProfile>& page);
+    bool getLeaderboardRank(LeaderboardKind kind, std::string_view username, std::size_t& rank);
 };
 
 #endif // PROFILEMANAGER_H
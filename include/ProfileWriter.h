@@ -0,0 +1,70 @@
+#ifndef PROFILEWRITER_H
+#define PROFILEWRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ProfileManager.h"
+
+// Does all profile disk I/O on a background thread so the game thread
+// never waits on copying profiles, serialization or fsync.
+//  - Journal lines are appended in order; everything queued while a write
+//    is in progress goes out as one write + one fsync (group commit).
+//  - Snapshots coalesce: only the newest one queued is written. A snapshot
+//    makes every journal line before it redundant, so after it is safely
+//    renamed into place the journal is truncated. Lines it covers that
+//    were still queued wait with it, and are appended after all if the
+//    snapshot cannot be written.
+// Files are replaced via temp file + fsync + rename, so a crash leaves
+// either the old or the new snapshot, never half of one.
+class ProfileWriter {
+private:
+    std::string snapshotPath;
+    std::string journalPath;
+    ProfileFormat format;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeWorker;
+    std::condition_variable writeDone;
+
+    ProfileSnapshotSource pendingSnapshot;
+    bool hasSnapshot;
+    std::string pendingJournal;
+    std::string coveredJournal;    // Queued lines the pending snapshot makes redundant
+    bool writing;
+    bool stopping;
+    bool lastWriteOk;
+
+    void run();
+
+public:
+    // Constructor
+    ProfileWriter(const std::string& snapshotFile, const std::string& journalFile, ProfileFormat snapshotFormat);
+
+    // Destructor (writes anything still queued)
+    ~ProfileWriter();
+
+    ProfileWriter(const ProfileWriter&) = delete;
+    ProfileWriter& operator=(const ProfileWriter&) = delete;
+
+    // Queue one journal line (without the trailing newline)
+    void append(const std::string& line);
+
+    // Queue a snapshot, replacing one that has not been written yet; it is
+    // collected from the source on the writer thread
+    void submit(ProfileSnapshotSource source);
+
+    // Block until everything queued is on disk; false if the last write failed
+    bool flush();
+
+    // Serialize a snapshot as profiles.json or as a binary store image
+    static std::string serialize(const ProfileSnapshot& snapshot, ProfileFormat format);
+
+    // Write, fsync and rename into place
+    static bool writeAtomically(const std::string& path, const std::string& contents);
+};
+
+#endif // PROFILEWRITER_H
@@ -0,0 +1,37 @@
+#ifndef PROFILEROVERLAY_H
+#define PROFILEROVERLAY_H
+
+#include <SFML/Graphics.hpp>
+#include "CachedText.h"
+#include "FrameProfiler.h"
+
+// F3 overlay: a bar per recent frame, stacked by phase, against guide
+// lines at 60 and 30 FPS, plus p50/p99/max for the frame and each phase.
+// The bars are rewritten in place every frame; the numbers are laid out
+// again only a few times a second, since building text allocates.
+class ProfilerOverlay {
+private:
+    sf::RectangleShape background;
+    sf::VertexArray bars;     // CAPACITY frames x PHASE_COUNT quads, as triangles
+    sf::VertexArray guides;
+    CachedText statsText;
+    FrameProfiler::Frame recent[FrameProfiler::CAPACITY];
+    float graphX;
+    float graphBottom;
+    unsigned framesUntilText;
+
+    void writeBar(std::size_t first, float left, float top, float bottom, const sf::Color& color);
+    void updateText(const FrameProfiler& profiler);
+
+public:
+    // Constructor (x, y is the top-left corner)
+    ProfilerOverlay(const sf::Font& font, float x, float y);
+
+    // Refresh the graph from the profiler's ring
+    void update(const FrameProfiler& profiler);
+
+    // Draw everything
+    void render(sf::RenderTarget& target) const;
+};
+
+#endif // PROFILEROVERLAY_H
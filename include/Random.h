@@ -0,0 +1,79 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Small, fast, seedable PRNG (PCG32). Plain data: copying it copies the
+// stream position, so a copied simulation replays the same numbers.
+// Each simulation owns its own generator - there is no global state.
+class Random {
+private:
+    std::uint64_t state;
+    std::uint64_t increment;
+
+public:
+    // Constructor
+    explicit Random(std::uint64_t seedValue = 0x853c49e6748fea9bULL, std::uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        seed(seedValue, stream);
+    }
+
+    // Restart the sequence
+    void seed(std::uint64_t seedValue, std::uint64_t stream = 0xda3e39cb94b95bdbULL) {
+        state = 0;
+        increment = (stream << 1u) | 1u;
+        next();
+        state += seedValue;
+        next();
+    }
+
+    // Raw generator position, for sending a state over the network exactly
+    std::uint64_t getState() const { return state; }
+    std::uint64_t getIncrement() const { return increment; }
+    void setRaw(std::uint64_t rawState, std::uint64_t rawIncrement) {
+        state = rawState;
+        increment = rawIncrement;
+    }
+
+    // Next 32 random bits
+    std::uint32_t next() {
+        std::uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        std::uint32_t xorshifted = static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+        std::uint32_t rot = static_cast<std::uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // Uniform integer in [0, bound) without modulo bias
+    std::uint32_t nextBelow(std::uint32_t bound) {
+        std::uint64_t product = static_cast<std::uint64_t>(next()) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            std::uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = static_cast<std::uint64_t>(next()) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32u);
+    }
+
+    // Uniform float in [0, 1)
+    float nextFloat() {
+        return static_cast<float>(next() >> 8u) * (1.0f / 16777216.0f);
+    }
+
+    // Uniform float in [low, high)
+    float uniform(float low, float high) {
+        return low + (high - low) * nextFloat();
+    }
+
+    // Derive a well-mixed seed from a base seed and an index (SplitMix64)
+    static std::uint64_t deriveSeed(std::uint64_t baseSeed, std::uint64_t index) {
+        std::uint64_t z = baseSeed + (index + 1) * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27u)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31u);
+    }
+};
+
+#endif // RANDOM_H
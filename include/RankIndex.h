@@ -0,0 +1,70 @@
+#ifndef RANKINDEX_H
+#define RANKINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Order-statistic treap of (score, name) keys, best score first and ties
+// broken by name. Insert, erase, "how many keys rank before this one" and
+// "key at rank k" are all O(log n). Nodes live in one vector and refer to
+// each other by index. Names are not copied: whatever a key's name points
+// at must outlive the key.
+class RankIndex {
+public:
+    struct Key {
+        std::int64_t score;
+        std::string_view name;
+    };
+
+private:
+    struct Node {
+        Key key;
+        std::uint32_t priority;
+        std::uint32_t left;
+        std::uint32_t right;
+        std::uint32_t size;     // Nodes in this subtree
+    };
+    static const std::uint32_t NIL = 0xffffffffu;
+
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> freeNodes;
+    std::uint32_t root;
+    std::uint32_t seed;
+
+    static bool before(const Key& a, const Key& b);
+    std::uint32_t sizeOf(std::uint32_t node) const { return node == NIL ? 0 : nodes[node].size; }
+    void resize(std::uint32_t node);
+    std::uint32_t nextPriority();
+    std::uint32_t newNode(const Key& key, std::uint32_t priority);
+    void split(std::uint32_t node, const Key& key, std::uint32_t& left, std::uint32_t& right);
+    std::uint32_t merge(std::uint32_t left, std::uint32_t right);
+    bool eraseFrom(std::uint32_t& node, const Key& key);
+    std::uint32_t buildRange(const std::vector<Key>& keys, std::size_t begin, std::size_t end, std::uint32_t depth);
+
+public:
+    // Constructor
+    RankIndex();
+
+    // Size
+    std::size_t size() const { return sizeOf(root); }
+    bool empty() const { return root == NIL; }
+    void clear();
+
+    // Replace the contents with keys (any order) in O(n log n), much
+    // faster than inserting them one by one
+    void build(std::vector<Key> keys);
+
+    // Add a key; remove one (false if it was not there)
+    void insert(const Key& key);
+    bool erase(const Key& key);
+
+    // Number of keys ranked before key (its 0-based rank if present)
+    std::size_t rankOf(const Key& key) const;
+
+    // Key at a 0-based rank (rank < size())
+    const Key& at(std::size_t rank) const;
+};
+
+#endif // RANKINDEX_H
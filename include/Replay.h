@@ -0,0 +1,91 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+
+// Everything needed to re-simulate a match bit for bit.
+// File layout (little-endian): "PONGRPL" magic, version, config, seed,
+// player names, tick count, final state checksum, then the inputs as
+// (4-bit input code, varint run length) pairs.
+struct ReplayData {
+    SimulationConfig config;
+    std::uint64_t seed = 0;
+    std::string player1Name;
+    std::string player2Name;
+    std::uint64_t tickCount = 0;
+    std::uint64_t finalChecksum = 0;
+    std::vector<std::uint8_t> inputRuns;
+};
+
+// Records per-tick inputs of one match in memory
+class ReplayRecorder {
+private:
+    ReplayData data;
+    bool recording;
+    std::uint8_t runCode;
+    std::uint64_t runLength;
+
+    void flushRun();
+
+public:
+    // Constructor
+    ReplayRecorder();
+
+    // Begin a new recording (drops any previous one)
+    void start(const SimulationConfig& config, std::uint64_t seed,
+               const std::string& player1Name, const std::string& player2Name);
+
+    // Append the input used for one tick
+    void record(const SimulationInput& input);
+
+    // Stop and write the file; finalState is the state after the last tick
+    bool save(const std::string& path, const SimulationState& finalState);
+
+    // Getters
+    bool isRecording() const { return recording; }
+    std::uint64_t getTickCount() const { return data.tickCount; }
+};
+
+// Reads a replay and hands back its inputs one tick at a time
+class ReplayPlayer {
+private:
+    ReplayData data;
+    std::size_t readPos;
+    std::uint8_t runCode;
+    std::uint64_t runRemaining;
+    std::uint64_t ticksRead;
+
+public:
+    // Constructor
+    ReplayPlayer();
+
+    // Load a replay file
+    bool load(const std::string& path);
+
+    // Next tick's input; returns false when the recording is exhausted
+    bool nextInput(SimulationInput& input);
+
+    // Start again from the first tick
+    void rewind();
+
+    // Getters
+    const ReplayData& getData() const { return data; }
+    bool isFinished() const { return ticksRead >= data.tickCount; }
+};
+
+namespace replay {
+
+    // Hash of the gameplay-relevant state, used to prove a replay is bit-exact
+    std::uint64_t checksum(const SimulationState& state);
+
+    // Re-simulate a replay without a window, as fast as possible.
+    // Returns true when the final state matches the recording.
+    bool runHeadless(const std::string& path, std::ostream& out);
+
+} // namespace replay
+
+#endif // REPLAY_H
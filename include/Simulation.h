@@ -0,0 +1,152 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstdint>
+#include "Random.h"
+
+// Match tunables (defaults match the 800x600 window layout)
+struct SimulationConfig {
+    float fieldWidth = 800.0f;
+    float fieldHeight = 600.0f;
+
+    float ballRadius = 8.0f;
+    float ballSpeed = 300.0f;
+    float speedUpFactor = 1.05f;   // Speed multiplier per paddle hit
+    float maxSpeedFactor = 1.5f;   // Speed cap as a multiple of ballSpeed
+
+    float paddleWidth = 15.0f;
+    float paddleHeight = 80.0f;
+    float paddleSpeed = 400.0f;
+    float paddle1X = 30.0f;
+    float paddle2X = 755.0f;
+    float paddleStartY = 250.0f;
+
+    int maxScore = 5;
+    int tickRate = 120; // Fixed simulation ticks per second
+
+    // Swept collision (no tunnelling at any speed or tick rate); false uses
+    // the classic move-then-overlap test
+    bool continuousCollision = true;
+};
+
+// Ball physics state (x/y is the top-left corner, like sf::CircleShape)
+struct BallState {
+    float x;
+    float y;
+    float vx;
+    float vy;
+    float radius;
+    float baseSpeed;
+    float currentSpeed;
+    float speedUpFactor;
+    float maxSpeedFactor;
+};
+
+// Paddle physics state (x/y is the top-left corner)
+struct PaddleState {
+    float x;
+    float y;
+    float width;
+    float height;
+    float speed;
+};
+
+// Input for one paddle during one tick
+struct PaddleInput {
+    bool up = false;
+    bool down = false;
+};
+
+// Input for both paddles during one tick
+struct SimulationInput {
+    PaddleInput player1;
+    PaddleInput player2;
+};
+
+// Complete match state - plain data, safe to copy
+struct SimulationState {
+    BallState ball;
+    PaddleState paddle1;
+    PaddleState paddle2;
+
+    int score1;
+    int score2;
+
+    // Countdown after each score
+    bool isCountingDown;
+    float countdownTimer;
+    int countdownNumber;
+
+    bool matchOver;
+    std::uint64_t tick;
+
+    // Serve randomness; part of the state so copies stay deterministic
+    std::uint64_t seed;
+    Random rng;
+};
+
+// What happened during a single step
+struct StepResult {
+    bool wallHit = false;
+    bool paddleHit = false;
+    int scorer = 0;        // 1 or 2 if a player scored this step, 0 otherwise
+    bool matchOver = false;
+};
+
+// Window-free Pong engine. Owns the match state and advances it by step().
+class Simulation {
+private:
+    SimulationConfig config;
+    SimulationState state;
+
+public:
+    // Constructor
+    Simulation(const SimulationConfig& cfg = SimulationConfig());
+
+    // Advance the match by one step of length deltaTime
+    StepResult step(const SimulationInput& input, float deltaTime);
+
+    // Reset scores, paddles and ball for a new match; the seed fixes every serve
+    void resetMatch(std::uint64_t seed);
+
+    // Re-serve the ball and start the countdown
+    void resetRound();
+
+    // Jump to a saved state (a plain copy; used to roll back a prediction)
+    void restoreState(const SimulationState& saved) { state = saved; }
+
+    // Getters
+    const SimulationState& getState() const { return state; }
+    const SimulationConfig& getConfig() const { return config; }
+    float getTickDuration() const;
+};
+
+// Positions a fraction alpha (0..1) of the way from one tick's state to
+// the next, for drawing between ticks; everything else is taken from to.
+// A point scored between them re-serves the ball, which is not slid
+// across the field: that returns to as it is.
+SimulationState interpolateState(const SimulationState& from, const SimulationState& to, float alpha);
+
+// Accumulates frame time and hands out whole fixed-size ticks
+class FixedTimestep {
+private:
+    float stepSize;
+    float accumulator;
+    int maxStepsPerFrame;
+
+public:
+    // Constructor
+    FixedTimestep(float step, int maxSteps = 8);
+
+    // Add frame time; returns the number of ticks to run this frame
+    int advance(float frameTime);
+
+    // Drop any banked time (e.g. after a pause)
+    void reset();
+
+    // Getters
+    float getStepSize() const { return stepSize; }
+    float getAlpha() const; // Fraction of a tick left in the accumulator
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,78 @@
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "InputSampler.h"
+#include "Replay.h"
+#include "Simulation.h"
+#include "TripleBuffer.h"
+
+// What the simulation thread publishes after each batch of ticks. Event
+// counts run from the start of the match, so a reader that skips
+// snapshots still notices everything that happened.
+struct TickSnapshot {
+    SimulationState previous;           // Before the last tick, to draw from
+    SimulationState state;              // After it
+    std::uint64_t publishedAt = 0;      // InputSampler::now()
+    float alpha = 0.0f;                 // FixedTimestep::getAlpha() at publishedAt
+    std::uint32_t hits = 0;             // Wall and paddle hits
+    std::uint32_t points = 0;           // Points scored
+    std::uint64_t firstKeyChange = 0;   // Oldest key change these ticks took, or 0
+    bool replayEnded = false;           // The recording ran out before the match did
+    bool done = false;                  // No ticks will follow: the match is over, or see replayEnded
+};
+
+// Runs a local match (or a replay) at its fixed tick on a thread of its
+// own, so a slow frame or a long display() never delays physics. It takes
+// keys straight from the InputSampler as each tick comes due and hands
+// every batch of ticks to the game thread through a triple buffer; the
+// game draws between the last two ticks and plays the sounds.
+//
+// Between start() and stop() the thread owns the match, the replay
+// player and recorder it was given, and the sampler's consuming side.
+class SimulationThread {
+private:
+    InputSampler& input;
+    Simulation simulation;
+    ReplayPlayer* replay;
+    ReplayRecorder* recorder;
+    float stepSize;
+    TripleBuffer<TickSnapshot> snapshots;
+    std::thread thread;
+    std::atomic<bool> stopping;
+    bool running;
+
+    void run();
+
+public:
+    // Constructor
+    explicit SimulationThread(InputSampler& inputSampler);
+
+    // Destructor (stops a running match)
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Run a match on from its current state: replaying if replayPlayer is
+    // given, else with the keys; each tick goes to replayRecorder
+    void start(const Simulation& match, ReplayPlayer* replayPlayer, ReplayRecorder* replayRecorder);
+
+    // Stop ticking and join the thread; the match as it was left
+    const Simulation& stop();
+
+    // Game thread: swap in the newest snapshot, or nullptr if nothing is new
+    const TickSnapshot* takeLatest();
+
+    // Game thread: how far from the latest snapshot's tick toward the next
+    // one the simulation is by now (0..1)
+    float getAlpha() const;
+
+    // Getters
+    bool isRunning() const { return running; }
+    const TickSnapshot& getLatest() const { return snapshots.read(); }
+};
+
+#endif // SIMULATIONTHREAD_H
@@ -0,0 +1,62 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Capacity must be a power of two. Each side owns one index and
+// only reads the other's, with acquire/release ordering, so neither ever
+// waits or allocates; a full ring refuses the push instead. The indices
+// sit on separate cache lines so the two threads don't keep stealing one
+// line from each other.
+template <typename T, std::size_t Capacity>
+class SpscRing {
+private:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+    static const std::size_t MASK = Capacity - 1;
+
+    alignas(64) std::atomic<std::size_t> head;   // Next slot to read; written by the consumer
+    alignas(64) std::atomic<std::size_t> tail;   // Next slot to write; written by the producer
+    alignas(64) T items[Capacity];
+
+public:
+    // Constructor
+    SpscRing() : head(0), tail(0), items() {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer: append a copy; false if the ring is full
+    bool push(const T& item) {
+        std::size_t write = tail.load(std::memory_order_relaxed);
+        if (write - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items[write & MASK] = item;
+        tail.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: the oldest item without removing it, or nullptr if empty
+    const T* front() const {
+        std::size_t read = head.load(std::memory_order_relaxed);
+        if (read == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &items[read & MASK];
+    }
+
+    // Consumer: drop the item front() returned
+    void pop() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Either side: items queued right now (a snapshot; the other side may be moving)
+    std::size_t size() const {
+        std::size_t read = head.load(std::memory_order_acquire);   // Head first: it never passes tail
+        return tail.load(std::memory_order_acquire) - read;
+    }
+};
+
+#endif // SPSCRING_H
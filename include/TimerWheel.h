@@ -0,0 +1,68 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timer wheel for a fixed set of timers, named by index
+// (0 .. capacity-1). Time is counted in whole resolution steps: level 0
+// holds the next 256 steps one slot per step, level 1 the next 256 x 256
+// steps in slots of 256, and so on for four levels. Scheduling and
+// cancelling are O(1); advancing costs O(1) per step plus each timer's
+// cascade down a level, so the cost of a step doesn't grow with the
+// number of timers. Timers never fire early: a deadline is rounded up to
+// the next step.
+//
+// Timers sit in intrusive doubly linked lists kept in flat arrays, so
+// nothing is allocated after construction.
+class TimerWheel {
+public:
+    static constexpr std::uint32_t NONE = 0xffffffffu;
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const std::uint32_t SLOT_MASK = SLOTS - 1;
+    static const int OVERDUE_LIST = LEVELS * SLOTS;   // Scheduled at or before the current step
+
+    std::uint64_t resolution;           // Nanoseconds per step
+    std::uint64_t current;              // Steps processed so far
+    std::vector<std::uint64_t> due;     // Per timer: deadline in steps
+    std::vector<std::uint64_t> deadline;// Per timer: deadline in nanoseconds, as asked
+    std::vector<std::uint32_t> next;
+    std::vector<std::uint32_t> prev;
+    std::vector<std::uint32_t> list;    // Per timer: which list it is in, or NONE
+    std::vector<std::uint32_t> heads;   // LEVELS * SLOTS slot lists, then the overdue list
+    std::uint64_t occupied[SLOTS / 64]; // Non-empty level 0 slots
+    std::uint32_t pending;
+
+    void link(std::uint32_t timer, std::uint32_t listIndex);
+    void unlink(std::uint32_t timer);
+    void place(std::uint32_t timer);
+    void cascade(int level);
+
+public:
+    // Constructor (resolutionNs: step length; capacity: number of timers)
+    TimerWheel(std::uint64_t resolutionNs, std::uint32_t capacity);
+
+    // Arm a timer for an absolute time, replacing its previous deadline
+    void schedule(std::uint32_t timer, std::uint64_t deadlineNs);
+
+    // Disarm a timer (no-op if it isn't armed)
+    void cancel(std::uint32_t timer);
+
+    // Process every step up to nowNs and append the timers that came due
+    void advance(std::uint64_t nowNs, std::vector<std::uint32_t>& expired);
+
+    // Earliest time advance() may have something to return: exact for the
+    // next 256 steps, otherwise the next cascade (which then knows more)
+    std::uint64_t nextExpiry() const;
+
+    // Getters
+    bool isScheduled(std::uint32_t timer) const { return list[timer] != NONE; }
+    std::uint64_t getDeadline(std::uint32_t timer) const { return deadline[timer]; }
+    std::uint32_t size() const { return pending; }
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,69 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped timing zones exported as a Chrome trace (chrome://tracing or
+// ui.perfetto.dev). PONG_TRACE_SCOPE("name") times the rest of the
+// enclosing block. Without -DPONG_ENABLE_TRACE (make FEATURE_FLAGS=...)
+// the macro expands to nothing; with it, a zone costs one relaxed load
+// until start() is called. Each thread appends to its own buffer, so
+// recording never takes a lock after a thread's first zone. The buffer
+// grows by fixed-size chunks, so earlier events are never copied; a new
+// chunk costs one allocation per 16384 zones.
+namespace trace {
+
+    namespace detail {
+        extern std::atomic<bool> recording;
+    }
+
+    // True when the macros are compiled in
+    bool isCompiledIn();
+
+    // Begin recording; zones on every thread are kept until writeFile()
+    void start();
+    inline bool isEnabled() { return detail::recording.load(std::memory_order_relaxed); }
+
+    // Label the calling thread in the trace viewer
+    void setThreadName(const char* name);
+
+    // Nanoseconds since the first call, and one finished zone
+    std::uint64_t now();
+    void record(const char* name, std::uint64_t startNs, std::uint64_t endNs);
+
+    // Stop recording and write every thread's zones as trace event JSON.
+    // Threads that record must have finished (or be idle) by then.
+    bool writeFile(const std::string& path);
+
+    // Times its own lifetime; name must be a string literal
+    class Scope {
+    private:
+        const char* name;
+        std::uint64_t startNs;
+
+    public:
+        explicit Scope(const char* zoneName)
+            : name(isEnabled() ? zoneName : nullptr), startNs(name ? now() : 0) {}
+        ~Scope() {
+            if (name) {
+                record(name, startNs, now());
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+} // namespace trace
+
+#ifdef PONG_ENABLE_TRACE
+#define PONG_TRACE_CONCAT_INNER(a, b) a##b
+#define PONG_TRACE_CONCAT(a, b) PONG_TRACE_CONCAT_INNER(a, b)
+#define PONG_TRACE_SCOPE(name) trace::Scope PONG_TRACE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define PONG_TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,55 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// Hands the newest value from one writer thread to one reader thread
+// without either waiting on the other. Of three slots, the writer owns
+// one, the reader owns one and the third sits between them: publishing
+// swaps the writer's slot into the middle, and the reader swaps the
+// middle out only when something new has been published since its last
+// look. The reader always sees a whole value and only ever the newest;
+// values it was too slow for are skipped. The writer must fill its whole
+// slot each time, because it gets back an older one.
+template <typename T>
+class TripleBuffer {
+private:
+    static const unsigned INDEX_MASK = 3;
+    static const unsigned FRESH = 4;   // Set in middle when the writer has published since the reader's last take
+
+    T slots[3];
+    alignas(64) std::atomic<unsigned> middle;
+    alignas(64) unsigned back;   // Writer's slot
+    alignas(64) unsigned front;  // Reader's slot
+
+public:
+    // Constructor
+    TripleBuffer() : slots(), middle(1), back(0), front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer: the slot to fill before publish()
+    T& writeSlot() { return slots[back]; }
+
+    // Writer: make the filled slot the newest
+    void publish() {
+        unsigned previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+    }
+
+    // Reader: take the newest value if there is one; false if nothing new
+    bool take() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        unsigned previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & INDEX_MASK;
+        return true;
+    }
+
+    // Reader: the value last taken
+    const T& read() const { return slots[front]; }
+};
+
+#endif // TRIPLEBUFFER_H
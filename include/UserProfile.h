@@ -0,0 +1,30 @@
+#ifndef USERPROFILE_H
+#define USERPROFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct UserProfile {
+    static constexpr int INITIAL_RATING = 1500;
+
+    std::string username;
+    int wins;
+    int losses;
+    int totalGames;
+    int rating;     // Elo rating, moved only by two-player match results
+
+    UserProfile() : username(""), wins(0), losses(0), totalGames(0), rating(INITIAL_RATING) {}
+    UserProfile(const std::string& name)
+        : username(name), wins(0), losses(0), totalGames(0), rating(INITIAL_RATING) {}
+};
+
+// Full copy of the profiles (sorted by name), tagged with the last journal
+// entry it contains
+struct ProfileSnapshot {
+    std::vector<UserProfile> profiles;
+    std::uint64_t generation = 0;
+    std::uint64_t lastSequence = 0;
+};
+
+#endif // USERPROFILE_H
@@ -0,0 +1,144 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> allocations(0);
+std::atomic<std::uint64_t> deallocations(0);
+std::atomic<std::uint64_t> allocatedBytes(0);
+}
+
+#ifdef PONG_TRACK_ALLOCATIONS
+
+namespace {
+
+void* trackedAlloc(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* trackedAlignedAlloc(std::size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (align < sizeof(void*)) {
+        align = sizeof(void*);
+    }
+    // aligned_alloc wants the size to be a multiple of the alignment
+    std::size_t rounded = (size + align - 1) / align * align;
+    return std::aligned_alloc(align, rounded ? rounded : align);
+}
+
+void trackedFree(void* ptr) {
+    if (ptr) {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        std::free(ptr);
+    }
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    void* ptr = trackedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    void* ptr = trackedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* ptr = trackedAlignedAlloc(size, alignment);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    void* ptr = trackedAlignedAlloc(size, alignment);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+
+#endif // PONG_TRACK_ALLOCATIONS
+
+namespace alloc {
+
+    // Hooks compiled in?
+    bool isTracking() {
+#ifdef PONG_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Counters
+    std::uint64_t allocationCount() { return allocations.load(std::memory_order_relaxed); }
+    std::uint64_t deallocationCount() { return deallocations.load(std::memory_order_relaxed); }
+    std::uint64_t bytesAllocated() { return allocatedBytes.load(std::memory_order_relaxed); }
+
+} // namespace alloc
+
+// Constructor
+FrameAllocationStats::FrameAllocationStats(std::size_t bucketCount)
+    : buckets(bucketCount), frameStartCount(0), frameStartBytes(0) {
+}
+
+// Snapshot the counters at frame start
+void FrameAllocationStats::beginFrame() {
+    frameStartCount = alloc::allocationCount();
+    frameStartBytes = alloc::bytesAllocated();
+}
+
+// Charge the frame's allocations to a bucket
+std::uint64_t FrameAllocationStats::endFrame(std::size_t bucket) {
+    std::uint64_t count = alloc::allocationCount() - frameStartCount;
+    if (bucket < buckets.size()) {
+        Bucket& b = buckets[bucket];
+        b.frames++;
+        b.allocations += count;
+        b.bytes += alloc::bytesAllocated() - frameStartBytes;
+        if (count > b.maxPerFrame) {
+            b.maxPerFrame = count;
+        }
+        if (count > 0) {
+            b.framesWithAllocations++;
+        }
+    }
+    return count;
+}
+
+// Print the per-bucket summary
+void FrameAllocationStats::print(std::ostream& out, const char* const* bucketNames) const {
+    out << "Heap allocations per frame:" << std::endl;
+    for (std::size_t i = 0; i < buckets.size(); i++) {
+        const Bucket& b = buckets[i];
+        if (b.frames == 0) {
+            continue;
+        }
+        out << "  " << bucketNames[i] << ": " << b.frames << " frames, "
+            << static_cast<double>(b.allocations) / b.frames << " allocs/frame avg, "
+            << b.maxPerFrame << " max, "
+            << b.framesWithAllocations << " frames allocated, "
+            << b.bytes << " bytes total" << std::endl;
+    }
+}
@@ -0,0 +1,439 @@
+#include "BallBatch.h"
+#include "PaddleAI.h"
+#include "Physics.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Build batch parameters from a match config
+BallBatchParams BallBatchParams::fromConfig(const SimulationConfig& config) {
+    BallBatchParams params;
+    params.fieldWidth = config.fieldWidth;
+    params.fieldHeight = config.fieldHeight;
+    params.radius = config.ballRadius;
+    params.baseSpeed = config.ballSpeed;
+    params.speedUpFactor = config.speedUpFactor;
+    params.maxSpeedFactor = config.maxSpeedFactor;
+    params.paddle1X = config.paddle1X;
+    params.paddle2X = config.paddle2X;
+    params.paddleWidth = config.paddleWidth;
+    params.paddleHeight = config.paddleHeight;
+    params.paddleSpeed = config.paddleSpeed;
+    params.continuous = config.continuousCollision;
+    return params;
+}
+
+// Resize every lane array
+void BallBatch::resize(std::size_t lanes) {
+    x.resize(lanes, 0.0f);
+    y.resize(lanes, 0.0f);
+    vx.resize(lanes, 0.0f);
+    vy.resize(lanes, 0.0f);
+    speed.resize(lanes, 0.0f);
+    paddle1Y.resize(lanes, 0.0f);
+    paddle2Y.resize(lanes, 0.0f);
+    paddle1Target.resize(lanes, 0.0f);
+    paddle2Target.resize(lanes, 0.0f);
+    dt.resize(lanes, 0.0f);
+    events.resize(lanes, 0);
+}
+
+// Gather one lane into a BallState
+BallState BallBatch::getBall(std::size_t lane, const BallBatchParams& params) const {
+    BallState ball;
+    ball.x = x[lane];
+    ball.y = y[lane];
+    ball.vx = vx[lane];
+    ball.vy = vy[lane];
+    ball.radius = params.radius;
+    ball.baseSpeed = params.baseSpeed;
+    ball.currentSpeed = speed[lane];
+    ball.speedUpFactor = params.speedUpFactor;
+    ball.maxSpeedFactor = params.maxSpeedFactor;
+    return ball;
+}
+
+// Scatter a BallState into one lane
+void BallBatch::setBall(std::size_t lane, const BallState& ball) {
+    x[lane] = ball.x;
+    y[lane] = ball.y;
+    vx[lane] = ball.vx;
+    vy[lane] = ball.vy;
+    speed[lane] = ball.currentSpeed;
+}
+
+// Gather one lane's paddle into a PaddleState
+PaddleState BallBatch::getPaddle(std::size_t lane, int player, const BallBatchParams& params) const {
+    PaddleState paddle;
+    paddle.x = (player == 1) ? params.paddle1X : params.paddle2X;
+    paddle.y = (player == 1) ? paddle1Y[lane] : paddle2Y[lane];
+    paddle.width = params.paddleWidth;
+    paddle.height = params.paddleHeight;
+    paddle.speed = params.paddleSpeed;
+    return paddle;
+}
+
+namespace {
+
+// Scalar step of one lane through the shared physics functions, exactly
+// like Simulation::step
+void stepLaneScalar(BallBatch& balls, const BallBatchParams& params, std::size_t i) {
+    BallState ball = balls.getBall(i, params);
+    PaddleState paddle1 = balls.getPaddle(i, 1, params);
+    PaddleState paddle2 = balls.getPaddle(i, 2, params);
+    std::uint8_t flags = 0;
+
+    if (params.continuous) {
+        bool wallHit = false;
+        bool paddleHit = false;
+        physics::sweepBall(ball, paddle1, paddle2, balls.dt[i], params.fieldHeight, wallHit, paddleHit);
+        if (wallHit) {
+            flags |= BATCH_WALL_HIT;
+        }
+        if (paddleHit) {
+            flags |= BATCH_PADDLE_HIT;
+        }
+    } else {
+        if (physics::updateBall(ball, balls.dt[i], params.fieldHeight)) {
+            flags |= BATCH_WALL_HIT;
+        }
+        if (physics::checkPaddleCollision(ball, paddle1)) {
+            flags |= BATCH_PADDLE_HIT;
+        }
+        if (physics::checkPaddleCollision(ball, paddle2)) {
+            flags |= BATCH_PADDLE_HIT;
+        }
+    }
+
+    int scorer = physics::checkScore(ball, params.fieldWidth);
+    if (scorer == 1) {
+        flags |= BATCH_SCORE_P1;
+    } else if (scorer == 2) {
+        flags |= BATCH_SCORE_P2;
+    }
+
+    balls.setBall(i, ball);
+    balls.events[i] = flags;
+}
+
+// Scalar step of lanes [begin, end)
+void stepLanesScalar(BallBatch& balls, const BallBatchParams& params, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+        stepLaneScalar(balls, params, i);
+    }
+}
+
+// Scalar paddle steering of lanes [begin, end) through PaddleAI and physics::
+void followLanesScalar(BallBatch& balls, const BallBatchParams& params, int player, float deadZone, float deltaTime,
+                       std::size_t begin, std::size_t end) {
+    std::vector<float>& paddleY = (player == 1) ? balls.paddle1Y : balls.paddle2Y;
+    const std::vector<float>& target = (player == 1) ? balls.paddle1Target : balls.paddle2Target;
+    for (std::size_t i = begin; i < end; i++) {
+        PaddleState paddle = balls.getPaddle(i, player, params);
+        PaddleInput input = PaddleAI::follow(paddle.y + paddle.height / 2.0f, target[i], deadZone);
+        physics::updatePaddle(paddle, input, deltaTime, params.fieldHeight);
+        paddleY[i] = paddle.y;
+    }
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+// Thin wrappers so one kernel body serves both widths.
+// blend(mask, a, b) picks b where mask is set, a elsewhere.
+#if defined(__AVX2__)
+struct SimdOps {
+    typedef __m256 V;
+    static const int width = 8;
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V set1(float f) { return _mm256_set1_ps(f); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V sqrt(V a) { return _mm256_sqrt_ps(a); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V neg(V a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static V lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static V le(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static V gt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static V ge(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static V and_(V a, V b) { return _mm256_and_ps(a, b); }
+    static V or_(V a, V b) { return _mm256_or_ps(a, b); }
+    static V andnot(V a, V b) { return _mm256_andnot_ps(a, b); }
+    static V blend(V mask, V a, V b) { return _mm256_blendv_ps(a, b, mask); }
+    static int movemask(V a) { return _mm256_movemask_ps(a); }
+};
+#else
+struct SimdOps {
+    typedef __m128 V;
+    static const int width = 4;
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V set1(float f) { return _mm_set1_ps(f); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm_div_ps(a, b); }
+    static V sqrt(V a) { return _mm_sqrt_ps(a); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+    static V neg(V a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    static V lt(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static V le(V a, V b) { return _mm_cmple_ps(a, b); }
+    static V gt(V a, V b) { return _mm_cmpgt_ps(a, b); }
+    static V ge(V a, V b) { return _mm_cmpge_ps(a, b); }
+    static V and_(V a, V b) { return _mm_and_ps(a, b); }
+    static V or_(V a, V b) { return _mm_or_ps(a, b); }
+    static V andnot(V a, V b) { return _mm_andnot_ps(a, b); }
+    static V blend(V mask, V a, V b) { return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a)); }
+    static int movemask(V a) { return _mm_movemask_ps(a); }
+};
+#endif
+
+typedef SimdOps::V V;
+
+// Vector version of physics::checkPaddleCollision for one paddle.
+// Every expression mirrors the scalar code operation for operation so the
+// results are bit-identical (no FMA, same evaluation order).
+inline V collidePaddle(V& x, V y, V& vx, V& vy, V& speed, V paddleY, float paddleX, const BallBatchParams& p) {
+    const float diameter = p.radius * 2.0f;
+
+    V overlaps = SimdOps::and_(
+        SimdOps::and_(SimdOps::lt(x, SimdOps::set1(paddleX + p.paddleWidth)),
+                      SimdOps::lt(SimdOps::set1(paddleX), SimdOps::add(x, SimdOps::set1(diameter)))),
+        SimdOps::and_(SimdOps::lt(y, SimdOps::add(paddleY, SimdOps::set1(p.paddleHeight))),
+                      SimdOps::lt(paddleY, SimdOps::add(y, SimdOps::set1(diameter)))));
+    if (SimdOps::movemask(overlaps) == 0) {
+        return overlaps;
+    }
+
+    V paddleCenter = SimdOps::add(paddleY, SimdOps::set1(p.paddleHeight / 2.0f));
+    V ballCenter = SimdOps::add(y, SimdOps::set1(diameter / 2.0f));
+    V relative = SimdOps::div(SimdOps::sub(ballCenter, paddleCenter), SimdOps::set1(p.paddleHeight / 2.0f));
+
+    V newVx = SimdOps::neg(vx);
+    V newVy = SimdOps::mul(SimdOps::mul(relative, speed), SimdOps::set1(0.75f));
+
+    // std::min(a, b) returns a unless b < a; minps(b, a) returns a unless b < a
+    V newSpeed = SimdOps::min(SimdOps::set1(p.baseSpeed * p.maxSpeedFactor),
+                              SimdOps::mul(speed, SimdOps::set1(p.speedUpFactor)));
+
+    V magnitude = SimdOps::sqrt(SimdOps::add(SimdOps::mul(newVx, newVx), SimdOps::mul(newVy, newVy)));
+    newVx = SimdOps::mul(SimdOps::div(newVx, magnitude), newSpeed);
+    newVy = SimdOps::mul(SimdOps::div(newVy, magnitude), newSpeed);
+
+    V newX = SimdOps::blend(SimdOps::gt(newVx, SimdOps::set1(0.0f)),
+                            SimdOps::set1(paddleX - diameter - 1),
+                            SimdOps::set1(paddleX + p.paddleWidth + 1));
+
+    x = SimdOps::blend(overlaps, x, newX);
+    vx = SimdOps::blend(overlaps, vx, newVx);
+    vy = SimdOps::blend(overlaps, vy, newVy);
+    speed = SimdOps::blend(overlaps, speed, newSpeed);
+    return overlaps;
+}
+
+// Vector overlap-collision step of lanes [0, end) in SimdOps::width
+// chunks; returns lanes done
+std::size_t stepLanesSimd(BallBatch& balls, const BallBatchParams& p, std::size_t end) {
+    const float diameter = p.radius * 2.0f;
+    const V zero = SimdOps::set1(0.0f);
+    const V fieldHeight = SimdOps::set1(p.fieldHeight);
+
+    std::size_t i = 0;
+    for (; i + SimdOps::width <= end; i += SimdOps::width) {
+        V x = SimdOps::load(&balls.x[i]);
+        V y = SimdOps::load(&balls.y[i]);
+        V vx = SimdOps::load(&balls.vx[i]);
+        V vy = SimdOps::load(&balls.vy[i]);
+        V speed = SimdOps::load(&balls.speed[i]);
+        V dt = SimdOps::load(&balls.dt[i]);
+
+        // Integrate
+        x = SimdOps::add(x, SimdOps::mul(vx, dt));
+        y = SimdOps::add(y, SimdOps::mul(vy, dt));
+
+        // Top/bottom walls (bottom is only tested when the top didn't hit)
+        V hitTop = SimdOps::le(y, zero);
+        y = SimdOps::blend(hitTop, y, zero);
+        V hitBottom = SimdOps::andnot(hitTop, SimdOps::ge(SimdOps::add(y, SimdOps::set1(diameter)), fieldHeight));
+        y = SimdOps::blend(hitBottom, y, SimdOps::set1(p.fieldHeight - diameter));
+        V wallHit = SimdOps::or_(hitTop, hitBottom);
+        vy = SimdOps::blend(wallHit, vy, SimdOps::neg(vy));
+
+        // Paddles, in the same order as Simulation::step
+        V paddleHit = collidePaddle(x, y, vx, vy, speed, SimdOps::load(&balls.paddle1Y[i]), p.paddle1X, p);
+        paddleHit = SimdOps::or_(paddleHit,
+                                 collidePaddle(x, y, vx, vy, speed, SimdOps::load(&balls.paddle2Y[i]), p.paddle2X, p));
+
+        // Scoring
+        V score1 = SimdOps::gt(x, SimdOps::set1(p.fieldWidth));
+        V score2 = SimdOps::andnot(score1, SimdOps::lt(SimdOps::add(x, SimdOps::set1(p.radius * 2)), zero));
+
+        SimdOps::store(&balls.x[i], x);
+        SimdOps::store(&balls.y[i], y);
+        SimdOps::store(&balls.vx[i], vx);
+        SimdOps::store(&balls.vy[i], vy);
+        SimdOps::store(&balls.speed[i], speed);
+
+        int wallBits = SimdOps::movemask(wallHit);
+        int paddleBits = SimdOps::movemask(paddleHit);
+        int score1Bits = SimdOps::movemask(score1);
+        int score2Bits = SimdOps::movemask(score2);
+        for (int lane = 0; lane < SimdOps::width; lane++) {
+            balls.events[i + lane] = static_cast<std::uint8_t>(
+                ((wallBits >> lane) & 1) * BATCH_WALL_HIT | ((paddleBits >> lane) & 1) * BATCH_PADDLE_HIT |
+                ((score1Bits >> lane) & 1) * BATCH_SCORE_P1 | ((score2Bits >> lane) & 1) * BATCH_SCORE_P2);
+        }
+    }
+    return i;
+}
+
+// Vector step for swept collision. In most ticks a ball touches nothing,
+// and then sweepBall just moves it by velocity * dt. A lane whose whole
+// path this tick keeps SWEEP_MARGIN pixels clear of both walls and both
+// paddles is moved that way here - far enough that rounding cannot turn
+// it into a hit - and the rest go through the scalar sweep, so every lane
+// ends up bit-identical to sweepBall.
+std::size_t sweepLanesSimd(BallBatch& balls, const BallBatchParams& p, std::size_t end) {
+    const float SWEEP_MARGIN = 1.0f;
+    const float diameter = p.radius * 2.0f;
+    const V zero = SimdOps::set1(0.0f);
+    const V margin = SimdOps::set1(SWEEP_MARGIN);
+    const V paddleHeight = SimdOps::set1(p.paddleHeight);
+
+    std::size_t i = 0;
+    for (; i + SimdOps::width <= end; i += SimdOps::width) {
+        V x = SimdOps::load(&balls.x[i]);
+        V y = SimdOps::load(&balls.y[i]);
+        V dt = SimdOps::load(&balls.dt[i]);
+        V newX = SimdOps::add(x, SimdOps::mul(SimdOps::load(&balls.vx[i]), dt));
+        V newY = SimdOps::add(y, SimdOps::mul(SimdOps::load(&balls.vy[i]), dt));
+
+        // Box around the ball's whole path this tick
+        V left = SimdOps::min(x, newX);
+        V right = SimdOps::add(SimdOps::max(x, newX), SimdOps::set1(diameter));
+        V top = SimdOps::min(y, newY);
+        V bottom = SimdOps::add(SimdOps::max(y, newY), SimdOps::set1(diameter));
+
+        V clear = SimdOps::and_(SimdOps::gt(top, margin), SimdOps::lt(bottom, SimdOps::set1(p.fieldHeight - SWEEP_MARGIN)));
+        const float paddleXs[2] = {p.paddle1X, p.paddle2X};
+        const float* paddleYs[2] = {&balls.paddle1Y[i], &balls.paddle2Y[i]};
+        for (int paddle = 0; paddle < 2; paddle++) {
+            V paddleTop = SimdOps::sub(SimdOps::load(paddleYs[paddle]), margin);
+            V paddleBottom = SimdOps::add(SimdOps::add(SimdOps::load(paddleYs[paddle]), paddleHeight), margin);
+            V apart = SimdOps::or_(
+                SimdOps::or_(SimdOps::lt(right, SimdOps::set1(paddleXs[paddle] - SWEEP_MARGIN)),
+                             SimdOps::gt(left, SimdOps::set1(paddleXs[paddle] + p.paddleWidth + SWEEP_MARGIN))),
+                SimdOps::or_(SimdOps::lt(bottom, paddleTop), SimdOps::gt(top, paddleBottom)));
+            clear = SimdOps::and_(clear, apart);
+        }
+
+        // Scoring, for the lanes moved here
+        V score1 = SimdOps::gt(newX, SimdOps::set1(p.fieldWidth));
+        V score2 = SimdOps::andnot(score1, SimdOps::lt(SimdOps::add(newX, SimdOps::set1(p.radius * 2)), zero));
+
+        SimdOps::store(&balls.x[i], SimdOps::blend(clear, x, newX));
+        SimdOps::store(&balls.y[i], SimdOps::blend(clear, y, newY));
+
+        int clearBits = SimdOps::movemask(clear);
+        int score1Bits = SimdOps::movemask(score1);
+        int score2Bits = SimdOps::movemask(score2);
+        for (int lane = 0; lane < SimdOps::width; lane++) {
+            if (!(clearBits & (1 << lane))) {
+                stepLaneScalar(balls, p, i + lane);
+                continue;
+            }
+            balls.events[i + lane] = static_cast<std::uint8_t>(((score1Bits >> lane) & 1) * BATCH_SCORE_P1 |
+                                                               ((score2Bits >> lane) & 1) * BATCH_SCORE_P2);
+        }
+    }
+    return i;
+}
+
+// Vector paddle steering of lanes [0, end): the follow decision and the
+// clamped move, both sides of each choice computed and blended
+std::size_t followLanesSimd(BallBatch& balls, const BallBatchParams& p, int player, float deadZone, float deltaTime,
+                            std::size_t end) {
+    float* paddleY = (player == 1) ? balls.paddle1Y.data() : balls.paddle2Y.data();
+    const float* target = (player == 1) ? balls.paddle1Target.data() : balls.paddle2Target.data();
+    const V zero = SimdOps::set1(0.0f);
+    const V halfHeight = SimdOps::set1(p.paddleHeight / 2.0f);
+    const V dead = SimdOps::set1(deadZone);
+    const V distance = SimdOps::set1(p.paddleSpeed * deltaTime);
+    const V maxY = SimdOps::set1(p.fieldHeight - p.paddleHeight);
+
+    std::size_t i = 0;
+    for (; i + SimdOps::width <= end; i += SimdOps::width) {
+        V y = SimdOps::load(paddleY + i);
+        V goal = SimdOps::load(target + i);
+        V center = SimdOps::add(y, halfHeight);
+        V up = SimdOps::gt(center, SimdOps::add(goal, dead));
+        V down = SimdOps::andnot(up, SimdOps::lt(center, SimdOps::sub(goal, dead)));
+
+        V raised = SimdOps::sub(y, distance);
+        raised = SimdOps::blend(SimdOps::ge(raised, zero), zero, raised);
+        V lowered = SimdOps::add(y, distance);
+        lowered = SimdOps::blend(SimdOps::le(lowered, maxY), maxY, lowered);
+
+        y = SimdOps::blend(up, y, raised);
+        y = SimdOps::blend(down, y, lowered);
+        SimdOps::store(paddleY + i, y);
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+namespace batch {
+
+// Reference path
+void stepScalar(BallBatch& balls, const BallBatchParams& params) {
+    stepLanesScalar(balls, params, 0, balls.size());
+}
+
+// Vectorized path; leftover lanes go through the reference code
+void stepSimd(BallBatch& balls, const BallBatchParams& params) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    std::size_t done = params.continuous ? sweepLanesSimd(balls, params, balls.size())
+                                         : stepLanesSimd(balls, params, balls.size());
+    stepLanesScalar(balls, params, done, balls.size());
+#else
+    stepLanesScalar(balls, params, 0, balls.size());
+#endif
+}
+
+// Reference paddle steering
+void followScalar(BallBatch& balls, const BallBatchParams& params, int player, float deadZone, float deltaTime) {
+    followLanesScalar(balls, params, player, deadZone, deltaTime, 0, balls.size());
+}
+
+// Vectorized paddle steering; leftover lanes go through the reference code
+void followSimd(BallBatch& balls, const BallBatchParams& params, int player, float deadZone, float deltaTime) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    std::size_t done = followLanesSimd(balls, params, player, deadZone, deltaTime, balls.size());
+    followLanesScalar(balls, params, player, deadZone, deltaTime, done, balls.size());
+#else
+    followLanesScalar(balls, params, player, deadZone, deltaTime, 0, balls.size());
+#endif
+}
+
+// Instruction set in use
+const char* simdName() {
+#if defined(__AVX2__)
+    return "AVX2 (8 lanes)";
+#elif defined(__SSE2__)
+    return "SSE2 (4 lanes)";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace batch
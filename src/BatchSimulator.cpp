@@ -0,0 +1,492 @@
+#include "BatchSimulator.h"
+#include "BallBatch.h"
+#include "Physics.h"
+#include "Replay.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <iomanip>
+#include <thread>
+
+namespace {
+
+// Bookkeeping for one match living in a SoA lane, touched only when
+// something happens in it (a point, a new match)
+struct LaneMatch {
+    bool active;
+    int score1;
+    int score2;
+    std::uint64_t rally;
+    Random rng;
+};
+
+// One side's paddle controllers for every lane. An AI decision (where to
+// aim) draws on the lane's PaddleAI, but only every reactionTicks; in
+// between, following the target is a vector kernel over the batch.
+struct LaneControllers {
+    ControllerType type;
+    int player;
+    std::vector<PaddleAI> ai;
+    std::vector<int> ticksUntilThink;    // PaddleAI's reaction countdown; its target is in the batch
+
+    // Start a lane's controller over, as a new PaddleAI would be
+    void reset(std::size_t lane, std::uint64_t seed, const PaddleAIConfig& config, BallBatch& balls) {
+        ai[lane] = PaddleAI(type, player, seed, config);
+        ticksUntilThink[lane] = 0;
+        (player == 1 ? balls.paddle1Target : balls.paddle2Target)[lane] = 0.0f;
+    }
+
+    // Decide and apply this tick's input for every lane's paddle
+    void steer(BallBatch& balls, const BallBatchParams& params, const PaddleAIConfig& config, float deltaTime,
+               bool useSimd) {
+        std::vector<float>& paddleY = (player == 1) ? balls.paddle1Y : balls.paddle2Y;
+
+        if (type != ControllerType::AI) {
+            for (std::size_t lane = 0; lane < paddleY.size(); lane++) {
+                PaddleState paddle = balls.getPaddle(lane, player, params);
+                PaddleInput input = ai[lane].think(balls.getBall(lane, params), paddle, params.fieldHeight);
+                physics::updatePaddle(paddle, input, deltaTime, params.fieldHeight);
+                paddleY[lane] = paddle.y;
+            }
+            return;
+        }
+
+        std::vector<float>& target = (player == 1) ? balls.paddle1Target : balls.paddle2Target;
+        for (std::size_t lane = 0; lane < paddleY.size(); lane++) {
+            if (--ticksUntilThink[lane] <= 0) {
+                target[lane] = ai[lane].pickTarget(balls.getBall(lane, params), balls.getPaddle(lane, player, params));
+                ticksUntilThink[lane] = config.reactionTicks;
+            }
+        }
+        if (useSimd) {
+            batch::followSimd(balls, params, player, config.deadZone, deltaTime);
+        } else {
+            batch::followScalar(balls, params, player, config.deadZone, deltaTime);
+        }
+    }
+};
+
+} // namespace
+
+// Matches per wall-clock second
+double BatchReport::matchesPerSecond() const {
+    return elapsedSeconds > 0.0 ? matchesPlayed / elapsedSeconds : 0.0;
+}
+
+// Average paddle hits per point
+double BatchReport::meanRallyLength() const {
+    return totalPoints > 0 ? static_cast<double>(totalPaddleHits) / totalPoints : 0.0;
+}
+
+// Fold another report into this one
+void BatchReport::merge(const BatchReport& other) {
+    matchesPlayed += other.matchesPlayed;
+    unfinishedMatches += other.unfinishedMatches;
+    totalTicks += other.totalTicks;
+    totalPoints += other.totalPoints;
+    totalPaddleHits += other.totalPaddleHits;
+    longestRally = std::max(longestRally, other.longestRally);
+
+    if (scoreCounts.size() < other.scoreCounts.size()) {
+        scoreCounts.resize(other.scoreCounts.size(), 0);
+    }
+    for (size_t i = 0; i < other.scoreCounts.size(); i++) {
+        scoreCounts[i] += other.scoreCounts[i];
+    }
+}
+
+// Constructor
+BatchSimulator::BatchSimulator(const BatchConfig& cfg)
+    : config(cfg) {
+}
+
+// Play one match to completion and record it
+void BatchSimulator::playMatch(int matchIndex, BatchReport& report) const {
+    // Seeded per match so a match plays the same whichever worker runs it
+    std::uint64_t seed = Random::deriveSeed(config.seed, static_cast<std::uint64_t>(matchIndex));
+    Simulation simulation(config.simulation);
+    simulation.resetMatch(seed);
+    PaddleAI ai1(config.player1, 1, seed, config.ai);
+    PaddleAI ai2(config.player2, 2, seed, config.ai);
+
+    float dt = simulation.getTickDuration();
+    std::uint64_t rally = 0;
+
+    while (!simulation.getState().matchOver && simulation.getState().tick < config.maxTicksPerMatch) {
+        SimulationInput input;
+        input.player1 = ai1.think(simulation.getState(), config.simulation);
+        input.player2 = ai2.think(simulation.getState(), config.simulation);
+
+        StepResult result = simulation.step(input, dt);
+        if (result.paddleHit) {
+            report.totalPaddleHits++;
+            rally++;
+        }
+        if (result.scorer != 0) {
+            report.totalPoints++;
+            report.longestRally = std::max(report.longestRally, rally);
+            rally = 0;
+        }
+    }
+
+    const SimulationState& state = simulation.getState();
+    report.totalTicks += state.tick;
+    if (!state.matchOver) {
+        report.unfinishedMatches++;
+        return;
+    }
+
+    report.matchesPlayed++;
+    report.scoreCounts[state.score1 * (report.maxScore + 1) + state.score2]++;
+}
+
+// Play one match exactly like playMatch, recording every tick
+bool BatchSimulator::recordMatch(int matchIndex, const std::string& path) const {
+    std::uint64_t seed = Random::deriveSeed(config.seed, static_cast<std::uint64_t>(matchIndex));
+    Simulation simulation(config.simulation);
+    simulation.resetMatch(seed);
+    PaddleAI ai1(config.player1, 1, seed, config.ai);
+    PaddleAI ai2(config.player2, 2, seed, config.ai);
+
+    ReplayRecorder recorder;
+    recorder.start(config.simulation, seed, "AI 1", "AI 2");
+
+    float dt = simulation.getTickDuration();
+    while (!simulation.getState().matchOver && simulation.getState().tick < config.maxTicksPerMatch) {
+        SimulationInput input;
+        input.player1 = ai1.think(simulation.getState(), config.simulation);
+        input.player2 = ai2.think(simulation.getState(), config.simulation);
+        recorder.record(input);
+        simulation.step(input, dt);
+    }
+
+    return recorder.save(path, simulation.getState());
+}
+
+// Play matches lane by lane in a structure-of-arrays batch until none are
+// left. Everything that runs every tick - controllers, paddles, ball,
+// countdowns, the event scan - is a pass over plain lane arrays; per-match
+// bookkeeping only runs for the lanes where something happened.
+void BatchSimulator::playMatchesSoa(std::atomic<int>& nextMatch, BatchReport& report) const {
+    const SimulationConfig& sim = config.simulation;
+    const BallBatchParams params = BallBatchParams::fromConfig(sim);
+    const float tickDt = 1.0f / static_cast<float>(sim.tickRate);
+    const std::size_t laneCount = static_cast<std::size_t>(std::max(1, config.lanesPerWorker));
+
+    BallBatch balls;
+    balls.resize(laneCount);
+    std::vector<LaneMatch> lanes(laneCount);
+    std::vector<std::uint8_t> countingDown(laneCount, 0);
+    std::vector<float> countdownTimer(laneCount, 0.0f);
+    std::vector<int> countdownNumber(laneCount, 0);
+    std::vector<std::uint64_t> startTick(laneCount, 0);   // Batch tick the lane's match began at
+
+    LaneControllers controllers[2];
+    for (int side = 0; side < 2; side++) {
+        LaneControllers& controller = controllers[side];
+        controller.type = (side == 0) ? config.player1 : config.player2;
+        controller.player = side + 1;
+        controller.ai.assign(laneCount, PaddleAI(controller.type, controller.player, 0u, config.ai));
+        controller.ticksUntilThink.assign(laneCount, 0);
+    }
+
+    std::uint64_t tick = 0;
+
+    // Serve the ball and start the countdown, like Simulation::resetRound
+    auto resetRound = [&](std::size_t lane) {
+        BallState ball = balls.getBall(lane, params);
+        physics::resetBall(ball, sim.fieldWidth, sim.fieldHeight, lanes[lane].rng);
+        balls.setBall(lane, ball);
+        balls.dt[lane] = 0.0f;
+        countingDown[lane] = 1;
+        countdownTimer[lane] = 1.0f;
+        countdownNumber[lane] = 3;
+    };
+
+    // Pull the next match into a lane, or park the lane when the batch is done
+    auto startMatch = [&](std::size_t lane) {
+        int index = nextMatch.fetch_add(1, std::memory_order_relaxed);
+        LaneMatch& match = lanes[lane];
+        match.active = index < config.matches;
+        balls.dt[lane] = 0.0f;
+        countingDown[lane] = 0;
+        if (!match.active) {
+            return;
+        }
+
+        // Seeded like playMatch; with the kernels stepping the same collision
+        // mode as Simulation::step, both modes play identical matches
+        std::uint64_t seed = Random::deriveSeed(config.seed, static_cast<std::uint64_t>(index));
+        controllers[0].reset(lane, seed, config.ai, balls);
+        controllers[1].reset(lane, seed, config.ai, balls);
+        match.rng.seed(seed);
+
+        match.score1 = 0;
+        match.score2 = 0;
+        match.rally = 0;
+        startTick[lane] = tick;
+        balls.paddle1Y[lane] = sim.paddleStartY;
+        balls.paddle2Y[lane] = sim.paddleStartY;
+        resetRound(lane);
+    };
+
+    std::size_t activeLanes = 0;
+    for (std::size_t lane = 0; lane < laneCount; lane++) {
+        startMatch(lane);
+        activeLanes += lanes[lane].active ? 1 : 0;
+    }
+
+    while (activeLanes > 0) {
+        // Inputs and paddles; parked lanes steer too, harmlessly
+        controllers[0].steer(balls, params, config.ai, tickDt, config.useSimd);
+        controllers[1].steer(balls, params, config.ai, tickDt, config.useSimd);
+
+        // Ball physics for every lane at once
+        if (config.useSimd) {
+            batch::stepSimd(balls, params);
+        } else {
+            batch::stepScalar(balls, params);
+        }
+        tick++;
+
+        // Countdowns. The ball stays frozen for the whole tick in which the
+        // countdown runs, so it only gets its dt back for the next one.
+        for (std::size_t lane = 0; lane < laneCount; lane++) {
+            if (countingDown[lane]) {
+                bool counting = true;
+                physics::updateCountdown(counting, countdownTimer[lane], countdownNumber[lane], tickDt);
+                countingDown[lane] = counting ? 1 : 0;
+                balls.dt[lane] = counting ? 0.0f : tickDt;
+                balls.events[lane] = 0;
+            }
+        }
+
+        // Events, scoring and match turnover, for the few lanes that need it
+        for (std::size_t lane = 0; lane < laneCount; lane++) {
+            std::uint8_t events = balls.events[lane];
+            std::uint64_t matchTicks = tick - startTick[lane];
+            if (events == 0 && matchTicks < config.maxTicksPerMatch) {
+                continue;
+            }
+            LaneMatch& match = lanes[lane];
+            if (!match.active) {
+                continue;
+            }
+
+            if (events & BATCH_PADDLE_HIT) {
+                report.totalPaddleHits++;
+                match.rally++;
+            }
+
+            int scorer = (events & BATCH_SCORE_P1) ? 1 : (events & BATCH_SCORE_P2) ? 2 : 0;
+            if (scorer != 0) {
+                (scorer == 1 ? match.score1 : match.score2)++;
+                report.totalPoints++;
+                report.longestRally = std::max(report.longestRally, match.rally);
+                match.rally = 0;
+
+                if (match.score1 >= sim.maxScore || match.score2 >= sim.maxScore) {
+                    report.totalTicks += matchTicks;
+                    report.matchesPlayed++;
+                    report.scoreCounts[match.score1 * (report.maxScore + 1) + match.score2]++;
+                    startMatch(lane);
+                    activeLanes -= match.active ? 0 : 1;
+                    continue;
+                }
+                resetRound(lane);
+            }
+
+            if (matchTicks >= config.maxTicksPerMatch) {
+                report.totalTicks += matchTicks;
+                report.unfinishedMatches++;
+                startMatch(lane);
+                activeLanes -= match.active ? 0 : 1;
+            }
+        }
+    }
+}
+
+// Run the batch on a pool of workers
+BatchReport BatchSimulator::run() const {
+    int threadCount = config.threads;
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min(threadCount, std::max(1, config.matches));
+
+    BatchReport empty;
+    empty.maxScore = config.simulation.maxScore;
+    empty.scoreCounts.assign((empty.maxScore + 1) * (empty.maxScore + 1), 0);
+
+    // One report per worker, merged after join
+    std::vector<BatchReport> workerReports(threadCount, empty);
+    std::atomic<int> nextMatch(0);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([this, t, &nextMatch, &workerReports]() {
+            if (config.useSoa) {
+                playMatchesSoa(nextMatch, workerReports[t]);
+                return;
+            }
+
+            int index;
+            while ((index = nextMatch.fetch_add(1, std::memory_order_relaxed)) < config.matches) {
+                playMatch(index, workerReports[t]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    BatchReport report = empty;
+    for (const auto& workerReport : workerReports) {
+        report.merge(workerReport);
+    }
+    report.threadsUsed = threadCount;
+    report.elapsedSeconds = std::chrono::duration<double>(end - start).count();
+    return report;
+}
+
+// Compare the vector kernels with the scalar reference, for both kinds of collision
+bool BatchSimulator::verifySimd(const SimulationConfig& config, int lanes, int steps, std::uint64_t seed, std::ostream& out) {
+    for (bool continuous : {false, true}) {
+        SimulationConfig mode = config;
+        mode.continuousCollision = continuous;
+        if (!verifySimdMode(mode, lanes, steps, seed, out)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Compare the kernels for the collision mode in config
+bool BatchSimulator::verifySimdMode(const SimulationConfig& config, int lanes, int steps, std::uint64_t seed,
+                                    std::ostream& out) {
+    const BallBatchParams params = BallBatchParams::fromConfig(config);
+    const float tickDt = 1.0f / static_cast<float>(config.tickRate);
+    Random rng(seed);
+    auto unit = [&rng]() { return rng.nextFloat(); };
+
+    // Random serve anywhere on the field, biased toward walls and paddles
+    auto randomize = [&](BallBatch& balls, std::size_t lane) {
+        float speed = config.ballSpeed * (1.0f + unit() * (config.maxSpeedFactor - 1.0f));
+        float angle = (unit() * 2.0f - 1.0f) * 1.3f;
+        float direction = unit() < 0.5f ? -1.0f : 1.0f;
+        balls.x[lane] = -20.0f + unit() * (config.fieldWidth + 40.0f);
+        balls.y[lane] = -5.0f + unit() * (config.fieldHeight + 10.0f);
+        balls.vx[lane] = direction * speed * std::cos(angle);
+        balls.vy[lane] = speed * std::sin(angle);
+        balls.speed[lane] = speed;
+        balls.paddle1Y[lane] = unit() * (config.fieldHeight - config.paddleHeight);
+        balls.paddle2Y[lane] = unit() * (config.fieldHeight - config.paddleHeight);
+        balls.dt[lane] = unit() < 0.1f ? tickDt * 8.0f : tickDt;
+    };
+
+    BallBatch reference;
+    reference.resize(static_cast<std::size_t>(lanes));
+    for (std::size_t lane = 0; lane < reference.size(); lane++) {
+        randomize(reference, lane);
+    }
+    BallBatch vectorized = reference;
+
+    // Paddles chase targets near the ball, re-aimed now and then like the AI's
+    const float deadZone = PaddleAIConfig().deadZone;
+    std::uint64_t hits = 0;
+    for (int step = 0; step < steps; step++) {
+        for (std::size_t lane = 0; lane < reference.size(); lane++) {
+            if (unit() < 0.125f) {
+                float& target = (unit() < 0.5f) ? reference.paddle1Target[lane] : reference.paddle2Target[lane];
+                target = reference.y[lane] + config.ballRadius + (unit() * 2.0f - 1.0f) * 60.0f;
+            }
+        }
+        vectorized.paddle1Target = reference.paddle1Target;
+        vectorized.paddle2Target = reference.paddle2Target;
+        for (int player = 1; player <= 2; player++) {
+            batch::followScalar(reference, params, player, deadZone, tickDt);
+            batch::followSimd(vectorized, params, player, deadZone, tickDt);
+        }
+
+        batch::stepScalar(reference, params);
+        batch::stepSimd(vectorized, params);
+
+        bool same = reference.events == vectorized.events &&
+                    std::memcmp(reference.x.data(), vectorized.x.data(), reference.x.size() * sizeof(float)) == 0 &&
+                    std::memcmp(reference.y.data(), vectorized.y.data(), reference.y.size() * sizeof(float)) == 0 &&
+                    std::memcmp(reference.vx.data(), vectorized.vx.data(), reference.vx.size() * sizeof(float)) == 0 &&
+                    std::memcmp(reference.vy.data(), vectorized.vy.data(), reference.vy.size() * sizeof(float)) == 0 &&
+                    std::memcmp(reference.speed.data(), vectorized.speed.data(), reference.speed.size() * sizeof(float)) == 0 &&
+                    std::memcmp(reference.paddle1Y.data(), vectorized.paddle1Y.data(), reference.paddle1Y.size() * sizeof(float)) == 0 &&
+                    std::memcmp(reference.paddle2Y.data(), vectorized.paddle2Y.data(), reference.paddle2Y.size() * sizeof(float)) == 0;
+        if (!same) {
+            out << "MISMATCH at step " << step << " (" << batch::simdName() << ", "
+                << (config.continuousCollision ? "swept" : "overlap") << " collision)" << std::endl;
+            return false;
+        }
+
+        // Re-serve balls that left the field so collisions keep happening
+        for (std::size_t lane = 0; lane < reference.size(); lane++) {
+            std::uint8_t events = reference.events[lane];
+            hits += (events & (BATCH_WALL_HIT | BATCH_PADDLE_HIT)) ? 1 : 0;
+            if (events & (BATCH_SCORE_P1 | BATCH_SCORE_P2)) {
+                randomize(reference, lane);
+                vectorized.x[lane] = reference.x[lane];
+                vectorized.y[lane] = reference.y[lane];
+                vectorized.vx[lane] = reference.vx[lane];
+                vectorized.vy[lane] = reference.vy[lane];
+                vectorized.speed[lane] = reference.speed[lane];
+                vectorized.paddle1Y[lane] = reference.paddle1Y[lane];
+                vectorized.paddle2Y[lane] = reference.paddle2Y[lane];
+                vectorized.dt[lane] = reference.dt[lane];
+            }
+        }
+    }
+
+    out << "OK: " << lanes << " lanes x " << steps << " steps bit-identical (" << batch::simdName() << ", "
+        << (config.continuousCollision ? "swept" : "overlap") << " collision, " << hits << " wall/paddle hits)"
+        << std::endl;
+    return true;
+}
+
+// Print a summary of the batch
+void BatchSimulator::printReport(const BatchReport& report, const BatchConfig& config, std::ostream& out) {
+    int total = report.matchesPlayed + report.unfinishedMatches;
+    double simSeconds = static_cast<double>(report.totalTicks) / config.simulation.tickRate;
+
+    out << std::fixed << std::setprecision(2);
+    out << "Matches:          " << report.matchesPlayed << " finished, "
+        << report.unfinishedMatches << " unfinished" << std::endl;
+    out << "Threads:          " << report.threadsUsed << std::endl;
+    if (config.useSoa) {
+        out << "Mode:             SoA, " << config.lanesPerWorker << " lanes/worker, "
+            << (config.useSimd ? batch::simdName() : "scalar reference") << std::endl;
+    } else {
+        out << "Mode:             one Simulation per match" << std::endl;
+    }
+    out << "Wall time:        " << report.elapsedSeconds << " s" << std::endl;
+    out << "Matches/sec:      " << report.matchesPerSecond() << std::endl;
+    out << "Ticks/sec:        " << (report.elapsedSeconds > 0.0 ? report.totalTicks / report.elapsedSeconds : 0.0) << std::endl;
+    out << "Mean match time:  " << (total > 0 ? simSeconds / total : 0.0) << " s (simulated)" << std::endl;
+    out << "Mean rally:       " << report.meanRallyLength() << " hits/point" << std::endl;
+    out << "Longest rally:    " << report.longestRally << " hits" << std::endl;
+
+    out << "\nFinal score distribution:" << std::endl;
+    int side = report.maxScore + 1;
+    for (int s1 = 0; s1 < side; s1++) {
+        for (int s2 = 0; s2 < side; s2++) {
+            std::uint64_t count = report.scoreCounts[s1 * side + s2];
+            if (count == 0) {
+                continue;
+            }
+            double percent = report.matchesPlayed > 0 ? 100.0 * count / report.matchesPlayed : 0.0;
+            out << "  " << s1 << " - " << s2 << ": " << count << " (" << percent << "%)" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,234 @@
+#include "BinaryProfileStore.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = { 'P', 'O', 'N', 'G', 'P', 'R', 'F', '\0' };
+const std::uint32_t VERSION = 2;          // 2 added the rating; version 1 files still open
+const std::uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t recordSize;
+    std::uint32_t reserved;
+    std::uint64_t recordCount;
+    std::uint64_t generation;
+    std::uint64_t lastSequence;
+    std::uint64_t recordsOffset;
+    std::uint64_t stringsOffset;
+    std::uint64_t stringsSize;
+};
+
+struct FileRecord {
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    std::int32_t wins;
+    std::int32_t losses;
+    std::int32_t totalGames;
+    std::int32_t rating;          // Unused (0) in version 1
+};
+
+static_assert(sizeof(FileHeader) == 72, "profile store header layout changed");
+static_assert(sizeof(FileRecord) == 24, "profile store record layout changed");
+
+} // namespace
+
+// Constructor
+BinaryProfileStore::BinaryProfileStore()
+    : data(nullptr), dataSize(0), mapping(nullptr), version(0), count(0), generation(0), lastSequence(0),
+      records(nullptr), strings(nullptr), stringsSize(0) {
+}
+
+// Destructor
+BinaryProfileStore::~BinaryProfileStore() {
+    close();
+}
+
+// Map (or read) a store file
+bool BinaryProfileStore::open(const std::string& path) {
+    close();
+    
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    dataSize = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    dataSize = static_cast<std::size_t>(info.st_size);
+    void* address = ::mmap(nullptr, dataSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (address == MAP_FAILED) {
+        dataSize = 0;
+        return false;
+    }
+    mapping = address;
+    data = static_cast<const unsigned char*>(address);
+#endif
+    
+    if (!validate()) {
+        std::cerr << "Not a valid profile store: " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Check the header and that every section lies inside the file
+bool BinaryProfileStore::validate() {
+    if (dataSize < sizeof(FileHeader)) {
+        return false;
+    }
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || (header.version != 1 && header.version != VERSION) ||
+        header.byteOrder != BYTE_ORDER_MARK || header.recordSize != sizeof(FileRecord)) {
+        return false;
+    }
+    if (header.recordsOffset > dataSize ||
+        header.recordCount > (dataSize - header.recordsOffset) / sizeof(FileRecord) ||
+        header.stringsOffset > dataSize || header.stringsSize > dataSize - header.stringsOffset) {
+        return false;
+    }
+    
+    version = header.version;
+    count = static_cast<std::size_t>(header.recordCount);
+    generation = header.generation;
+    lastSequence = header.lastSequence;
+    records = data + header.recordsOffset;
+    strings = reinterpret_cast<const char*>(data + header.stringsOffset);
+    stringsSize = header.stringsSize;
+    return true;
+}
+
+// Unmap and forget the file
+void BinaryProfileStore::close() {
+#ifndef _WIN32
+    if (mapping) {
+        ::munmap(mapping, dataSize);
+    }
+#endif
+    mapping = nullptr;
+    buffer.clear();
+    buffer.shrink_to_fit();
+    data = nullptr;
+    dataSize = 0;
+    version = 0;
+    count = 0;
+    generation = 0;
+    lastSequence = 0;
+    records = nullptr;
+    strings = nullptr;
+    stringsSize = 0;
+}
+
+// Name of a record (empty if its string reference is out of range)
+std::string_view BinaryProfileStore::nameAt(std::size_t index) const {
+    FileRecord record;
+    std::memcpy(&record, records + index * sizeof(FileRecord), sizeof(record));
+    if (record.nameOffset > stringsSize || record.nameLength > stringsSize - record.nameOffset) {
+        return std::string_view();
+    }
+    return std::string_view(strings + record.nameOffset, record.nameLength);
+}
+
+// Copy a record out as a UserProfile
+UserProfile BinaryProfileStore::profileAt(std::size_t index) const {
+    FileRecord record;
+    std::memcpy(&record, records + index * sizeof(FileRecord), sizeof(record));
+    
+    UserProfile profile(std::string(nameAt(index)));
+    profile.wins = record.wins;
+    profile.losses = record.losses;
+    profile.totalGames = record.totalGames;
+    profile.rating = version >= 2 ? record.rating : UserProfile::INITIAL_RATING;
+    return profile;
+}
+
+// Binary search over the sorted records
+bool BinaryProfileStore::find(std::string_view name, std::size_t& index) const {
+    index = lowerBound(name);
+    return index < count && nameAt(index) == name;
+}
+
+// First record whose name is not less than the given one
+std::size_t BinaryProfileStore::lowerBound(std::string_view name) const {
+    std::size_t low = 0;
+    std::size_t high = count;
+    while (low < high) {
+        std::size_t mid = low + (high - low) / 2;
+        if (nameAt(mid) < name) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Serialize a snapshot into the store layout
+std::string BinaryProfileStore::encode(const ProfileSnapshot& snapshot) {
+    std::uint64_t stringsSize = 0;
+    for (const UserProfile& profile : snapshot.profiles) {
+        stringsSize += profile.username.size();
+    }
+    
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.recordSize = sizeof(FileRecord);
+    header.reserved = 0;
+    header.recordCount = snapshot.profiles.size();
+    header.generation = snapshot.generation;
+    header.lastSequence = snapshot.lastSequence;
+    header.recordsOffset = sizeof(FileHeader);
+    header.stringsOffset = header.recordsOffset + header.recordCount * sizeof(FileRecord);
+    header.stringsSize = stringsSize;
+    
+    std::string image(static_cast<std::size_t>(header.stringsOffset + stringsSize), '\0');
+    std::memcpy(&image[0], &header, sizeof(header));
+    
+    std::uint32_t nameOffset = 0;
+    char* recordOut = &image[static_cast<std::size_t>(header.recordsOffset)];
+    char* stringOut = &image[static_cast<std::size_t>(header.stringsOffset)];
+    for (const UserProfile& profile : snapshot.profiles) {
+        FileRecord record;
+        record.nameOffset = nameOffset;
+        record.nameLength = static_cast<std::uint32_t>(profile.username.size());
+        record.wins = profile.wins;
+        record.losses = profile.losses;
+        record.totalGames = profile.totalGames;
+        record.rating = profile.rating;
+        std::memcpy(recordOut, &record, sizeof(record));
+        recordOut += sizeof(record);
+        
+        std::memcpy(stringOut + nameOffset, profile.username.data(), profile.username.size());
+        nameOffset += record.nameLength;
+    }
+    return image;
+}
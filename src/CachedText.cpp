@@ -0,0 +1,62 @@
+#include "CachedText.h"
+
+// Constructor
+CachedText::CachedText()
+    : number(0), showingNumber(false), color(sf::Color::White) {
+}
+
+// Set font, size and color
+void CachedText::setStyle(const sf::Font& font, unsigned size, const sf::Color& fillColor) {
+    text.setFont(font);
+    text.setCharacterSize(size);
+    color = fillColor;
+    text.setFillColor(color);
+}
+
+// Set the displayed string if it differs
+bool CachedText::setString(const std::string& newValue) {
+    if (!showingNumber && newValue == value) {
+        return false;
+    }
+    showingNumber = false;
+    value = newValue;
+    text.setString(value);
+    return true;
+}
+
+// Set the displayed number if it differs (no formatting when unchanged)
+bool CachedText::setNumber(long newNumber) {
+    if (showingNumber && newNumber == number) {
+        return false;
+    }
+    showingNumber = true;
+    number = newNumber;
+    value = std::to_string(number);
+    text.setString(value);
+    return true;
+}
+
+// Lay the characters out once, then restore the current string
+void CachedText::preloadGlyphs(const std::string& characters) {
+    text.setString(characters);
+    text.getLocalBounds();
+    text.setString(value);
+}
+
+// Set the fill color if it differs
+void CachedText::setFillColor(const sf::Color& fillColor) {
+    if (fillColor != color) {
+        color = fillColor;
+        text.setFillColor(color);
+    }
+}
+
+// Set position
+void CachedText::setPosition(float x, float y) {
+    text.setPosition(x, y);
+}
+
+// Draw the text
+void CachedText::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    target.draw(text, states);
+}
@@ -0,0 +1,176 @@
+#include "ClientPrediction.h"
+#include "NetProtocol.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const std::uint64_t NO_TICK = ~0ULL;
+
+bool sameInput(const PaddleInput& a, const PaddleInput& b) {
+    return a.up == b.up && a.down == b.down;
+}
+
+// Bit-exact comparison, over exactly the fields a snapshot carries
+bool sameState(const SimulationState& a, const SimulationState& b) {
+    std::uint32_t wordsA[net::STATE_WORDS];
+    std::uint32_t wordsB[net::STATE_WORDS];
+    net::packState(a, wordsA);
+    net::packState(b, wordsB);
+    return std::equal(wordsA, wordsA + net::STATE_WORDS, wordsB);
+}
+
+} // namespace
+
+// Constructor
+ClientPrediction::ClientPrediction(const SimulationConfig& simulationConfig, int player,
+                                   const PredictionConfig& predictionConfig)
+    : config(predictionConfig), simulation(simulationConfig), localPlayer(player),
+      frames(static_cast<std::size_t>(std::max(predictionConfig.rollbackWindow, 0) + 1)), started(false),
+      syncTick(NO_TICK), pendingAdjustment(0) {
+}
+
+// Check our prediction of the snapshot's tick and replay from it if wrong
+void ClientPrediction::reconcile(const SimulationState& authoritative, const SimulationInput& stepInputs,
+                                 std::uint32_t inputTick) {
+    PONG_TRACE_SCOPE("ClientPrediction::reconcile");
+    stats.snapshotsChecked++;
+    PaddleInput remote = (localPlayer == 1) ? stepInputs.player2 : stepInputs.player1;
+    remoteInput = remote;
+    if (!started) {
+        restart(authoritative);
+        return;
+    }
+
+    std::uint64_t tick = authoritative.tick;
+    std::uint64_t current = getTick();
+    checkInputMargin(tick, inputTick);
+
+    // Ahead of us (we are only starting, or fell behind): jump forward to it
+    if (tick > current) {
+        stats.resyncs++;
+        restart(authoritative);
+        return;
+    }
+
+    // Ticks since the snapshot were stepped with a guess of the opponent
+    // that the snapshot may have just proved wrong
+    bool inWindow = current - tick <= static_cast<std::uint64_t>(config.rollbackWindow) &&
+                    (tick == current || frameFor(tick).tick == tick);
+    if (inWindow) {
+        bool guessedRight = true;
+        for (std::uint64_t t = tick; t < current; t++) {
+            guessedRight = guessedRight && sameInput(frameFor(t).remote, remote);
+        }
+        const SimulationState& predicted = (tick == current) ? simulation.getState() : frameFor(tick).state;
+        if (guessedRight && sameState(predicted, authoritative)) {
+            return;
+        }
+        stats.mispredictions++;
+    } else {
+        stats.fullReplays++;
+    }
+
+    const SimulationState before = simulation.getState();
+    replay(authoritative, current);
+
+    int depth = static_cast<int>(current - tick);
+    stats.ticksResimulated += static_cast<std::uint64_t>(depth);
+    stats.deepestRollback = std::max(stats.deepestRollback, depth);
+
+    const SimulationState& after = simulation.getState();
+    const PaddleState& paddleBefore = (localPlayer == 1) ? before.paddle1 : before.paddle2;
+    const PaddleState& paddleAfter = (localPlayer == 1) ? after.paddle1 : after.paddle2;
+    if (paddleBefore.y != paddleAfter.y) {
+        stats.localCorrections++;
+    }
+    float jump = std::hypot(after.ball.x - before.ball.x, after.ball.y - before.ball.y);
+    stats.largestBallCorrection = std::max(stats.largestBallCorrection, jump);
+}
+
+// Restore an authoritative state and re-simulate up to the present with our
+// recorded inputs. Ticks older than the window have none left; they reuse
+// our latest input and are not kept (their slots hold newer ticks).
+void ClientPrediction::replay(const SimulationState& authoritative, std::uint64_t current) {
+    simulation.restoreState(authoritative);
+    for (std::uint64_t t = authoritative.tick; t < current; t++) {
+        Frame& frame = frameFor(t);
+        PaddleInput local = (frame.tick == t) ? frame.local : latestLocal;
+        if (t + frames.size() > current) {
+            frame.tick = t;
+            frame.state = simulation.getState();
+            frame.local = local;
+            frame.remote = remoteInput;
+        }
+        SimulationInput input;
+        input.player1 = (localPlayer == 1) ? local : remoteInput;
+        input.player2 = (localPlayer == 1) ? remoteInput : local;
+        simulation.step(input, simulation.getTickDuration());
+    }
+}
+
+// Continue from an authoritative state with nothing to roll back to
+void ClientPrediction::restart(const SimulationState& authoritative) {
+    simulation.restoreState(authoritative);
+    for (Frame& frame : frames) {
+        frame.tick = NO_TICK;
+    }
+    started = true;
+}
+
+// Compare our input's margin with the target; a margin measured with input
+// sent before the last adjustment says nothing new, so it is skipped
+void ClientPrediction::checkInputMargin(std::uint64_t serverTick, std::uint32_t inputTick) {
+    if (inputTick == net::NO_TICK || (syncTick != NO_TICK && inputTick < syncTick)) {
+        return;
+    }
+
+    long long margin = static_cast<long long>(inputTick) - static_cast<long long>(serverTick);
+    if (margin < config.inputMargin) {
+        // Late: catch up in one go, enough to land in the middle of the band
+        long long deficit = config.inputMargin + config.marginSlack / 2 - margin;
+        pendingAdjustment = static_cast<int>(std::min<long long>(deficit, config.rollbackWindow));
+        syncTick = getTick();
+    } else if (margin > config.inputMargin + config.marginSlack) {
+        // Early: back off a tick at a time, which is barely visible
+        pendingAdjustment = -1;
+        syncTick = getTick();
+    }
+}
+
+// Apply a pending clock adjustment to this frame's tick count
+int ClientPrediction::adjustSteps(int steps) {
+    if (!started) {
+        return 0;
+    }
+    if (pendingAdjustment > 0) {
+        steps += pendingAdjustment;
+        stats.ticksAdded += static_cast<std::uint64_t>(pendingAdjustment);
+        pendingAdjustment = 0;
+    } else if (pendingAdjustment < 0 && steps > 0) {
+        steps--;
+        stats.ticksDropped++;
+        pendingAdjustment++;
+    }
+    return steps;
+}
+
+// Save where this tick starts, then step it with our input and our guess
+StepResult ClientPrediction::advance(const PaddleInput& local) {
+    if (!started) {
+        return StepResult();
+    }
+    Frame& frame = frameFor(getTick());
+    frame.tick = getTick();
+    frame.state = simulation.getState();
+    frame.local = local;
+    frame.remote = remoteInput;
+    latestLocal = local;
+
+    SimulationInput input;
+    input.player1 = (localPlayer == 1) ? local : remoteInput;
+    input.player2 = (localPlayer == 1) ? remoteInput : local;
+    stats.ticksPredicted++;
+    return simulation.step(input, simulation.getTickDuration());
+}
@@ -0,0 +1,107 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Nearest-rank percentile; reorders values
+float percentile(float* values, std::size_t count, float fraction) {
+    std::size_t rank = static_cast<std::size_t>(std::ceil(fraction * count));
+    std::size_t index = rank > 0 ? rank - 1 : 0;
+    std::nth_element(values, values + index, values + count);
+    return values[index];
+}
+
+// p50, p99 and max of a set of timings
+FrameProfiler::Stats statsOf(float* values, std::size_t count) {
+    FrameProfiler::Stats stats;
+    if (count == 0) {
+        return stats;
+    }
+    stats.max = *std::max_element(values, values + count);
+    stats.p99 = percentile(values, count, 0.99f);
+    stats.p50 = percentile(values, count, 0.50f);
+    return stats;
+}
+
+} // namespace
+
+// Constructor
+FrameProfiler::FrameProfiler() : frames(), published(0), current() {
+    frameStart = phaseStart = Clock::now();
+}
+
+// Start timing a frame
+void FrameProfiler::beginFrame() {
+    current = Frame();
+    frameStart = phaseStart = Clock::now();
+}
+
+// Charge the time since the previous boundary to a phase
+void FrameProfiler::endPhase(Phase phase) {
+    Clock::time_point now = Clock::now();
+    current.phaseMs[phase] += std::chrono::duration<float, std::milli>(now - phaseStart).count();
+    phaseStart = now;
+}
+
+// Finish the frame and publish it to the ring
+void FrameProfiler::endFrame() {
+    current.totalMs = std::chrono::duration<float, std::milli>(Clock::now() - frameStart).count();
+
+    std::uint64_t index = published.load(std::memory_order_relaxed);
+    frames[index % CAPACITY] = current;
+    published.store(index + 1, std::memory_order_release);
+}
+
+// Copy the newest frames. The slot after the newest may be mid-write, so at
+// most CAPACITY - 1 frames are taken, and any the writer lapped during the
+// copy are dropped afterwards.
+std::size_t FrameProfiler::copyRecent(Frame* out, std::size_t maxFrames) const {
+    std::uint64_t end = published.load(std::memory_order_acquire);
+    std::uint64_t count = std::min<std::uint64_t>({ maxFrames, end, CAPACITY - 1 });
+    std::uint64_t first = end - count;
+    for (std::uint64_t i = 0; i < count; i++) {
+        out[i] = frames[(first + i) % CAPACITY];
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::uint64_t after = published.load(std::memory_order_relaxed);
+    std::uint64_t oldestIntact = after + 1 > CAPACITY ? after + 1 - CAPACITY : 0;
+    if (oldestIntact > first) {
+        std::uint64_t lost = std::min(count, oldestIntact - first);
+        std::copy(out + lost, out + count, out);
+        count -= lost;
+    }
+    return static_cast<std::size_t>(count);
+}
+
+// Percentiles of the whole frame and of each phase
+std::size_t FrameProfiler::summarize(Stats& total, Stats (&phases)[PHASE_COUNT]) const {
+    Frame recent[CAPACITY];
+    float values[CAPACITY];
+    std::size_t count = copyRecent(recent, CAPACITY);
+
+    for (std::size_t i = 0; i < count; i++) {
+        values[i] = recent[i].totalMs;
+    }
+    total = statsOf(values, count);
+
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        for (std::size_t i = 0; i < count; i++) {
+            values[i] = recent[i].phaseMs[phase];
+        }
+        phases[phase] = statsOf(values, count);
+    }
+    return count;
+}
+
+// Short label for each phase
+const char* FrameProfiler::phaseName(Phase phase) {
+    switch (phase) {
+        case EVENTS:  return "events";
+        case UPDATE:  return "update";
+        case RENDER:  return "render";
+        case DISPLAY: return "display";
+        default:      return "";
+    }
+}
@@ -1,20 +1,40 @@
 #include "Game.h"
+#include "Trace.h"
 #include <iostream>
+#include <random>
+#include <stdexcept>
 
 // Constructor
-Game::Game() 
-    : score1(0), score2(0), maxScore(5), currentState(GameState::MENU),
-      isCountingDown(false), countdownTimer(0.0f), countdownNumber(3) {
+Game::Game(const GameOptions& gameOptions) 
+    : options(gameOptions), matchesStarted(0), currentState(GameState::MENU),
+      timestep(simulation.getTickDuration()), hitsHeard(0), pointsHeard(0), isReplaying(false), isOnline(false),
+      profileManager(options.profileStore),
+      allocationStats(static_cast<std::size_t>(GameState::EXIT) + 1), playingTime(0.0f), allocationFailures(0),
+      showProfiler(false), frameKeyChange(0) {
+    
+    // Load the replay first so a bad file fails before the window opens
+    if (!options.replayPath.empty() && !replayPlayer.load(options.replayPath)) {
+        throw std::runtime_error("Could not load replay: " + options.replayPath);
+    }
     
     initWindow();
     initGame();
     initUI();
     loadResources();
+    
+    if (!options.replayPath.empty()) {
+        startReplay();
+    } else if (!options.connectHost.empty()) {
+        startOnline();
+    }
 }
 
 // Destructor
 Game::~Game() {
-    // Smart pointers automatically clean up
+    // The simulation thread may still be using the recorder, which goes first
+    if (simulationThread) {
+        simulationThread->stop();
+    }
 }
 
 // Initialize window
@@ -27,12 +47,23 @@ void Game::initWindow() {
 
 // Initialize game objects
 void Game::initGame() {
+    const SimulationConfig& config = simulation.getConfig();
+    
     // Create paddles
-    paddle1 = std::make_unique<Paddle>(30.0f, 250.0f, sf::Keyboard::W, sf::Keyboard::S, 600.0f);
-    paddle2 = std::make_unique<Paddle>(755.0f, 250.0f, sf::Keyboard::Up, sf::Keyboard::Down, 600.0f);
+    paddle1 = std::make_unique<Paddle>(config.paddle1X, config.paddleStartY, sf::Keyboard::W, sf::Keyboard::S);
+    paddle2 = std::make_unique<Paddle>(config.paddle2X, config.paddleStartY, sf::Keyboard::Up, sf::Keyboard::Down);
+    
+    // Their keys, queued from the window's events for the fixed tick
+    inputSampler = std::make_unique<InputSampler>(paddle1->getUpKey(), paddle1->getDownKey(), paddle2->getUpKey(),
+                                                  paddle2->getDownKey());
+    simulationThread = std::make_unique<SimulationThread>(*inputSampler);
     
     // Create ball
-    ball = std::make_unique<Ball>(400.0f, 300.0f, 8.0f, 300.0f, 800.0f, 600.0f);
+    ball = std::make_unique<Ball>(config.fieldWidth / 2.0f, config.fieldHeight / 2.0f, config.ballRadius,
+                                  config.ballSpeed);
+    
+    // Batched playfield drawing (center line, paddles, ball)
+    playfield = std::make_unique<PlayfieldRenderer>(config.fieldWidth, config.fieldHeight);
     
     // Create menu
     menu = std::make_unique<Menu>(profileManager, "assets/font.ttf");
@@ -44,34 +75,44 @@ void Game::initUI() {
         std::cerr << "Failed to load font for UI" << std::endl;
     }
     
-    // Score text for player 1
-    scoreText1.setFont(font);
-    scoreText1.setCharacterSize(40);
-    scoreText1.setFillColor(sf::Color::White);
+    // Scores
+    scoreText1.setStyle(font, 40, sf::Color::White);
     scoreText1.setPosition(300, 20);
-    
-    // Score text for player 2
-    scoreText2.setFont(font);
-    scoreText2.setCharacterSize(40);
-    scoreText2.setFillColor(sf::Color::White);
+    scoreText2.setStyle(font, 40, sf::Color::White);
     scoreText2.setPosition(460, 20);
     
+    // Player names (strings set when a match starts)
+    player1NameText.setStyle(font, 20, sf::Color(150, 150, 150));
+    player1NameText.setPosition(50, 30);
+    player2NameText.setStyle(font, 20, sf::Color(150, 150, 150));
+    player2NameText.setPosition(650, 30);
+    
     // Game over text
-    gameOverText.setFont(font);
-    gameOverText.setCharacterSize(50);
-    gameOverText.setFillColor(sf::Color::Yellow);
+    gameOverText.setStyle(font, 50, sf::Color::Yellow);
     
     // Countdown text
-    countdownText.setFont(font);
-    countdownText.setCharacterSize(120);
-    countdownText.setFillColor(sf::Color::Yellow);
+    countdownText.setStyle(font, 120, sf::Color::Yellow);
+    
+    // Connection status while a networked match is being set up
+    networkText.setStyle(font, 30, sf::Color::White);
+    
+    // Digits change mid-match; load their glyphs now so a new score never allocates
+    scoreText1.preloadGlyphs("0123456789");
+    scoreText2.preloadGlyphs("0123456789");
+    countdownText.preloadGlyphs("0123456789");
     
     // Instruction text
-    instructionText.setFont(font);
-    instructionText.setCharacterSize(20);
-    instructionText.setFillColor(sf::Color::White);
+    instructionText.setStyle(font, 20, sf::Color::White);
     instructionText.setString("Press ESC to return to menu");
     instructionText.setPosition(240, 550);
+    
+    // Restart text
+    restartText.setStyle(font, 20, sf::Color::White);
+    restartText.setString("Press SPACE to return to menu or ESC to quit");
+    restartText.setPosition(180, 400);
+    
+    // Frame profiler overlay (F3), under the left player's name
+    profilerOverlay = std::make_unique<ProfilerOverlay>(font, 10, 70);
 }
 
 // Load resources (sounds, etc.)
@@ -95,27 +136,112 @@ bool Game::loadResources() {
 // Main game loop
 void Game::run() {
     while (window.isOpen()) {
+        GameState frameState = currentState;
+        allocationStats.beginFrame();
+        frameProfiler.beginFrame();
+        
         pollEvents();
+        frameProfiler.endPhase(FrameProfiler::EVENTS);
         update();
+        frameProfiler.endPhase(FrameProfiler::UPDATE);
         render();
+        frameProfiler.endPhase(FrameProfiler::RENDER);
+        window.display();
+        frameProfiler.endPhase(FrameProfiler::DISPLAY);
+        frameProfiler.endFrame();
+        recordInputLatency(frameState);
+        
+        std::uint64_t allocations = allocationStats.endFrame(static_cast<std::size_t>(frameState));
+        checkFrameAllocations(frameState, allocations);
+    }
+    
+    // Window closed mid-match: keep what was recorded
+    stopSimulationThread();
+    saveRecording();
+    leaveOnline();
+    printFrameTimes();
+    
+    if (alloc::isTracking()) {
+        static const char* const stateNames[] = { "MENU", "PLAYING", "GAME_OVER", "EXIT" };
+        allocationStats.print(std::cout, stateNames);
+    }
+}
+
+// Steady-state PLAYING frames (one second after play starts) must not allocate
+void Game::checkFrameAllocations(GameState frameState, std::uint64_t allocations) {
+    if (frameState != GameState::PLAYING || currentState != GameState::PLAYING) {
+        // An unattended check ends with the replayed match
+        if (frameState == GameState::PLAYING && options.assertZeroAlloc && !options.replayPath.empty()) {
+            window.close();
+        }
+        playingTime = 0.0f;
+        return;
+    }
+    
+    // playingTime is advanced by update()
+    if (playingTime > 1.0f && allocations > 0 && options.assertZeroAlloc) {
+        if (allocationFailures == 0) {
+            std::cerr << "Allocation check failed: " << allocations
+                      << " heap allocation(s) in a steady-state PLAYING frame" << std::endl;
+        }
+        allocationFailures++;
+    }
+}
+
+// The frame just shown used a key change: time from the change to now
+void Game::recordInputLatency(GameState frameState) {
+    std::uint64_t changed = frameKeyChange;
+    frameKeyChange = 0;
+    if (changed != 0 && frameState == GameState::PLAYING && !isReplaying) {
+        inputLatency.record(InputSampler::now() - changed);
+    }
+}
+
+// Summary of the last frames, for reports from machines we can't watch
+void Game::printFrameTimes() const {
+    FrameProfiler::Stats total;
+    FrameProfiler::Stats phases[FrameProfiler::PHASE_COUNT];
+    std::size_t frames = frameProfiler.summarize(total, phases);
+    if (frames == 0) {
+        return;
+    }
+    
+    std::cout << "Frame times over the last " << frames << " frames (p50 / p99 / max ms): "
+              << total.p50 << " / " << total.p99 << " / " << total.max << std::endl;
+    for (int phase = 0; phase < FrameProfiler::PHASE_COUNT; phase++) {
+        std::cout << "  " << FrameProfiler::phaseName(static_cast<FrameProfiler::Phase>(phase)) << ": "
+                  << phases[phase].p50 << " / " << phases[phase].p99 << " / " << phases[phase].max << std::endl;
+    }
+    if (inputLatency.count() > 0) {
+        std::cout << "Key change to display over " << inputLatency.count() << " frames (p50 / p99 / max ms): "
+                  << inputLatency.percentile(0.5) / 1e6 << " / " << inputLatency.percentile(0.99) / 1e6 << " / "
+                  << inputLatency.max() / 1e6 << std::endl;
     }
 }
 
 // Poll events
 void Game::pollEvents() {
     while (window.pollEvent(event)) {
+        inputSampler->handleEvent(event);
         if (event.type == sf::Event::Closed) {
             window.close();
         }
         
+        // Toggle the frame profiler overlay
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+            showProfiler = !showProfiler;
+        }
+        
         // Handle escape key
         if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
             if (currentState == GameState::PLAYING || currentState == GameState::GAME_OVER) {
+                stopSimulationThread();
+                saveRecording();
+                leaveOnline();
+                isReplaying = false;
                 setState(GameState::MENU);
                 menu->reset();
-                score1 = 0;
-                score2 = 0;
-            } else if (currentState == GameState::MENU) {
+            } else if (currentState == GameState::MENU && menu->isAtMainMenu()) {
                 window.close();
             }
         }
@@ -129,9 +255,7 @@ void Game::pollEvents() {
                 if (menu->isReadyToPlay()) {
                     player1Name = menu->getPlayer1Name();
                     player2Name = menu->getPlayer2Name();
-                    score1 = 0;
-                    score2 = 0;
-                    resetRound();
+                    startMatch();
                     setState(GameState::PLAYING);
                 }
             }
@@ -141,79 +265,29 @@ void Game::pollEvents() {
         if (currentState == GameState::GAME_OVER) {
             if (event.type == sf::Event::KeyPressed) {
                 if (event.key.code == sf::Keyboard::Space) {
+                    isReplaying = false;
                     setState(GameState::MENU);
                     menu->reset();
-                    score1 = 0;
-                    score2 = 0;
                 }
             }
         }
     }
+    
+    // Retry a key change the ring had no room for
+    inputSampler->publish();
 }
 
 // Update game state
 void Game::update() {
+    PONG_TRACE_SCOPE("Game::update");
     float deltaTime = deltaClock.restart().asSeconds();
     
-    if (currentState == GameState::PLAYING) {
-        // Handle countdown
-        if (isCountingDown) {
-            countdownTimer -= deltaTime;
-            
-            if (countdownTimer <= 0.0f) {
-                countdownNumber--;
-                if (countdownNumber > 0) {
-                    countdownTimer = 1.0f;
-                } else {
-                    isCountingDown = false;
-                }
-            }
-            
-            // Update paddles even during countdown
-            paddle1->update(deltaTime);
-            paddle2->update(deltaTime);
-            
-            return; // Don't update ball during countdown
-        }
-        
-        // Update paddles
-        paddle1->update(deltaTime);
-        paddle2->update(deltaTime);
-        
-        // Update ball
-        ball->update(deltaTime);
-        
-        // Check paddle collisions
-        ball->checkPaddleCollision(*paddle1);
-        ball->checkPaddleCollision(*paddle2);
-        
-        // Check scoring
-        int scoreResult = ball->checkScore();
-        if (scoreResult != 0) {
-            if (scoreResult == 1) {
-                score1++;
-                std::cout << player1Name << " scores! " << score1 << " - " << score2 << std::endl;
-            } else if (scoreResult == 2) {
-                score2++;
-                std::cout << player2Name << " scores! " << score1 << " - " << score2 << std::endl;
-            }
-            
-            // Play score sound
-            if (scoreSound.getStatus() != sf::Sound::Playing) {
-                scoreSound.play();
-            }
-            
-            // Check for game over
-            checkGameOver();
-            
-            if (currentState == GameState::PLAYING) {
-                resetRound();
-            }
-        }
-        
-        // Update score display
-        scoreText1.setString(std::to_string(score1));
-        scoreText2.setString(std::to_string(score2));
+    if (currentState == GameState::PLAYING && isOnline) {
+        playingTime += deltaTime;
+        updateOnline(deltaTime);
+    } else if (currentState == GameState::PLAYING) {
+        playingTime += deltaTime;
+        updateFromSimulationThread();
     }
     
     if (currentState == GameState::MENU) {
@@ -223,68 +297,53 @@ void Game::update() {
 
 // Render
 void Game::render() {
+    PONG_TRACE_SCOPE("Game::render");
     window.clear(sf::Color::Black);
     
     if (currentState == GameState::MENU) {
         menu->render(window);
     }
     else if (currentState == GameState::PLAYING) {
-        // Draw center line
-        for (int i = 0; i < 600; i += 20) {
-            sf::RectangleShape line(sf::Vector2f(2, 10));
-            line.setPosition(399, i);
-            line.setFillColor(sf::Color(100, 100, 100));
-            window.draw(line);
+        // Draw center line, paddles and ball (two draw calls); a local match
+        // is drawn between its last two ticks, as far on as the clock is
+        if (simulationThread->isRunning()) {
+            const TickSnapshot& latest = simulationThread->getLatest();
+            playfield->update(interpolateState(latest.previous, latest.state, simulationThread->getAlpha()));
+        } else {
+            playfield->update(simulation.getState());
         }
-        
-        // Draw game objects
-        paddle1->render(window);
-        paddle2->render(window);
-        ball->render(window);
+        playfield->render(window);
         
         // Draw scores
         window.draw(scoreText1);
         window.draw(scoreText2);
         
         // Draw player names
-        sf::Text p1NameText, p2NameText;
-        p1NameText.setFont(font);
-        p1NameText.setString(player1Name);
-        p1NameText.setCharacterSize(20);
-        p1NameText.setFillColor(sf::Color(150, 150, 150));
-        p1NameText.setPosition(50, 30);
-        window.draw(p1NameText);
+        window.draw(player1NameText);
+        window.draw(player2NameText);
         
-        p2NameText.setFont(font);
-        p2NameText.setString(player2Name);
-        p2NameText.setCharacterSize(20);
-        p2NameText.setFillColor(sf::Color(150, 150, 150));
-        p2NameText.setPosition(650, 30);
-        window.draw(p2NameText);
-        
-        // Draw countdown if active
-        if (isCountingDown && countdownNumber > 0) {
-            countdownText.setString(std::to_string(countdownNumber));
-            sf::FloatRect textBounds = countdownText.getGlobalBounds();
-            countdownText.setPosition((800 - textBounds.width) / 2, 200);
+        // Draw countdown if active (re-laid out only when the number changes)
+        const SimulationState& state = simulation.getState();
+        if (state.isCountingDown && state.countdownNumber > 0) {
+            if (countdownText.setNumber(state.countdownNumber)) {
+                sf::FloatRect textBounds = countdownText.getGlobalBounds();
+                countdownText.setPosition((800 - textBounds.width) / 2, 200);
+            }
             window.draw(countdownText);
         }
         
         // Draw instruction
         window.draw(instructionText);
+        
+        // Until the server has seated us and sent the first snapshot
+        if (isOnline && !prediction) {
+            window.draw(networkText);
+        }
     }
     else if (currentState == GameState::GAME_OVER) {
         // Draw final scores and game objects
-        for (int i = 0; i < 600; i += 20) {
-            sf::RectangleShape line(sf::Vector2f(2, 10));
-            line.setPosition(399, i);
-            line.setFillColor(sf::Color(100, 100, 100));
-            window.draw(line);
-        }
-        
-        paddle1->render(window);
-        paddle2->render(window);
-        ball->render(window);
+        playfield->update(simulation.getState());
+        playfield->render(window);
         window.draw(scoreText1);
         window.draw(scoreText2);
         
@@ -292,31 +351,270 @@ void Game::render() {
         window.draw(gameOverText);
         
         // Draw restart instruction
-        sf::Text restartText;
-        restartText.setFont(font);
-        restartText.setString("Press SPACE to return to menu or ESC to quit");
-        restartText.setCharacterSize(20);
-        restartText.setFillColor(sf::Color::White);
-        restartText.setPosition(180, 400);
         window.draw(restartText);
     }
     
-    window.display();
+    // Frame profiler on top of everything (window.display() is timed separately in run())
+    if (showProfiler) {
+        profilerOverlay->update(frameProfiler);
+        profilerOverlay->render(window);
+    }
 }
 
-// Reset round (ball position)
-void Game::resetRound() {
-    ball->reset();
-    
-    // Start countdown
-    isCountingDown = true;
-    countdownTimer = 1.0f;
-    countdownNumber = 3;
+// Start a new match
+void Game::startMatch() {
+    // Every serve in the match follows from this seed
+    std::uint64_t seed;
+    if (options.fixedSeed) {
+        seed = options.seed + matchesStarted;
+    } else {
+        std::random_device device;
+        seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+    }
+    matchesStarted++;
+    std::cout << "Match seed: " << seed << std::endl;
+    
+    simulation.resetMatch(seed);
+    if (!options.recordPath.empty()) {
+        recorder.start(simulation.getConfig(), seed, player1Name, player2Name);
+    }
+    timestep.reset();
+    deltaClock.restart();
+    syncFromSimulation();
+    startSimulationThread();
+}
+
+// Play back the loaded recording in the window
+void Game::startReplay() {
+    const ReplayData& data = replayPlayer.getData();
+    player1Name = data.player1Name;
+    player2Name = data.player2Name;
+    
+    // The recording carries its own config (tick rate, speeds, ...)
+    simulation = Simulation(data.config);
+    timestep = FixedTimestep(simulation.getTickDuration());
+    simulation.resetMatch(data.seed);
+    replayPlayer.rewind();
+    
+    deltaClock.restart();
+    syncFromSimulation();
+    isReplaying = true;
+    startSimulationThread();
+    setState(GameState::PLAYING);
+    std::cout << "Replaying " << options.replayPath << " (seed " << data.seed << ")" << std::endl;
+}
+
+// Write the current recording, if one is running
+void Game::saveRecording() {
+    if (recorder.isRecording()) {
+        recorder.save(options.recordPath, simulation.getState());
+    }
+}
+
+// Join a match on pong-server instead of showing the menu
+void Game::startOnline() {
+    sf::IpAddress address(options.connectHost);
+    if (address == sf::IpAddress::None) {
+        throw std::runtime_error("Unknown host: " + options.connectHost);
+    }
+    netClient = std::make_unique<NetClient>();
+    netClient->setLinkConditions(options.link);
+    if (!netClient->connect(address, options.connectPort)) {
+        throw std::runtime_error("Could not connect to " + options.connectHost);
+    }
+    prediction.reset();
+    isOnline = true;
+    
+    player1Name.clear();
+    player2Name.clear();
+    timestep.reset();
+    deltaClock.restart();
+    inputSampler->discard();
+    setState(GameState::PLAYING);
+    std::cout << "Connecting to " << options.connectHost << ":" << options.connectPort << std::endl;
+}
+
+// One frame of a networked match: reconcile with the newest snapshot, then
+// predict as many ticks as the frame covers with our keys
+void Game::updateOnline(float deltaTime) {
+    static const std::string connectingMessage = "Connecting...";
+    static const std::string waitingMessage = "Waiting for an opponent...";
+    
+    bool newSnapshot = netClient->update();
+    
+    // The final score is the server's, not our prediction of it
+    if (netClient->hasSnapshot() && netClient->getLatestState().matchOver) {
+        simulation.restoreState(netClient->getLatestState());
+        syncFromSimulation();
+        checkGameOver();
+        leaveOnline();
+        return;
+    }
+    if (netClient->getStatus() == NetClient::Status::CLOSED) {
+        endOnline(prediction ? "Match abandoned" : "No reply from server");
+        return;
+    }
+    if (netClient->getStatus() != NetClient::Status::PLAYING) {
+        const std::string& message =
+            (netClient->getStatus() == NetClient::Status::CONNECTING) ? connectingMessage : waitingMessage;
+        if (networkText.setString(message)) {
+            sf::FloatRect textBounds = networkText.getGlobalBounds();
+            networkText.setPosition((800 - textBounds.width) / 2, 200);
+        }
+        timestep.reset();
+        return;
+    }
+    
+    if (!prediction) {
+        // Seated and playing: use the server's rules from here on
+        int player = netClient->getPlayer();
+        simulation = Simulation(netClient->getConfig());
+        timestep = FixedTimestep(simulation.getTickDuration());
+        prediction = std::make_unique<ClientPrediction>(netClient->getConfig(), player, options.prediction);
+        player1Name = (player == 1) ? "You" : "Opponent";
+        player2Name = (player == 1) ? "Opponent" : "You";
+        std::cout << "Match " << netClient->getMatchId() << ": you are the "
+                  << (player == 1 ? "left" : "right") << " paddle" << std::endl;
+    }
+    if (newSnapshot) {
+        prediction->reconcile(netClient->getLatestState(), netClient->getLatestInputs(),
+                              netClient->getLatestInputTick());
+    }
+    
+    std::uint64_t frameTime = InputSampler::now();
+    int steps = prediction->adjustSteps(timestep.advance(deltaTime));
+    for (int i = 0; i < steps; i++) {
+        // Either set of keys moves our paddle
+        SimulationInput keys = inputSampler->keysForStep(i, steps, frameTime, timestep);
+        PaddleInput local;
+        local.up = keys.player1.up || keys.player2.up;
+        local.down = keys.player1.down || keys.player2.down;
+        
+        netClient->sendInput(static_cast<std::uint32_t>(prediction->getTick()), local);
+        StepResult result = prediction->advance(local);
+        
+        // Predicted events sound at once; a rollback may still take one back
+        if (result.wallHit || result.paddleHit) {
+            ball->playHitSound();
+        }
+        if (result.scorer != 0 && scoreSound.getStatus() != sf::Sound::Playing) {
+            scoreSound.play();
+        }
+    }
+    
+    frameKeyChange = inputSampler->takeFirstChange();
+    simulation.restoreState(prediction->getState());
+    syncFromSimulation();
+}
+
+// The networked match ended without a result
+void Game::endOnline(const std::string& message) {
+    std::cout << message << std::endl;
+    leaveOnline();
+    gameOverText.setString(message);
+    sf::FloatRect textBounds = gameOverText.getGlobalBounds();
+    gameOverText.setPosition((800 - textBounds.width) / 2, 250);
+    setState(GameState::GAME_OVER);
+}
+
+// Say BYE and report how the prediction went
+void Game::leaveOnline() {
+    if (!isOnline) {
+        return;
+    }
+    if (prediction) {
+        const PredictionStats& stats = prediction->getStats();
+        std::cout << "Prediction: " << stats.mispredictions << " of " << stats.snapshotsChecked
+                  << " snapshots mispredicted, deepest rollback " << stats.deepestRollback << " ticks, "
+                  << stats.fullReplays << " beyond the window" << std::endl;
+    }
+    netClient->disconnect();
+    netClient.reset();
+    prediction.reset();
+    isOnline = false;
+}
+
+// Hand the match to the simulation thread, from the state it is in now
+void Game::startSimulationThread() {
+    inputSampler->discard();
+    hitsHeard = 0;
+    pointsHeard = 0;
+    simulationThread->start(simulation, isReplaying ? &replayPlayer : nullptr, &recorder);
+}
+
+// Catch up with the simulation thread: sounds for what happened since the
+// last frame, the HUD, and the end of the match
+void Game::updateFromSimulationThread() {
+    const TickSnapshot* latest = simulationThread->takeLatest();
+    if (!latest) {
+        return;
+    }
+    if (latest->firstKeyChange != 0 && frameKeyChange == 0) {
+        frameKeyChange = latest->firstKeyChange;
+    }
+    
+    if (latest->hits != hitsHeard) {
+        ball->playHitSound();
+        hitsHeard = latest->hits;
+    }
+    if (latest->points != pointsHeard) {
+        const SimulationState& before = simulation.getState();
+        const SimulationState& state = latest->state;
+        const std::string& scorerName = (state.score1 != before.score1) ? player1Name : player2Name;
+        std::cout << scorerName << " scores! " << state.score1 << " - " << state.score2 << std::endl;
+        
+        // Play score sound
+        if (scoreSound.getStatus() != sf::Sound::Playing) {
+            scoreSound.play();
+        }
+        pointsHeard = latest->points;
+    }
+    
+    simulation.restoreState(latest->state);
+    syncFromSimulation();
+    if (!latest->done) {
+        return;
+    }
+    
+    bool replayEnded = latest->replayEnded;
+    stopSimulationThread();
+    if (replayEnded) {
+        // Recording ended before the match did (it was abandoned)
+        std::cout << "Replay finished." << std::endl;
+        isReplaying = false;
+        setState(GameState::MENU);
+        menu->reset();
+    } else {
+        checkGameOver();
+    }
+}
+
+// Take the match back from the simulation thread (no-op if it isn't running)
+void Game::stopSimulationThread() {
+    if (simulationThread->isRunning()) {
+        simulation.restoreState(simulationThread->stop().getState());
+        syncFromSimulation();
+    }
+}
+
+// Copy simulation state into the render objects and HUD
+void Game::syncFromSimulation() {
+    const SimulationState& state = simulation.getState();
+    paddle1->setState(state.paddle1);
+    paddle2->setState(state.paddle2);
+    ball->setState(state.ball);
+    
+    // Update score display (no-op unless a score changed)
+    scoreText1.setNumber(state.score1);
+    scoreText2.setNumber(state.score2);
+    player1NameText.setString(player1Name);
+    player2NameText.setString(player2Name);
 }
 
 // Check for game over
 void Game::checkGameOver() {
-    if (score1 >= maxScore || score2 >= maxScore) {
+    if (simulation.getState().matchOver) {
+        saveRecording();
         setState(GameState::GAME_OVER);
         handleGameOver();
     }
@@ -324,18 +622,16 @@ void Game::checkGameOver() {
 
 // Handle game over
 void Game::handleGameOver() {
-    std::string winner;
+    int score1 = simulation.getState().score1;
+    int score2 = simulation.getState().score2;
+    const std::string& winner = (score1 > score2) ? player1Name : player2Name;
+    const std::string& loser = (score1 > score2) ? player2Name : player1Name;
     
-    if (score1 > score2) {
-        winner = player1Name;
-        gameOverText.setString(player1Name + " Wins!");
-        profileManager.updateStats(player1Name, true);
-        profileManager.updateStats(player2Name, false);
-    } else {
-        winner = player2Name;
-        gameOverText.setString(player2Name + " Wins!");
-        profileManager.updateStats(player2Name, true);
-        profileManager.updateStats(player1Name, false);
+    gameOverText.setString(winner + " Wins!");
+    
+    // Replays and networked matches don't count toward profile stats
+    if (!isReplaying && !isOnline) {
+        profileManager.recordMatchResult(winner, loser);
     }
     
     // Center the game over text
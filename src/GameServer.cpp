@@ -0,0 +1,671 @@
+#include "GameServer.h"
+#include "Random.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+const std::uint64_t NS_PER_SECOND = 1000000000ULL;
+const std::uint64_t WHEEL_RESOLUTION = 100000;     // 100 us per timer wheel step
+const std::uint64_t PUBLISH_INTERVAL = 50000000;   // Workers refresh their stats copy every 50 ms
+const int RECEIVE_WAIT_MS = 5;                     // Longest the network thread sleeps between chores
+
+std::uint64_t toNanoseconds(float seconds) {
+    return static_cast<std::uint64_t>(std::max(seconds, 0.0f) * static_cast<double>(NS_PER_SECOND));
+}
+
+} // namespace
+
+// Constructor
+GameServer::GameServer(const ServerConfig& cfg)
+    : config(cfg), matches(static_cast<std::size_t>(std::max(cfg.maxMatches, 1))),
+      slots(matches.size()), waitingSlot(-1), nextMatchId(1), stopping(false),
+      epoch(std::chrono::steady_clock::now()) {
+    config.snapshotInterval = std::max(config.snapshotInterval, 1);
+    config.workers = std::max(1, std::min(config.workers, static_cast<int>(matches.size())));
+    tickLength = NS_PER_SECOND / static_cast<std::uint64_t>(std::max(config.simulation.tickRate, 1));
+    for (int slot = static_cast<int>(matches.size()) - 1; slot >= 0; slot--) {
+        freeSlots.push_back(slot);
+    }
+    endpoints.reserve(matches.size() * 2);
+
+    std::uint32_t perWorker = static_cast<std::uint32_t>((matches.size() + config.workers - 1) / config.workers);
+    for (int i = 0; i < config.workers; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->index = i;
+        worker->wheel = std::make_unique<TimerWheel>(WHEEL_RESOLUTION, perWorker * TIMER_KINDS);
+        worker->inbox.reserve(256);
+        worker->commands.reserve(256);
+        worker->expired.reserve(perWorker * TIMER_KINDS);
+        workers.push_back(std::move(worker));
+    }
+}
+
+// Bind the UDP port
+bool GameServer::start() {
+    if (socket.bind(config.port) != sf::Socket::Done) {
+        std::cerr << "Failed to bind UDP port " << config.port << std::endl;
+        return false;
+    }
+    socket.setBlocking(false);
+    selector.add(socket);
+    std::cout << "Serving up to " << matches.size() << " matches on UDP port " << socket.getLocalPort() << " with "
+              << workers.size() << (workers.size() == 1 ? " worker" : " workers") << std::endl;
+    return true;
+}
+
+// Network loop: hand datagrams to the workers and do the seating, then
+// sleep until the next datagram or the next chore
+void GameServer::run() {
+    for (auto& worker : workers) {
+        Worker* owned = worker.get();
+        owned->thread = std::thread([this, owned] { runWorker(*owned); });
+    }
+
+    std::uint64_t lastReport = now();
+    ServerStats reported = getStats();
+    std::uint64_t reportInterval = toNanoseconds(config.reportInterval);
+
+    while (!stopping.load()) {
+        std::uint64_t time = now();
+        receivePackets(time);
+        collectFreedSlots();
+        checkWaitingTimeout(time);
+
+        if (reportInterval > 0 && time - lastReport >= reportInterval) {
+            ServerStats current = getStats();
+            printReport(current, reported, static_cast<double>(time - lastReport) / NS_PER_SECOND);
+            reported = current;
+            lastReport = time;
+        }
+
+        selector.wait(sf::milliseconds(RECEIVE_WAIT_MS));
+    }
+
+    for (auto& worker : workers) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+        }
+        worker->wake.notify_all();
+        worker->thread.join();
+    }
+    collectFreedSlots();
+    if (waitingSlot >= 0) {
+        freeSlot(waitingSlot);
+    }
+}
+
+// Nanoseconds since the server was constructed
+std::uint64_t GameServer::now() const {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+// IPv4 address and port as one key
+std::uint64_t GameServer::endpointKey(const sf::IpAddress& address, unsigned short port) {
+    return (static_cast<std::uint64_t>(address.toInteger()) << 16) | port;
+}
+
+// Add one thread's counters to a total
+void GameServer::addStats(ServerStats& total, const ServerStats& part) {
+    total.packetsIn += part.packetsIn;
+    total.bytesIn += part.bytesIn;
+    total.packetsOut += part.packetsOut;
+    total.bytesOut += part.bytesOut;
+    total.sendFailures += part.sendFailures;
+    total.badPackets += part.badPackets;
+    total.snapshotsSent += part.snapshotsSent;
+    total.fullSnapshots += part.fullSnapshots;
+    total.snapshotBytes += part.snapshotBytes;
+    total.lateInputs += part.lateInputs;
+    total.matchesStarted += part.matchesStarted;
+    total.matchesFinished += part.matchesFinished;
+    total.matchesAbandoned += part.matchesAbandoned;
+    total.rejectedJoins += part.rejectedJoins;
+    total.ticks += part.ticks;
+    total.ticksSkipped += part.ticksSkipped;
+    total.tickLateness.merge(part.tickLateness);
+    total.activeMatches += part.activeMatches;
+}
+
+// The network thread's counters plus each worker's latest copy of its own
+ServerStats GameServer::getStats() const {
+    ServerStats total = stats;
+    for (const auto& worker : workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        addStats(total, worker->published);
+    }
+    return total;
+}
+
+// Read every queued datagram and route it by sender
+void GameServer::receivePackets(std::uint64_t time) {
+    PONG_TRACE_SCOPE("GameServer::receivePackets");
+    std::size_t size = 0;
+    sf::IpAddress address;
+    unsigned short port = 0;
+    while (socket.receive(packet, sizeof(packet), size, address, port) == sf::Socket::Done) {
+        stats.packetsIn++;
+        stats.bytesIn += size;
+
+        net::PacketType type;
+        if (!net::readType(packet, size, type)) {
+            stats.badPackets++;
+            continue;
+        }
+        auto known = endpoints.find(endpointKey(address, port));
+        if (type == net::PacketType::HELLO) {
+            if (known != endpoints.end()) {
+                // Our WELCOME was lost, or a lone player's keepalive
+                slots[known->second / 2].seats[known->second % 2].lastHeard = time;
+                sendWelcome(known->second / 2, known->second % 2);
+            } else {
+                handleHello(address, port, size, time);
+            }
+            continue;
+        }
+        if (known == endpoints.end()) {
+            if (type != net::PacketType::BYE) {   // A BYE can cross ours after the match ended
+                stats.badPackets++;
+            }
+            continue;
+        }
+
+        int slot = known->second / 2;
+        int playerIndex = known->second % 2;
+        Slot& seating = slots[slot];
+        seating.seats[playerIndex].lastHeard = time;
+
+        Command command;
+        command.slot = slot;
+        command.player = playerIndex;
+        command.receivedAt = time;
+        if (type == net::PacketType::INPUT) {
+            if (!net::readInput(packet, size, command.input) || command.input.matchId != seating.matchId ||
+                command.input.player != playerIndex + 1) {
+                stats.badPackets++;
+                continue;
+            }
+            if (seating.state == SlotState::STARTED) {
+                command.type = Command::Type::INPUT;
+                post(command);
+            }
+        } else if (type == net::PacketType::BYE) {
+            net::Bye bye;
+            if (!net::readBye(packet, size, bye) || bye.matchId != seating.matchId) {
+                continue;
+            }
+            if (seating.state == SlotState::WAITING) {
+                freeSlot(slot);
+            } else {
+                command.type = Command::Type::BYE;
+                command.matchId = bye.matchId;
+                post(command);
+            }
+        } else {
+            stats.badPackets++;
+        }
+    }
+}
+
+// Seat a new player: second seat of the waiting match, or a fresh match.
+// A full match goes to its worker.
+void GameServer::handleHello(const sf::IpAddress& address, unsigned short port, std::size_t size,
+                             std::uint64_t time) {
+    net::Hello hello;
+    if (!net::readHello(packet, size, hello)) {
+        stats.badPackets++;
+        return;
+    }
+
+    int slot = waitingSlot;
+    int playerIndex = 1;
+    if (slot < 0) {
+        if (freeSlots.empty()) {
+            stats.rejectedJoins++;   // The client keeps asking until a slot frees up
+            return;
+        }
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        playerIndex = 0;
+
+        slots[slot].state = SlotState::WAITING;
+        slots[slot].matchId = nextMatchId++;
+        waitingSlot = slot;
+        stats.activeMatches++;
+    }
+
+    Slot& seating = slots[slot];
+    Seat& seat = seating.seats[playerIndex];
+    seat.address = address;
+    seat.port = port;
+    seat.nonce = hello.nonce;
+    seat.lastHeard = time;
+    endpoints[endpointKey(address, port)] = slot * 2 + playerIndex;
+    sendWelcome(slot, playerIndex);
+
+    if (playerIndex == 1) {
+        waitingSlot = -1;
+        seating.state = SlotState::STARTED;
+
+        Command command;
+        command.type = Command::Type::START;
+        command.slot = slot;
+        command.receivedAt = time;
+        command.matchId = seating.matchId;
+        command.seats[0] = seating.seats[0];
+        command.seats[1] = seating.seats[1];
+        post(command);
+    }
+}
+
+// Seat, match id and rules for one player
+void GameServer::sendWelcome(int slot, int playerIndex) {
+    const Seat& seat = slots[slot].seats[playerIndex];
+    net::Welcome welcome;
+    welcome.nonce = seat.nonce;
+    welcome.matchId = slots[slot].matchId;
+    welcome.player = static_cast<std::uint8_t>(playerIndex + 1);
+    welcome.config = config.simulation;
+    send(packet, net::writeWelcome(packet, welcome), seat.address, seat.port, stats);
+}
+
+// Queue a command for the worker that owns its slot. Inputs wait for the
+// worker's next tick; a new match wakes it so its first snapshot goes out
+// now.
+void GameServer::post(const Command& command) {
+    Worker& worker = *workers[command.slot % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.inbox.push_back(command);
+    }
+    if (command.type == Command::Type::START) {
+        worker.wake.notify_one();
+    }
+}
+
+// Take back the slots the workers have finished with
+void GameServer::collectFreedSlots() {
+    for (auto& worker : workers) {
+        std::vector<int> freed;
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            freed.swap(worker->freedSlots);
+        }
+        for (int slot : freed) {
+            freeSlot(slot);
+        }
+    }
+}
+
+// Forget a slot's players and make it available again
+void GameServer::freeSlot(int slot) {
+    Slot& seating = slots[slot];
+    int seated = (seating.state == SlotState::WAITING) ? 1 : 2;
+    for (int i = 0; i < seated; i++) {
+        auto found = endpoints.find(endpointKey(seating.seats[i].address, seating.seats[i].port));
+        if (found != endpoints.end() && found->second == slot * 2 + i) {
+            endpoints.erase(found);
+        }
+    }
+    if (waitingSlot == slot) {
+        waitingSlot = -1;
+    }
+    seating.state = SlotState::FREE;
+    freeSlots.push_back(slot);
+    stats.activeMatches--;
+}
+
+// Give up on a lone player who has gone quiet
+void GameServer::checkWaitingTimeout(std::uint64_t time) {
+    if (waitingSlot < 0) {
+        return;
+    }
+    const Seat& seat = slots[waitingSlot].seats[0];
+    if (time - seat.lastHeard > toNanoseconds(config.clientTimeout)) {
+        freeSlot(waitingSlot);
+    }
+}
+
+// Worker loop: sleep until the earliest timer in the wheel (or a new
+// match), apply what the network thread sent, then run what came due
+void GameServer::runWorker(Worker& worker) {
+    trace::setThreadName("match worker");
+    TimerWheel& wheel = *worker.wheel;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            std::uint64_t time = now();
+            std::uint64_t wakeAt = std::min(wheel.nextExpiry(), time + PUBLISH_INTERVAL);
+            if (worker.inbox.empty() && !stopping.load() && wakeAt > time) {
+                worker.wake.wait_until(lock, epoch + std::chrono::nanoseconds(wakeAt));
+            }
+            worker.commands.swap(worker.inbox);
+        }
+
+        std::uint64_t time = now();
+        for (const Command& command : worker.commands) {
+            applyCommand(worker, command, time);
+        }
+        worker.commands.clear();
+
+        if (stopping.load()) {
+            break;
+        }
+
+        worker.expired.clear();
+        wheel.advance(now(), worker.expired);
+        for (std::uint32_t timer : worker.expired) {
+            fireTimer(worker, timer);
+        }
+        publishStats(worker, now(), false);
+    }
+
+    for (int slot = worker.index; slot < static_cast<int>(matches.size()); slot += static_cast<int>(workers.size())) {
+        if (matches[slot].phase != MatchPhase::FREE) {
+            endMatch(worker, slot);
+        }
+    }
+    publishStats(worker, now(), true);
+}
+
+// Carry out one message from the network thread
+void GameServer::applyCommand(Worker& worker, const Command& command, std::uint64_t time) {
+    Match& match = matches[command.slot];
+    switch (command.type) {
+        case Command::Type::START:
+            startMatch(worker, command, time);
+            break;
+        case Command::Type::INPUT:
+            if (match.phase != MatchPhase::FREE && command.input.matchId == match.id) {
+                match.players[command.player].lastHeard = command.receivedAt;
+                handleInput(worker, match, command.player, command.input);
+            }
+            break;
+        case Command::Type::BYE:
+            if (match.phase != MatchPhase::FREE && command.matchId == match.id) {
+                if (match.phase == MatchPhase::PLAYING) {
+                    worker.stats.matchesAbandoned++;
+                }
+                endMatch(worker, command.slot);
+            }
+            break;
+    }
+}
+
+// Both seats taken: start a fresh simulation with no baselines, due its
+// first tick one tick length from now
+void GameServer::startMatch(Worker& worker, const Command& command, std::uint64_t time) {
+    Match& match = matches[command.slot];
+    match.id = command.matchId;
+    match.simulation = Simulation(config.simulation);
+    match.simulation.resetMatch(Random::deriveSeed(config.seed, match.id));
+    for (Snapshot& snapshot : match.history) {
+        snapshot.tick = net::NO_TICK;
+    }
+    for (int i = 0; i < 2; i++) {
+        RemotePlayer& player = match.players[i];
+        player = RemotePlayer();
+        player.connected = true;
+        player.address = command.seats[i].address;
+        player.port = command.seats[i].port;
+        player.lastHeard = command.seats[i].lastHeard;
+        std::fill(std::begin(player.bufferedTicks), std::end(player.bufferedTicks), net::NO_TICK);
+    }
+    match.stepInputs = 0;
+    match.ticksRun = 0;
+    match.phase = MatchPhase::PLAYING;
+    worker.stats.matchesStarted++;
+    sendSnapshots(worker, match);
+
+    worker.wheel->schedule(timerFor(command.slot, TICK_TIMER), time + tickLength);
+    worker.wheel->schedule(timerFor(command.slot, TIMEOUT_TIMER),
+                           std::min(match.players[0].lastHeard, match.players[1].lastHeard) +
+                               toNanoseconds(config.clientTimeout));
+}
+
+// Queue a player's inputs by tick; ticks that already ran only update
+// the held input, which the next tick uses
+void GameServer::handleInput(Worker& worker, Match& match, int playerIndex, const net::InputPacket& input) {
+    RemotePlayer& player = match.players[playerIndex];
+    if (input.ackTick != net::NO_TICK && (player.ackTick == net::NO_TICK || input.ackTick > player.ackTick)) {
+        player.ackTick = input.ackTick;
+    }
+    if (match.phase != MatchPhase::PLAYING) {
+        return;
+    }
+
+    if (player.inputTick == net::NO_TICK || input.lastTick > player.inputTick) {
+        player.inputTick = input.lastTick;
+    }
+    std::uint64_t current = match.simulation.getState().tick;
+    for (int i = 0; i < input.count; i++) {
+        std::uint32_t tick = input.lastTick - static_cast<std::uint32_t>(input.count - 1 - i);
+        if (tick >= current) {
+            if (tick < current + INPUT_BUFFER) {
+                player.bufferedTicks[tick % INPUT_BUFFER] = tick;
+                player.bufferedCodes[tick % INPUT_BUFFER] = input.codes[i];
+            }
+        } else if (player.heldTick == net::NO_TICK || tick > player.heldTick) {
+            player.held = net::decodePaddleInput(input.codes[i]);
+            player.heldTick = tick;
+            worker.stats.lateInputs++;
+        }
+    }
+}
+
+// A match's timer came due
+void GameServer::fireTimer(Worker& worker, std::uint32_t timer) {
+    int slot = static_cast<int>(timer / TIMER_KINDS) * static_cast<int>(workers.size()) + worker.index;
+    Match& match = matches[slot];
+    if (match.phase == MatchPhase::FREE) {
+        return;
+    }
+
+    switch (static_cast<TimerKind>(timer % TIMER_KINDS)) {
+        case TICK_TIMER:
+            runTicks(worker, slot);
+            break;
+        case LINGER_TIMER:
+            endMatch(worker, slot);
+            break;
+        case TIMEOUT_TIMER: {
+            // Inputs only note when a player was heard; this is where it is checked
+            std::uint64_t time = now();
+            std::uint64_t timeout = toNanoseconds(config.clientTimeout);
+            for (const RemotePlayer& player : match.players) {
+                if (time - std::min(player.lastHeard, time) > timeout) {
+                    if (match.phase == MatchPhase::PLAYING) {
+                        worker.stats.matchesAbandoned++;
+                    }
+                    endMatch(worker, slot);
+                    return;
+                }
+            }
+            worker.wheel->schedule(timer, std::min(match.players[0].lastHeard, match.players[1].lastHeard) + timeout);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Run the ticks a match owes, then set its next deadline. A match that
+// has fallen more than MAX_CATCH_UP ticks behind drops the rest rather
+// than delaying every other match on this worker.
+void GameServer::runTicks(Worker& worker, int slot) {
+    Match& match = matches[slot];
+    std::uint32_t timer = timerFor(slot, TICK_TIMER);
+    std::uint64_t deadline = worker.wheel->getDeadline(timer);
+
+    for (int run = 0; match.phase != MatchPhase::FREE; run++) {
+        std::uint64_t time = now();
+        if (deadline > time) {
+            break;
+        }
+        if (run == MAX_CATCH_UP) {
+            std::uint64_t behind = (time - deadline) / tickLength + 1;
+            worker.stats.ticksSkipped += behind;
+            deadline += behind * tickLength;
+            break;
+        }
+        worker.stats.tickLateness.record(time - deadline);
+        tick(worker, slot);
+        deadline += tickLength;
+    }
+
+    if (match.phase != MatchPhase::FREE) {
+        worker.wheel->schedule(timer, deadline);
+    }
+}
+
+// One tick of one match: step it while playing, and send due snapshots
+void GameServer::tick(Worker& worker, int slot) {
+    Match& match = matches[slot];
+    worker.stats.ticks++;
+    match.ticksRun++;
+    bool snapshotDue = match.ticksRun % static_cast<std::uint64_t>(config.snapshotInterval) == 0;
+
+    if (match.phase == MatchPhase::FINISHED) {
+        if (snapshotDue) {
+            sendSnapshots(worker, match);
+        }
+        return;
+    }
+
+    std::uint32_t current = static_cast<std::uint32_t>(match.simulation.getState().tick);
+    SimulationInput input;
+    PaddleInput* paddles[2] = { &input.player1, &input.player2 };
+    for (int i = 0; i < 2; i++) {
+        RemotePlayer& player = match.players[i];
+        if (player.bufferedTicks[current % INPUT_BUFFER] == current) {
+            player.held = net::decodePaddleInput(player.bufferedCodes[current % INPUT_BUFFER]);
+            player.heldTick = current;
+        }
+        *paddles[i] = player.held;
+    }
+    match.stepInputs = static_cast<std::uint8_t>(net::encodePaddleInput(input.player1) |
+                                                 (net::encodePaddleInput(input.player2) << 2));
+
+    StepResult result = match.simulation.step(input, match.simulation.getTickDuration());
+    if (result.matchOver) {
+        match.phase = MatchPhase::FINISHED;
+        worker.stats.matchesFinished++;
+        worker.wheel->schedule(timerFor(slot, LINGER_TIMER), now() + toNanoseconds(config.finishedLinger));
+        sendSnapshots(worker, match);   // The final score goes out at once
+    } else if (snapshotDue) {
+        sendSnapshots(worker, match);
+    }
+}
+
+// Pack the state once, then delta it against each player's acknowledged baseline
+void GameServer::sendSnapshots(Worker& worker, Match& match) {
+    std::uint32_t tick = static_cast<std::uint32_t>(match.simulation.getState().tick);
+    Snapshot& current = match.history[(tick / config.snapshotInterval) % SNAPSHOT_HISTORY];
+    current.tick = tick;
+    net::packState(match.simulation.getState(), current.words);
+
+    static const std::uint32_t zeros[net::STATE_WORDS] = {};
+    for (const RemotePlayer& player : match.players) {
+        net::SnapshotHeader header;
+        header.matchId = match.id;
+        header.tick = tick;
+        header.inputTick = player.inputTick;
+        header.inputs = match.stepInputs;
+        const std::uint32_t (*baseline)[net::STATE_WORDS] = &zeros;
+        if (player.ackTick != net::NO_TICK) {
+            const Snapshot& acked = match.history[(player.ackTick / config.snapshotInterval) % SNAPSHOT_HISTORY];
+            if (acked.tick == player.ackTick) {
+                header.baselineTick = acked.tick;
+                baseline = &acked.words;
+            }
+        }
+        if (header.baselineTick == net::NO_TICK) {
+            worker.stats.fullSnapshots++;
+        }
+
+        std::size_t size = net::writeSnapshot(worker.packet, header, current.words, *baseline);
+        worker.stats.snapshotsSent++;
+        worker.stats.snapshotBytes += size;
+        send(worker.packet, size, player.address, player.port, worker.stats);
+    }
+}
+
+// Say BYE to both players, disarm the match's timers and hand the slot
+// back to the network thread
+void GameServer::endMatch(Worker& worker, int slot) {
+    Match& match = matches[slot];
+    for (int i = 0; i < 2; i++) {
+        RemotePlayer& player = match.players[i];
+        if (!player.connected) {
+            continue;
+        }
+        net::Bye bye;
+        bye.matchId = match.id;
+        bye.player = static_cast<std::uint8_t>(i + 1);
+        send(worker.packet, net::writeBye(worker.packet, bye), player.address, player.port, worker.stats);
+        player.connected = false;
+    }
+    for (int kind = 0; kind < TIMER_KINDS; kind++) {
+        worker.wheel->cancel(timerFor(slot, static_cast<TimerKind>(kind)));
+    }
+
+    match.phase = MatchPhase::FREE;
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.freedSlots.push_back(slot);
+}
+
+// Copy a worker's counters where getStats() can read them
+void GameServer::publishStats(Worker& worker, std::uint64_t time, bool force) {
+    if (!force && time - worker.lastPublished < PUBLISH_INTERVAL) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.published = worker.stats;
+    worker.lastPublished = time;
+}
+
+// A match timer's index in its worker's wheel
+std::uint32_t GameServer::timerFor(int slot, TimerKind kind) const {
+    return static_cast<std::uint32_t>(slot / static_cast<int>(workers.size())) * TIMER_KINDS +
+           static_cast<std::uint32_t>(kind);
+}
+
+// Send one datagram; any thread may, each counting into its own stats
+void GameServer::send(std::uint8_t* data, std::size_t size, const sf::IpAddress& address, unsigned short port,
+                      ServerStats& counters) {
+    if (socket.send(data, size, address, port) == sf::Socket::Done) {
+        counters.packetsOut++;
+        counters.bytesOut += size;
+    } else {
+        counters.sendFailures++;
+    }
+}
+
+// One status line of rates and tick lateness since the previous report
+void GameServer::printReport(const ServerStats& current, const ServerStats& previous, double seconds) const {
+    if (seconds <= 0) {
+        return;
+    }
+    std::uint64_t snapshots = current.snapshotsSent - previous.snapshotsSent;
+    double snapshotAverage =
+        snapshots ? static_cast<double>(current.snapshotBytes - previous.snapshotBytes) / snapshots : 0.0;
+    LatencyHistogram lateness = current.tickLateness.since(previous.tickLateness);
+    std::printf("[server] %d matches | in %.0f pkt/s | out %.0f pkt/s, %.1f KB/s | snapshot %.1f B avg | "
+                "late inputs %llu | finished %llu, abandoned %llu\n",
+                current.activeMatches, (current.packetsIn - previous.packetsIn) / seconds,
+                (current.packetsOut - previous.packetsOut) / seconds,
+                (current.bytesOut - previous.bytesOut) / seconds / 1024.0, snapshotAverage,
+                static_cast<unsigned long long>(current.lateInputs - previous.lateInputs),
+                static_cast<unsigned long long>(current.matchesFinished),
+                static_cast<unsigned long long>(current.matchesAbandoned));
+    std::printf("[server] %.0f ticks/s | tick lateness p50 %.0f us, p99 %.0f us, p99.9 %.0f us | skipped %llu\n",
+                (current.ticks - previous.ticks) / seconds, lateness.percentile(0.5) / 1000.0,
+                lateness.percentile(0.99) / 1000.0, lateness.percentile(0.999) / 1000.0,
+                static_cast<unsigned long long>(current.ticksSkipped - previous.ticksSkipped));
+    std::fflush(stdout);
+}
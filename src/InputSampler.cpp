@@ -0,0 +1,102 @@
+#include "InputSampler.h"
+#include <chrono>
+#include <limits>
+
+namespace {
+
+bool sameKeys(const SimulationInput& a, const SimulationInput& b) {
+    return a.player1.up == b.player1.up && a.player1.down == b.player1.down && a.player2.up == b.player2.up &&
+           a.player2.down == b.player2.down;
+}
+
+} // namespace
+
+// Constructor
+InputSampler::InputSampler(sf::Keyboard::Key player1Up, sf::Keyboard::Key player1Down, sf::Keyboard::Key player2Up,
+                           sf::Keyboard::Key player2Down)
+    : up1(player1Up), down1(player1Down), up2(player2Up), down2(player2Down), firstUnshown(0) {
+}
+
+// Track the paddle keys from the window's events
+void InputSampler::handleEvent(const sf::Event& event) {
+    if (event.type == sf::Event::LostFocus) {
+        pressed = SimulationInput();
+    } else if (event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased) {
+        bool down = event.type == sf::Event::KeyPressed;
+        sf::Keyboard::Key key = event.key.code;
+        if (key == up1) {
+            pressed.player1.up = down;
+        } else if (key == down1) {
+            pressed.player1.down = down;
+        } else if (key == up2) {
+            pressed.player2.up = down;
+        } else if (key == down2) {
+            pressed.player2.down = down;
+        } else {
+            return;
+        }
+    } else {
+        return;
+    }
+    publish();
+}
+
+// Queue the keys if they differ from the last change queued; a full ring
+// just means they are offered again on the next call
+void InputSampler::publish() {
+    if (sameKeys(pressed, queued)) {
+        return;
+    }
+    InputEvent change;
+    change.time = now();
+    change.keys = pressed;
+    if (ring.push(change)) {
+        queued = pressed;
+    }
+}
+
+// Take the queued changes up to a time
+const SimulationInput& InputSampler::keysAt(std::uint64_t time) {
+    while (const InputEvent* event = ring.front()) {
+        if (event->time > time) {
+            break;
+        }
+        held = event->keys;
+        if (firstUnshown == 0) {
+            firstUnshown = event->time;
+        }
+        ring.pop();
+    }
+    return held;
+}
+
+// Keys as of the end of one of a batch of ticks
+const SimulationInput& InputSampler::keysForStep(int step, int steps, std::uint64_t time,
+                                                 const FixedTimestep& timestep) {
+    if (step + 1 >= steps) {
+        return keysAt(time);
+    }
+    double ticksBack = (steps - 1 - step) + timestep.getAlpha();
+    std::uint64_t back = static_cast<std::uint64_t>(ticksBack * timestep.getStepSize() * 1e9);
+    return keysAt(time > back ? time - back : 0);
+}
+
+// Take everything queued, unmeasured
+void InputSampler::discard() {
+    keysAt(std::numeric_limits<std::uint64_t>::max());
+    firstUnshown = 0;
+}
+
+// Oldest change taken since the last call
+std::uint64_t InputSampler::takeFirstChange() {
+    std::uint64_t time = firstUnshown;
+    firstUnshown = 0;
+    return time;
+}
+
+// Steady clock in nanoseconds
+std::uint64_t InputSampler::now() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
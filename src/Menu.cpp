@@ -1,13 +1,24 @@
 #include "Menu.h"
+#include "Trace.h"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 
 // Constructor
 Menu::Menu(ProfileManager& profManager, const std::string& fontPath)
     : profileManager(profManager), currentState(MenuState::MAIN_MENU), 
-      selectedIndex(0), inputActive(false) {
+      selectedIndex(0), moreAbove(false), leaderboardKind(LeaderboardKind::WINS), leaderboardFirst(0),
+      leaderboardSize(0), inputActive(false), layoutState(MenuState::MAIN_MENU), layoutDirty(true) {
     
     loadFont(fontPath);
     updateMenuItems();
+    
+    // Input box never changes
+    inputBox.setSize(sf::Vector2f(400, 50));
+    inputBox.setPosition(200, 320);
+    inputBox.setFillColor(sf::Color(50, 50, 50));
+    inputBox.setOutlineColor(sf::Color::White);
+    inputBox.setOutlineThickness(2);
 }
 
 // Load font
@@ -26,12 +37,15 @@ void Menu::updateMenuItems() {
     switch (currentState) {
         case MenuState::MAIN_MENU:
             menuItems.push_back("Start Game");
+            menuItems.push_back("Leaderboard");
             menuItems.push_back("Exit");
             break;
             
         case MenuState::SELECT_PLAYER1:
         case MenuState::SELECT_PLAYER2:
-            menuItems = profileManager.getProfileNames();
+            for (const UserProfile& profile : profilePage) {
+                menuItems.push_back(profile.username);
+            }
             menuItems.push_back("Create New Profile");
             break;
             
@@ -43,12 +57,164 @@ void Menu::updateMenuItems() {
             menuItems.push_back("Press SPACE to Start");
             menuItems.push_back("Back to Menu");
             break;
+            
+        case MenuState::LEADERBOARD:
+            for (std::size_t i = 0; i < profilePage.size(); i++) {
+                menuItems.push_back(leaderboardLabel(leaderboardFirst + i, profilePage[i]));
+            }
+            if (profilePage.empty()) {
+                menuItems.push_back("Nobody is ranked here yet");
+            }
+            break;
     }
     
     // Reset selection if out of bounds
     if (selectedIndex >= static_cast<int>(menuItems.size())) {
         selectedIndex = 0;
     }
+    
+    // Item strings (and profile stats) may have changed
+    layoutDirty = true;
+}
+
+// Fetch the window of profiles starting at a name; near the end of the
+// list earlier names are pulled in so the window stays full
+void Menu::showProfilePage(std::string firstName) {
+    const std::size_t rows = VISIBLE_PROFILES;
+    profileManager.getProfilesFrom(firstName, rows + 1, profilePage, searchPrefix);
+    
+    nextProfileName.clear();
+    if (profilePage.size() > rows) {
+        nextProfileName = profilePage.back().username;
+        profilePage.pop_back();
+    } else if (profilePage.size() < rows) {
+        std::string_view first = profilePage.empty() ? std::string_view() : std::string_view(profilePage.front().username);
+        profileManager.getProfilesBefore(first, rows - profilePage.size(), pageScratch, searchPrefix);
+        profilePage.insert(profilePage.begin(), std::make_move_iterator(pageScratch.begin()),
+                           std::make_move_iterator(pageScratch.end()));
+    }
+    
+    moreAbove = !profilePage.empty() &&
+                profileManager.getProfilesBefore(profilePage.front().username, 1, pageScratch, searchPrefix) > 0;
+    updateMenuItems();
+}
+
+// Move the profile window for keys that leave it; false means the key
+// only moves the selection within the visible rows
+bool Menu::scrollProfileList(sf::Keyboard::Key key) {
+    int rows = static_cast<int>(profilePage.size());
+    
+    if (key == sf::Keyboard::Up && selectedIndex == 0 && rows > 0) {
+        if (moreAbove) {
+            profileManager.getProfilesBefore(profilePage.front().username, 1, pageScratch, searchPrefix);
+            showProfilePage(pageScratch.front().username);
+        } else {
+            // Wrap to "Create New Profile" under the last page
+            profileManager.getProfilesBefore("", VISIBLE_PROFILES, pageScratch, searchPrefix);
+            showProfilePage(pageScratch.front().username);
+            selectedIndex = static_cast<int>(profilePage.size());
+        }
+        return true;
+    }
+    if (key == sf::Keyboard::Down && selectedIndex == rows - 1 && !nextProfileName.empty()) {
+        showProfilePage(profilePage[1].username);
+        return true;
+    }
+    if (key == sf::Keyboard::Down && selectedIndex == rows && moreAbove) {
+        // Wrap from "Create New Profile" to the first profile
+        showProfilePage("");
+        selectedIndex = 0;
+        return true;
+    }
+    if (key == sf::Keyboard::PageDown && !nextProfileName.empty()) {
+        showProfilePage(nextProfileName);
+        return true;
+    }
+    if (key == sf::Keyboard::PageUp && moreAbove) {
+        profileManager.getProfilesBefore(profilePage.front().username, VISIBLE_PROFILES, pageScratch, searchPrefix);
+        showProfilePage(pageScratch.front().username);
+        return true;
+    }
+    return false;
+}
+
+// Fetch the leaderboard rows from a rank, clamped so the last page stays full
+void Menu::showLeaderboard(std::size_t first) {
+    const std::size_t rows = VISIBLE_PROFILES;
+    leaderboardSize = profileManager.getLeaderboardSize(leaderboardKind);
+    if (first + rows > leaderboardSize) {
+        first = leaderboardSize > rows ? leaderboardSize - rows : 0;
+    }
+    leaderboardFirst = first;
+    profileManager.getLeaderboard(leaderboardKind, first, rows, profilePage);
+    updateMenuItems();
+}
+
+// Scroll, switch ranking, or leave the leaderboard
+bool Menu::handleLeaderboardKey(sf::Keyboard::Key key) {
+    const std::size_t rows = VISIBLE_PROFILES;
+    switch (key) {
+        case sf::Keyboard::Up:
+            showLeaderboard(leaderboardFirst > 0 ? leaderboardFirst - 1 : 0);
+            return true;
+        case sf::Keyboard::Down:
+            showLeaderboard(leaderboardFirst + 1);
+            return true;
+        case sf::Keyboard::PageUp:
+            showLeaderboard(leaderboardFirst > rows ? leaderboardFirst - rows : 0);
+            return true;
+        case sf::Keyboard::PageDown:
+            showLeaderboard(leaderboardFirst + rows);
+            return true;
+        case sf::Keyboard::Left:
+        case sf::Keyboard::Right: {
+            int step = key == sf::Keyboard::Right ? 1 : static_cast<int>(LEADERBOARD_KINDS) - 1;
+            leaderboardKind = static_cast<LeaderboardKind>((static_cast<int>(leaderboardKind) + step) % LEADERBOARD_KINDS);
+            showLeaderboard(0);
+            return true;
+        }
+        case sf::Keyboard::Enter:
+        case sf::Keyboard::Escape:
+            currentState = MenuState::MAIN_MENU;
+            selectedIndex = 1;
+            updateMenuItems();
+            return true;
+        default:
+            return false;
+    }
+}
+
+// One leaderboard row: rank, name and the value it is ranked by
+std::string Menu::leaderboardLabel(std::size_t rank, const UserProfile& profile) const {
+    std::string label = "#" + std::to_string(rank + 1) + "  " + profile.username + "  ";
+    switch (leaderboardKind) {
+        case LeaderboardKind::WINS:
+            label += std::to_string(profile.wins) + " wins";
+            break;
+            
+        case LeaderboardKind::WIN_RATE: {
+            int permille = profile.totalGames > 0 ? profile.wins * 1000 / profile.totalGames : 0;
+            label += std::to_string(permille / 10) + "." + std::to_string(permille % 10) + "% of " +
+                     std::to_string(profile.totalGames);
+            break;
+        }
+            
+        case LeaderboardKind::RATING:
+            label += std::to_string(profile.rating);
+            break;
+    }
+    return label;
+}
+
+// "name 1532 (#3)" for the ready screen
+std::string Menu::ratingLabel(const std::string& username) {
+    std::vector<UserProfile> profile;
+    std::size_t rank = 0;
+    if (profileManager.getProfilesFrom(username, 1, profile) == 0 || profile[0].username != username ||
+        !profileManager.getLeaderboardRank(LeaderboardKind::RATING, username, rank)) {
+        return username;
+    }
+    return username + " " + std::to_string(profile[0].rating) + " (#" + std::to_string(rank + 1) + ")";
 }
 
 // Handle input
@@ -60,14 +226,19 @@ void Menu::handleInput(sf::Event& event) {
             if (event.key.code == sf::Keyboard::Enter && !textInput.empty()) {
                 // Create profile
                 if (profileManager.createProfile(textInput)) {
+                    std::string created = textInput;
                     textInput.clear();
+                    searchPrefix.clear();
                     // Return to appropriate player selection
                     if (player1Name.empty()) {
                         currentState = MenuState::SELECT_PLAYER1;
                     } else {
                         currentState = MenuState::SELECT_PLAYER2;
                     }
-                    updateMenuItems();
+                    
+                    // Show the new profile, selected
+                    showProfilePage(created);
+                    selectedIndex = static_cast<int>(std::find(menuItems.begin(), menuItems.end(), created) - menuItems.begin());
                 }
             } else if (event.key.code == sf::Keyboard::Escape) {
                 // Cancel profile creation
@@ -80,9 +251,16 @@ void Menu::handleInput(sf::Event& event) {
                 updateMenuItems();
             }
         }
+        // The leaderboard scrolls instead of moving a selection
+        else if (currentState == MenuState::LEADERBOARD) {
+            handleLeaderboardKey(event.key.code);
+        }
         // Normal menu navigation
         else {
-            if (event.key.code == sf::Keyboard::Up) {
+            bool selectingProfile = currentState == MenuState::SELECT_PLAYER1 || currentState == MenuState::SELECT_PLAYER2;
+            if (selectingProfile && scrollProfileList(event.key.code)) {
+                // The profile window moved instead of the selection
+            } else if (event.key.code == sf::Keyboard::Up) {
                 selectedIndex--;
                 if (selectedIndex < 0) {
                     selectedIndex = menuItems.size() - 1;
@@ -99,16 +277,21 @@ void Menu::handleInput(sf::Event& event) {
                         if (selectedIndex == 0) {
                             currentState = MenuState::SELECT_PLAYER1;
                             selectedIndex = 0;
-                            updateMenuItems();
+                            searchPrefix.clear();
+                            showProfilePage("");
+                        } else if (selectedIndex == 1) {
+                            currentState = MenuState::LEADERBOARD;
+                            selectedIndex = -1; // Rows are not selectable
+                            showLeaderboard(0);
                         }
                         break;
                         
                     case MenuState::SELECT_PLAYER1:
                     case MenuState::SELECT_PLAYER2:
                         if (selectedIndex == static_cast<int>(menuItems.size()) - 1) {
-                            // Create new profile
+                            // Create new profile, starting from whatever was searched for
                             currentState = MenuState::CREATE_PROFILE;
-                            textInput.clear();
+                            textInput = searchPrefix;
                         } else if (selectedIndex < static_cast<int>(menuItems.size())) {
                             // Select existing profile
                             std::string selectedName = menuItems[selectedIndex];
@@ -117,7 +300,8 @@ void Menu::handleInput(sf::Event& event) {
                                 player1Name = selectedName;
                                 currentState = MenuState::SELECT_PLAYER2;
                                 selectedIndex = 0;
-                                updateMenuItems();
+                                searchPrefix.clear();
+                                showProfilePage("");
                             } else {
                                 // Prevent selecting same player
                                 if (selectedName != player1Name) {
@@ -140,8 +324,12 @@ void Menu::handleInput(sf::Event& event) {
                         break;
                 }
             } else if (event.key.code == sf::Keyboard::Escape) {
-                // Go back
-                if (currentState == MenuState::SELECT_PLAYER1) {
+                // Go back (a search is cleared first)
+                if (selectingProfile && !searchPrefix.empty()) {
+                    searchPrefix.clear();
+                    selectedIndex = 0;
+                    showProfilePage("");
+                } else if (currentState == MenuState::SELECT_PLAYER1) {
                     currentState = MenuState::MAIN_MENU;
                     updateMenuItems();
                 } else if (currentState == MenuState::SELECT_PLAYER2) {
@@ -164,7 +352,35 @@ void Menu::handleInput(sf::Event& event) {
                 textInput += static_cast<char>(event.text.unicode);
             }
         }
+        layoutDirty = true;
+    }
+    
+    // Typing on the profile list filters it
+    if ((currentState == MenuState::SELECT_PLAYER1 || currentState == MenuState::SELECT_PLAYER2) &&
+        event.type == sf::Event::TextEntered) {
+        editSearch(event.text.unicode);
+    }
+}
+
+// Type-to-filter on the profile list. Each keystroke re-seeks the window
+// with a couple of binary searches, however many profiles there are.
+void Menu::editSearch(sf::Uint32 unicode) {
+    if (unicode == 8) { // Backspace
+        if (searchPrefix.empty()) {
+            return;
+        }
+        searchPrefix.pop_back();
+    } else if (unicode >= 32 && unicode < 128) {
+        if (searchPrefix.length() >= 20) { // Usernames are at most 20 characters
+            return;
+        }
+        searchPrefix += static_cast<char>(unicode);
+    } else {
+        return;
     }
+    
+    selectedIndex = 0;
+    showProfilePage("");
 }
 
 // Update
@@ -172,168 +388,216 @@ void Menu::update() {
     // Menu is event-driven, no continuous updates needed
 }
 
+// Build every text of the current screen; runs only when something changed
+void Menu::layoutTexts() {
+    switch (currentState) {
+        case MenuState::MAIN_MENU:
+            titleText.setStyle(font, 60, sf::Color::White);
+            titleText.setString("PONG GAME");
+            titleText.setPosition(250, 100);
+            layoutMenuItems(30, 300, 280, 60);
+            break;
+            
+        case MenuState::SELECT_PLAYER1:
+        case MenuState::SELECT_PLAYER2: {
+            bool secondPlayer = currentState == MenuState::SELECT_PLAYER2;
+            titleText.setStyle(font, 50, sf::Color::White);
+            titleText.setString(secondPlayer ? "Select Player 2" : "Select Player 1");
+            titleText.setPosition(200, 80);
+            
+            instructionText.setStyle(font, 18, sf::Color(150, 150, 150));
+            instructionText.setString("Arrows/PgUp/PgDn to Navigate, Enter to Select, ESC to Go Back");
+            instructionText.setPosition(100, 540);
+            
+            subtitleText.setStyle(font, 20, sf::Color(150, 150, 150));
+            subtitleText.setString(searchPrefix.empty() ? "Type to search" : "Search: " + searchPrefix + "_");
+            subtitleText.setPosition(200, 140);
+            
+            layoutMenuItems(25, 200, 170, 42);
+            
+            // Show stats for the visible profiles (the last item is "Create New Profile")
+            for (size_t i = 0; i < profilePage.size(); i++) {
+                const UserProfile& profile = profilePage[i];
+                std::string label = profile.username + " (W:" + std::to_string(profile.wins) + 
+                                    " L:" + std::to_string(profile.losses) + ")";
+                
+                // Disable if same as player 1 (for player 2 selection)
+                if (secondPlayer && profile.username == player1Name) {
+                    label += " (Already Selected)";
+                    menuItemDisabled[i] = true;
+                }
+                menuTexts[i].setString(label);
+            }
+            
+            // Markers beside the first and last rows when more profiles are off-screen
+            moreAboveText.setStyle(font, 25, sf::Color(150, 150, 150));
+            moreAboveText.setString("^");
+            moreAboveText.setPosition(170, 170);
+            moreBelowText.setStyle(font, 25, sf::Color(150, 150, 150));
+            moreBelowText.setString("v");
+            moreBelowText.setPosition(170, 170 + 42 * (VISIBLE_PROFILES - 1));
+            break;
+        }
+            
+        case MenuState::CREATE_PROFILE:
+            titleText.setStyle(font, 50, sf::Color::White);
+            titleText.setString("Create New Profile");
+            titleText.setPosition(150, 150);
+            
+            instructionText.setStyle(font, 20, sf::Color(200, 200, 200));
+            instructionText.setString("Enter Username (Press Enter to Confirm, ESC to Cancel)");
+            instructionText.setPosition(150, 250);
+            
+            inputText.setStyle(font, 30, sf::Color::White);
+            inputText.setString(textInput + "_");
+            inputText.setPosition(210, 330);
+            break;
+            
+        case MenuState::READY_TO_PLAY:
+            titleText.setStyle(font, 50, sf::Color::Green);
+            titleText.setString("Ready to Play!");
+            titleText.setPosition(220, 100);
+            
+            player1Text.setStyle(font, 30, sf::Color::White);
+            player1Text.setString("Player 1 (W/S): " + player1Name);
+            player1Text.setPosition(200, 250);
+            
+            player2Text.setStyle(font, 30, sf::Color::White);
+            player2Text.setString("Player 2 (Up/Down): " + player2Name);
+            player2Text.setPosition(200, 320);
+            
+            subtitleText.setStyle(font, 20, sf::Color(150, 150, 150));
+            subtitleText.setString("Rating: " + ratingLabel(player1Name) + "  vs  " + ratingLabel(player2Name));
+            subtitleText.setPosition(200, 190);
+            
+            layoutMenuItems(25, 250, 420, 50);
+            break;
+            
+        case MenuState::LEADERBOARD: {
+            titleText.setStyle(font, 50, sf::Color::White);
+            titleText.setString("Leaderboard");
+            titleText.setPosition(250, 60);
+            
+            const char* ranking = leaderboardKind == LeaderboardKind::WINS ? "Most Wins"
+                                : leaderboardKind == LeaderboardKind::WIN_RATE ? "Best Win Rate" : "Rating";
+            std::string subtitle = std::string("< ") + ranking + " >";
+            if (leaderboardKind == LeaderboardKind::WIN_RATE) {
+                subtitle += "  (" + std::to_string(ProfileManager::WIN_RATE_MIN_GAMES) + "+ games)";
+            }
+            if (leaderboardSize > 0) {
+                subtitle += "   " + std::to_string(leaderboardFirst + 1) + "-" +
+                            std::to_string(leaderboardFirst + profilePage.size()) + " of " +
+                            std::to_string(leaderboardSize);
+            }
+            subtitleText.setStyle(font, 20, sf::Color(150, 150, 150));
+            subtitleText.setString(subtitle);
+            subtitleText.setPosition(150, 135);
+            
+            instructionText.setStyle(font, 18, sf::Color(150, 150, 150));
+            instructionText.setString("Left/Right: Ranking   Up/Down/PgUp/PgDn: Scroll   ESC: Back");
+            instructionText.setPosition(120, 540);
+            
+            layoutMenuItems(25, 150, 180, 42);
+            break;
+        }
+    }
+    
+    layoutState = currentState;
+    layoutDirty = false;
+}
+
+// One text per menu item, stacked vertically
+void Menu::layoutMenuItems(unsigned size, float x, float y, float spacing) {
+    menuTexts.resize(menuItems.size());
+    menuItemDisabled.assign(menuItems.size(), false);
+    
+    for (size_t i = 0; i < menuItems.size(); i++) {
+        menuTexts[i].setStyle(font, size, sf::Color::White);
+        menuTexts[i].setString(menuItems[i]);
+        menuTexts[i].setPosition(x, y + i * spacing);
+    }
+}
+
+// Recolor items for the current selection (no glyph rebuild)
+void Menu::updateHighlight() {
+    for (size_t i = 0; i < menuTexts.size(); i++) {
+        if (menuItemDisabled[i]) {
+            menuTexts[i].setFillColor(sf::Color(100, 100, 100));
+        } else {
+            menuTexts[i].setFillColor(static_cast<int>(i) == selectedIndex ? sf::Color::Yellow : sf::Color::White);
+        }
+    }
+}
+
 // Render main menu
 void Menu::renderMainMenu(sf::RenderWindow& window) {
-    // Title
-    titleText.setFont(font);
-    titleText.setString("PONG GAME");
-    titleText.setCharacterSize(60);
-    titleText.setFillColor(sf::Color::White);
-    titleText.setPosition(250, 100);
     window.draw(titleText);
-    
-    // Menu items
-    float yOffset = 300;
-    for (size_t i = 0; i < menuItems.size(); i++) {
-        sf::Text text;
-        text.setFont(font);
-        text.setString(menuItems[i]);
-        text.setCharacterSize(30);
-        text.setFillColor(i == selectedIndex ? sf::Color::Yellow : sf::Color::White);
-        text.setPosition(300, yOffset + i * 60);
+    for (const CachedText& text : menuTexts) {
         window.draw(text);
     }
 }
 
 // Render profile selection
-void Menu::renderProfileSelection(sf::RenderWindow& window, const std::string& playerLabel) {
-    // Title
-    titleText.setFont(font);
-    titleText.setString("Select " + playerLabel);
-    titleText.setCharacterSize(50);
-    titleText.setFillColor(sf::Color::White);
-    titleText.setPosition(200, 80);
+void Menu::renderProfileSelection(sf::RenderWindow& window) {
     window.draw(titleText);
-    
-    // Instructions
-    instructionText.setFont(font);
-    instructionText.setString("Use Arrow Keys to Navigate, Enter to Select, ESC to Go Back");
-    instructionText.setCharacterSize(18);
-    instructionText.setFillColor(sf::Color(150, 150, 150));
-    instructionText.setPosition(100, 540);
     window.draw(instructionText);
-    
-    // Profile list
-    float yOffset = 200;
-    for (size_t i = 0; i < menuItems.size(); i++) {
-        sf::Text text;
-        text.setFont(font);
-        
-        // Show stats for existing profiles
-        if (i < menuItems.size() - 1) {
-            UserProfile* profile = profileManager.getProfile(menuItems[i]);
-            if (profile) {
-                std::string statsStr = menuItems[i] + " (W:" + std::to_string(profile->wins) + 
-                                      " L:" + std::to_string(profile->losses) + ")";
-                text.setString(statsStr);
-            } else {
-                text.setString(menuItems[i]);
-            }
-        } else {
-            text.setString(menuItems[i]);
-        }
-        
-        text.setCharacterSize(25);
-        text.setFillColor(i == selectedIndex ? sf::Color::Yellow : sf::Color::White);
-        text.setPosition(200, yOffset + i * 45);
-        
-        // Disable if same as player 1 (for player 2 selection)
-        if (currentState == MenuState::SELECT_PLAYER2 && menuItems[i] == player1Name) {
-            text.setFillColor(sf::Color(100, 100, 100));
-            text.setString(text.getString() + " (Already Selected)");
-        }
-        
+    window.draw(subtitleText);
+    for (const CachedText& text : menuTexts) {
         window.draw(text);
     }
+    if (moreAbove) {
+        window.draw(moreAboveText);
+    }
+    if (!nextProfileName.empty()) {
+        window.draw(moreBelowText);
+    }
 }
 
 // Render create profile screen
 void Menu::renderCreateProfile(sf::RenderWindow& window) {
-    // Title
-    titleText.setFont(font);
-    titleText.setString("Create New Profile");
-    titleText.setCharacterSize(50);
-    titleText.setFillColor(sf::Color::White);
-    titleText.setPosition(150, 150);
     window.draw(titleText);
-    
-    // Instructions
-    instructionText.setFont(font);
-    instructionText.setString("Enter Username (Press Enter to Confirm, ESC to Cancel)");
-    instructionText.setCharacterSize(20);
-    instructionText.setFillColor(sf::Color(200, 200, 200));
-    instructionText.setPosition(150, 250);
     window.draw(instructionText);
-    
-    // Input box
-    sf::RectangleShape inputBox(sf::Vector2f(400, 50));
-    inputBox.setPosition(200, 320);
-    inputBox.setFillColor(sf::Color(50, 50, 50));
-    inputBox.setOutlineColor(sf::Color::White);
-    inputBox.setOutlineThickness(2);
     window.draw(inputBox);
-    
-    // Input text
-    inputText.setFont(font);
-    inputText.setString(textInput + "_");
-    inputText.setCharacterSize(30);
-    inputText.setFillColor(sf::Color::White);
-    inputText.setPosition(210, 330);
     window.draw(inputText);
 }
 
 // Render ready screen
 void Menu::renderReadyScreen(sf::RenderWindow& window) {
-    // Title
-    titleText.setFont(font);
-    titleText.setString("Ready to Play!");
-    titleText.setCharacterSize(50);
-    titleText.setFillColor(sf::Color::Green);
-    titleText.setPosition(220, 100);
     window.draw(titleText);
-    
-    // Player info
-    sf::Text p1Text, p2Text;
-    p1Text.setFont(font);
-    p1Text.setString("Player 1 (W/S): " + player1Name);
-    p1Text.setCharacterSize(30);
-    p1Text.setFillColor(sf::Color::White);
-    p1Text.setPosition(200, 250);
-    window.draw(p1Text);
-    
-    p2Text.setFont(font);
-    p2Text.setString("Player 2 (Up/Down): " + player2Name);
-    p2Text.setCharacterSize(30);
-    p2Text.setFillColor(sf::Color::White);
-    p2Text.setPosition(200, 320);
-    window.draw(p2Text);
-    
-    // Options
-    float yOffset = 420;
-    for (size_t i = 0; i < menuItems.size(); i++) {
-        sf::Text text;
-        text.setFont(font);
-        text.setString(menuItems[i]);
-        text.setCharacterSize(25);
-        text.setFillColor(i == selectedIndex ? sf::Color::Yellow : sf::Color::White);
-        text.setPosition(250, yOffset + i * 50);
+    window.draw(subtitleText);
+    window.draw(player1Text);
+    window.draw(player2Text);
+    for (const CachedText& text : menuTexts) {
+        window.draw(text);
+    }
+}
+
+// Render leaderboard
+void Menu::renderLeaderboard(sf::RenderWindow& window) {
+    window.draw(titleText);
+    window.draw(subtitleText);
+    window.draw(instructionText);
+    for (const CachedText& text : menuTexts) {
         window.draw(text);
     }
 }
 
 // Render
 void Menu::render(sf::RenderWindow& window) {
+    PONG_TRACE_SCOPE("Menu::render");
+    if (layoutDirty || layoutState != currentState) {
+        layoutTexts();
+    }
+    updateHighlight();
+    
     switch (currentState) {
         case MenuState::MAIN_MENU:
             renderMainMenu(window);
             break;
             
         case MenuState::SELECT_PLAYER1:
-            renderProfileSelection(window, "Player 1");
-            break;
-            
         case MenuState::SELECT_PLAYER2:
-            renderProfileSelection(window, "Player 2");
+            renderProfileSelection(window);
             break;
             
         case MenuState::CREATE_PROFILE:
@@ -343,6 +607,10 @@ void Menu::render(sf::RenderWindow& window) {
         case MenuState::READY_TO_PLAY:
             renderReadyScreen(window);
             break;
+            
+        case MenuState::LEADERBOARD:
+            renderLeaderboard(window);
+            break;
     }
 }
 
@@ -358,5 +626,6 @@ void Menu::reset() {
     player2Name.clear();
     selectedIndex = 0;
     textInput.clear();
+    searchPrefix.clear();
     updateMenuItems();
 }
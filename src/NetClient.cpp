@@ -0,0 +1,287 @@
+#include "NetClient.h"
+#include "Random.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+const float HELLO_INTERVAL = 0.25f;   // Seconds between HELLOs until the first snapshot arrives
+
+} // namespace
+
+// Constructor
+NetClient::NetClient(float timeoutSeconds)
+    : serverPort(0), status(Status::DISCONNECTED), nonce(0), matchId(0), player(0), latestTick(net::NO_TICK),
+      latestState(), latestInputs(), latestInputTick(net::NO_TICK), inputCodes(), firstInputTick(net::NO_TICK),
+      lastInputTick(net::NO_TICK), timeout(timeoutSeconds) {
+}
+
+// Bind any free local port and start joining
+bool NetClient::connect(const sf::IpAddress& address, unsigned short port) {
+    socket.unbind();
+    if (socket.bind(sf::Socket::AnyPort) != sf::Socket::Done) {
+        std::cerr << "Failed to open a UDP socket" << std::endl;
+        return false;
+    }
+    socket.setBlocking(false);
+
+    serverAddress = address;
+    serverPort = port;
+    status = Status::CONNECTING;
+    matchId = 0;
+    player = 0;
+    latestTick = net::NO_TICK;
+    latestInputTick = net::NO_TICK;
+    firstInputTick = lastInputTick = net::NO_TICK;
+    delayed.clear();
+    for (Snapshot& snapshot : history) {
+        snapshot.tick = net::NO_TICK;
+    }
+
+    // Tells our WELCOME apart from a stale one for an earlier socket on the same port
+    static std::atomic<std::uint64_t> connectCount(0);
+    std::uint64_t clockSeed = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    nonce = static_cast<std::uint32_t>(Random::deriveSeed(clockSeed, connectCount++));
+    linkRandom.seed(nonce);
+
+    silenceClock.restart();
+    sendHello();
+    return true;
+}
+
+// Drain the socket
+bool NetClient::update() {
+    if (status == Status::DISCONNECTED || status == Status::CLOSED) {
+        return false;
+    }
+
+    bool newSnapshot = false;
+    std::size_t size = 0;
+    sf::IpAddress address;
+    unsigned short port = 0;
+    while (status != Status::CLOSED &&
+           socket.receive(packet, sizeof(packet), size, address, port) == sf::Socket::Done) {
+        if (address != serverAddress || port != serverPort) {
+            continue;
+        }
+        if (!link.isActive() || !delay(false, size)) {
+            newSnapshot = handlePacket(size) || newSnapshot;
+        }
+    }
+    if (link.isActive()) {
+        newSnapshot = deliverDelayed() || newSnapshot;
+    }
+    if (status == Status::CLOSED) {
+        return newSnapshot;
+    }
+
+    if (silenceClock.getElapsedTime().asSeconds() > timeout) {
+        status = Status::CLOSED;
+    } else if ((status == Status::CONNECTING || status == Status::WAITING) &&
+               helloClock.getElapsedTime().asSeconds() >= HELLO_INTERVAL) {
+        // While waiting for an opponent the HELLO is a keepalive: the
+        // server keeps the seat and answers with WELCOME again
+        sendHello();
+    }
+    return newSnapshot;
+}
+
+// Act on one datagram from the server, held in packet
+bool NetClient::handlePacket(std::size_t size) {
+    net::PacketType type;
+    if (!net::readType(packet, size, type)) {
+        return false;
+    }
+    stats.packetsIn++;
+    stats.bytesIn += size;
+    silenceClock.restart();
+
+    if (type == net::PacketType::WELCOME) {
+        net::Welcome welcome;
+        if (status == Status::CONNECTING && net::readWelcome(packet, size, welcome) && welcome.nonce == nonce) {
+            matchId = welcome.matchId;
+            player = welcome.player;
+            config = welcome.config;
+            status = Status::WAITING;
+        }
+    } else if (type == net::PacketType::SNAPSHOT) {
+        return handleSnapshot(size);
+    } else if (type == net::PacketType::BYE) {
+        net::Bye bye;
+        if (net::readBye(packet, size, bye) && bye.matchId == matchId) {
+            status = Status::CLOSED;
+        }
+    }
+    return false;
+}
+
+// Decode against the named baseline and remember the result as a future one
+bool NetClient::handleSnapshot(std::size_t size) {
+    net::SnapshotHeader header;
+    if ((status != Status::WAITING && status != Status::PLAYING) || !net::readSnapshotHeader(packet, size, header) ||
+        header.matchId != matchId) {
+        return false;
+    }
+    stats.snapshots++;
+    stats.snapshotBytes += size;
+    if (latestTick != net::NO_TICK && header.tick <= latestTick) {
+        stats.staleSnapshots++;
+        return false;
+    }
+
+    static const std::uint32_t zeros[net::STATE_WORDS] = {};
+    const std::uint32_t (*baseline)[net::STATE_WORDS] = &zeros;
+    if (header.baselineTick != net::NO_TICK) {
+        const Snapshot& stored = history[header.baselineTick % SNAPSHOT_HISTORY];
+        if (stored.tick != header.baselineTick) {
+            stats.undecodable++;
+            return false;
+        }
+        baseline = &stored.words;
+    }
+
+    Snapshot& slot = history[header.tick % SNAPSHOT_HISTORY];
+    std::uint32_t words[net::STATE_WORDS];
+    SimulationState state;
+    if (!net::readSnapshotBody(packet, size, *baseline, words)) {
+        stats.undecodable++;
+        return false;
+    }
+    net::unpackState(words, state);
+    if (state.tick != header.tick) {
+        stats.undecodable++;
+        return false;
+    }
+
+    slot.tick = header.tick;
+    std::copy(words, words + net::STATE_WORDS, slot.words);
+    latestTick = header.tick;
+    latestState = state;
+    latestInputs.player1 = net::decodePaddleInput(header.inputs & 3);
+    latestInputs.player2 = net::decodePaddleInput((header.inputs >> 2) & 3);
+    latestInputTick = header.inputTick;
+    status = Status::PLAYING;
+    return true;
+}
+
+// Record this tick's input and send the last few ticks together
+void NetClient::sendInput(std::uint32_t tick, const PaddleInput& input) {
+    if (status != Status::WAITING && status != Status::PLAYING) {
+        return;
+    }
+    std::uint8_t code = net::encodePaddleInput(input);
+    if (lastInputTick == net::NO_TICK || tick < firstInputTick) {
+        firstInputTick = tick;
+    } else if (tick > lastInputTick) {
+        // Fill skipped ticks with what was held then
+        std::uint8_t previous = inputCodes[lastInputTick % INPUT_HISTORY];
+        for (std::uint32_t skipped = lastInputTick + 1; skipped < tick; skipped++) {
+            inputCodes[skipped % INPUT_HISTORY] = previous;
+        }
+    }
+    inputCodes[tick % INPUT_HISTORY] = code;
+    if (lastInputTick == net::NO_TICK || tick > lastInputTick) {
+        lastInputTick = tick;
+    }
+
+    net::InputPacket message;
+    message.matchId = matchId;
+    message.player = static_cast<std::uint8_t>(player);
+    message.ackTick = latestTick;
+    message.lastTick = lastInputTick;
+    std::uint32_t available = lastInputTick - firstInputTick + 1;
+    message.count = static_cast<std::uint8_t>(std::min<std::uint32_t>(available, INPUT_REDUNDANCY));
+    for (int i = 0; i < message.count; i++) {
+        message.codes[i] = inputCodes[(lastInputTick - (message.count - 1 - i)) % INPUT_HISTORY];
+    }
+    send(net::writeInput(packet, message));
+}
+
+// Leave the match; the BYE skips the simulated link, which closes with us
+void NetClient::disconnect() {
+    if (status == Status::WAITING || status == Status::PLAYING) {
+        net::Bye bye;
+        bye.matchId = matchId;
+        bye.player = static_cast<std::uint8_t>(player);
+        transmit(packet, net::writeBye(packet, bye));
+    }
+    status = Status::DISCONNECTED;
+    delayed.clear();
+    socket.unbind();
+}
+
+// Turn the simulated link on (or off, with all zeros)
+void NetClient::setLinkConditions(const LinkConditions& conditions) {
+    link = conditions;
+    delayed.reserve(DELAYED_CAPACITY);
+}
+
+// Ask for a seat
+void NetClient::sendHello() {
+    net::Hello hello;
+    hello.nonce = nonce;
+    send(net::writeHello(packet, hello));
+    helloClock.restart();
+}
+
+// Send the datagram in packet to the server, through the simulated link if there is one
+void NetClient::send(std::size_t size) {
+    if (!link.isActive() || !delay(true, size)) {
+        transmit(packet, size);
+    }
+}
+
+void NetClient::transmit(const std::uint8_t* data, std::size_t size) {
+    if (socket.send(data, size, serverAddress, serverPort) == sf::Socket::Done) {
+        stats.packetsOut++;
+        stats.bytesOut += size;
+    }
+}
+
+// Drop the datagram in packet or hold it back until its delivery time.
+// True if the link took it (either way); false means pass it on now.
+bool NetClient::delay(bool outgoing, std::size_t size) {
+    if (linkRandom.nextFloat() < link.loss || delayed.size() >= DELAYED_CAPACITY) {
+        stats.linkDropped++;
+        return true;
+    }
+    double now = linkClock.getElapsedTime().asMicroseconds() / 1e6;
+    double due = now + link.latency + link.jitter * linkRandom.nextFloat();
+    if (due <= now) {
+        return false;
+    }
+
+    delayed.emplace_back();
+    DelayedPacket& held = delayed.back();
+    held.due = due;
+    held.outgoing = outgoing;
+    held.size = size;
+    std::copy(packet, packet + size, held.data);
+    return true;
+}
+
+// Send and handle whatever the simulated link has finished delaying, in
+// delivery order (jitter reorders packets, as a real network does)
+bool NetClient::deliverDelayed() {
+    double now = linkClock.getElapsedTime().asMicroseconds() / 1e6;
+    bool newSnapshot = false;
+    while (status != Status::CLOSED && status != Status::DISCONNECTED) {
+        auto next = std::min_element(delayed.begin(), delayed.end(),
+                                     [](const DelayedPacket& a, const DelayedPacket& b) { return a.due < b.due; });
+        if (next == delayed.end() || next->due > now) {
+            break;
+        }
+
+        if (next->outgoing) {
+            transmit(next->data, next->size);
+        } else {
+            std::copy(next->data, next->data + next->size, packet);
+            newSnapshot = handlePacket(next->size) || newSnapshot;
+        }
+        *next = delayed.back();
+        delayed.pop_back();
+    }
+    return newSnapshot;
+}
@@ -0,0 +1,353 @@
+#include "NetProtocol.h"
+#include <cstring>
+
+namespace net {
+
+namespace {
+
+const std::uint8_t MAGIC[2] = { 'P', 'G' };
+const std::uint8_t PROTOCOL_VERSION = 2;
+const std::size_t HEADER_SIZE = 4;
+const std::size_t MASK_BYTES = (STATE_WORDS + 7) / 8;
+const std::size_t SNAPSHOT_HEADER_SIZE = 17;   // match, tick, baseline, input tick, inputs
+
+// Little-endian writer over a caller-sized datagram buffer
+class PacketWriter {
+private:
+    std::uint8_t* data;
+    std::size_t pos;
+
+public:
+    PacketWriter(std::uint8_t* out, PacketType type) : data(out), pos(0) {
+        writeU8(MAGIC[0]);
+        writeU8(MAGIC[1]);
+        writeU8(PROTOCOL_VERSION);
+        writeU8(static_cast<std::uint8_t>(type));
+    }
+
+    void writeU8(std::uint8_t value) {
+        data[pos++] = value;
+    }
+
+    void writeU32(std::uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            data[pos++] = static_cast<std::uint8_t>(value >> (8 * i));
+        }
+    }
+
+    void writeFloat(float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeU32(bits);
+    }
+
+    std::uint8_t* reserve(std::size_t size) {
+        std::uint8_t* start = data + pos;
+        std::memset(start, 0, size);
+        pos += size;
+        return start;
+    }
+
+    std::size_t size() const { return pos; }
+};
+
+// Bounds-checked little-endian reader; starts after the header
+class PacketReader {
+private:
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t pos;
+
+public:
+    PacketReader(const std::uint8_t* bytes, std::size_t length) : data(bytes), size(length), pos(HEADER_SIZE) {}
+
+    bool readU8(std::uint8_t& value) {
+        if (pos + 1 > size) return false;
+        value = data[pos++];
+        return true;
+    }
+
+    bool readU32(std::uint32_t& value) {
+        if (pos + 4 > size) return false;
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= static_cast<std::uint32_t>(data[pos++]) << (8 * i);
+        }
+        return true;
+    }
+
+    bool readFloat(float& value) {
+        std::uint32_t bits;
+        if (!readU32(bits)) return false;
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool readInt(int& value) {
+        std::uint32_t bits;
+        if (!readU32(bits)) return false;
+        value = static_cast<int>(bits);
+        return true;
+    }
+
+    const std::uint8_t* skip(std::size_t length) {
+        if (pos + length > size) return nullptr;
+        const std::uint8_t* start = data + pos;
+        pos += length;
+        return start;
+    }
+
+    bool atEnd() const { return pos == size; }
+};
+
+// Header check for a datagram expected to be of one type
+bool hasType(const std::uint8_t* data, std::size_t size, PacketType expected) {
+    PacketType type;
+    return readType(data, size, type) && type == expected;
+}
+
+std::uint32_t floatBits(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float bitsFloat(std::uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+// Word order: ball, paddles, score and countdown, then the 64-bit tick, seed
+// and generator (low word first). Fields that never change in a match cost
+// nothing after the first snapshot.
+void packState(const SimulationState& state, std::uint32_t (&words)[STATE_WORDS]) {
+    const BallState& ball = state.ball;
+    const float floats[] = {
+        ball.x, ball.y, ball.vx, ball.vy, ball.radius, ball.baseSpeed, ball.currentSpeed,
+        ball.speedUpFactor, ball.maxSpeedFactor,
+        state.paddle1.x, state.paddle1.y, state.paddle1.width, state.paddle1.height, state.paddle1.speed,
+        state.paddle2.x, state.paddle2.y, state.paddle2.width, state.paddle2.height, state.paddle2.speed,
+        state.countdownTimer
+    };
+    int index = 0;
+    for (float value : floats) {
+        words[index++] = floatBits(value);
+    }
+    words[index++] = static_cast<std::uint32_t>(state.score1);
+    words[index++] = static_cast<std::uint32_t>(state.score2);
+    words[index++] = static_cast<std::uint32_t>(state.countdownNumber);
+    words[index++] = (state.isCountingDown ? 1u : 0u) | (state.matchOver ? 2u : 0u);
+
+    const std::uint64_t wide[] = { state.tick, state.seed, state.rng.getState(), state.rng.getIncrement() };
+    for (std::uint64_t value : wide) {
+        words[index++] = static_cast<std::uint32_t>(value);
+        words[index++] = static_cast<std::uint32_t>(value >> 32);
+    }
+}
+
+// Inverse of packState
+void unpackState(const std::uint32_t (&words)[STATE_WORDS], SimulationState& state) {
+    float* floats[] = {
+        &state.ball.x, &state.ball.y, &state.ball.vx, &state.ball.vy, &state.ball.radius, &state.ball.baseSpeed,
+        &state.ball.currentSpeed, &state.ball.speedUpFactor, &state.ball.maxSpeedFactor,
+        &state.paddle1.x, &state.paddle1.y, &state.paddle1.width, &state.paddle1.height, &state.paddle1.speed,
+        &state.paddle2.x, &state.paddle2.y, &state.paddle2.width, &state.paddle2.height, &state.paddle2.speed,
+        &state.countdownTimer
+    };
+    int index = 0;
+    for (float* value : floats) {
+        *value = bitsFloat(words[index++]);
+    }
+    state.score1 = static_cast<int>(words[index++]);
+    state.score2 = static_cast<int>(words[index++]);
+    state.countdownNumber = static_cast<int>(words[index++]);
+    state.isCountingDown = (words[index] & 1u) != 0;
+    state.matchOver = (words[index++] & 2u) != 0;
+
+    std::uint64_t wide[4];
+    for (std::uint64_t& value : wide) {
+        value = words[index] | (static_cast<std::uint64_t>(words[index + 1]) << 32);
+        index += 2;
+    }
+    state.tick = wide[0];
+    state.seed = wide[1];
+    state.rng.setRaw(wide[2], wide[3]);
+}
+
+// Up = 1, down = 2
+std::uint8_t encodePaddleInput(const PaddleInput& input) {
+    return static_cast<std::uint8_t>((input.up ? 1 : 0) | (input.down ? 2 : 0));
+}
+
+PaddleInput decodePaddleInput(std::uint8_t code) {
+    PaddleInput input;
+    input.up = (code & 1) != 0;
+    input.down = (code & 2) != 0;
+    return input;
+}
+
+std::size_t writeHello(std::uint8_t* out, const Hello& hello) {
+    PacketWriter writer(out, PacketType::HELLO);
+    writer.writeU32(hello.nonce);
+    return writer.size();
+}
+
+// The config is the same field list a replay stores
+std::size_t writeWelcome(std::uint8_t* out, const Welcome& welcome) {
+    PacketWriter writer(out, PacketType::WELCOME);
+    writer.writeU32(welcome.nonce);
+    writer.writeU32(welcome.matchId);
+    writer.writeU8(welcome.player);
+
+    const SimulationConfig& config = welcome.config;
+    const float floats[] = {
+        config.fieldWidth, config.fieldHeight, config.ballRadius, config.ballSpeed, config.speedUpFactor,
+        config.maxSpeedFactor, config.paddleWidth, config.paddleHeight, config.paddleSpeed, config.paddle1X,
+        config.paddle2X, config.paddleStartY
+    };
+    for (float value : floats) {
+        writer.writeFloat(value);
+    }
+    writer.writeU32(static_cast<std::uint32_t>(config.maxScore));
+    writer.writeU32(static_cast<std::uint32_t>(config.tickRate));
+    writer.writeU8(config.continuousCollision ? 1 : 0);
+    return writer.size();
+}
+
+// Codes are packed four to a byte
+std::size_t writeInput(std::uint8_t* out, const InputPacket& input) {
+    PacketWriter writer(out, PacketType::INPUT);
+    writer.writeU32(input.matchId);
+    writer.writeU8(input.player);
+    writer.writeU32(input.ackTick);
+    writer.writeU32(input.lastTick);
+    int count = input.count < MAX_INPUTS_PER_PACKET ? input.count : MAX_INPUTS_PER_PACKET;
+    writer.writeU8(static_cast<std::uint8_t>(count));
+    std::uint8_t* packed = writer.reserve(static_cast<std::size_t>(count + 3) / 4);
+    for (int i = 0; i < count; i++) {
+        packed[i / 4] |= static_cast<std::uint8_t>((input.codes[i] & 3) << (2 * (i % 4)));
+    }
+    return writer.size();
+}
+
+// Mask bit i set: word i differs from the baseline and follows, in order
+std::size_t writeSnapshot(std::uint8_t* out, const SnapshotHeader& header,
+                          const std::uint32_t (&words)[STATE_WORDS], const std::uint32_t (&baseline)[STATE_WORDS]) {
+    PacketWriter writer(out, PacketType::SNAPSHOT);
+    writer.writeU32(header.matchId);
+    writer.writeU32(header.tick);
+    writer.writeU32(header.baselineTick);
+    writer.writeU32(header.inputTick);
+    writer.writeU8(header.inputs);
+    std::uint8_t* mask = writer.reserve(MASK_BYTES);
+    for (int i = 0; i < STATE_WORDS; i++) {
+        if (words[i] != baseline[i]) {
+            mask[i / 8] |= static_cast<std::uint8_t>(1u << (i % 8));
+            writer.writeU32(words[i]);
+        }
+    }
+    return writer.size();
+}
+
+std::size_t writeBye(std::uint8_t* out, const Bye& bye) {
+    PacketWriter writer(out, PacketType::BYE);
+    writer.writeU32(bye.matchId);
+    writer.writeU8(bye.player);
+    return writer.size();
+}
+
+// Check magic and version and return the packet type
+bool readType(const std::uint8_t* data, std::size_t size, PacketType& type) {
+    if (size < HEADER_SIZE || size > MAX_PACKET_SIZE || data[0] != MAGIC[0] || data[1] != MAGIC[1] ||
+        data[2] != PROTOCOL_VERSION || data[3] < static_cast<std::uint8_t>(PacketType::HELLO) ||
+        data[3] > static_cast<std::uint8_t>(PacketType::BYE)) {
+        return false;
+    }
+    type = static_cast<PacketType>(data[3]);
+    return true;
+}
+
+bool readHello(const std::uint8_t* data, std::size_t size, Hello& hello) {
+    PacketReader reader(data, size);
+    return hasType(data, size, PacketType::HELLO) && reader.readU32(hello.nonce) && reader.atEnd();
+}
+
+bool readWelcome(const std::uint8_t* data, std::size_t size, Welcome& welcome) {
+    if (!hasType(data, size, PacketType::WELCOME)) {
+        return false;
+    }
+    PacketReader reader(data, size);
+    SimulationConfig& config = welcome.config;
+    std::uint8_t continuous = 0;
+    bool ok = reader.readU32(welcome.nonce) && reader.readU32(welcome.matchId) && reader.readU8(welcome.player) &&
+              reader.readFloat(config.fieldWidth) && reader.readFloat(config.fieldHeight) &&
+              reader.readFloat(config.ballRadius) && reader.readFloat(config.ballSpeed) &&
+              reader.readFloat(config.speedUpFactor) && reader.readFloat(config.maxSpeedFactor) &&
+              reader.readFloat(config.paddleWidth) && reader.readFloat(config.paddleHeight) &&
+              reader.readFloat(config.paddleSpeed) && reader.readFloat(config.paddle1X) &&
+              reader.readFloat(config.paddle2X) && reader.readFloat(config.paddleStartY) &&
+              reader.readInt(config.maxScore) && reader.readInt(config.tickRate) && reader.readU8(continuous) &&
+              reader.atEnd();
+    config.continuousCollision = continuous != 0;
+    return ok && config.tickRate > 0 && (welcome.player == 1 || welcome.player == 2);
+}
+
+bool readInput(const std::uint8_t* data, std::size_t size, InputPacket& input) {
+    if (!hasType(data, size, PacketType::INPUT)) {
+        return false;
+    }
+    PacketReader reader(data, size);
+    if (!reader.readU32(input.matchId) || !reader.readU8(input.player) || !reader.readU32(input.ackTick) ||
+        !reader.readU32(input.lastTick) || !reader.readU8(input.count) || input.count > MAX_INPUTS_PER_PACKET) {
+        return false;
+    }
+    const std::uint8_t* packed = reader.skip(static_cast<std::size_t>(input.count + 3) / 4);
+    if (!packed || !reader.atEnd()) {
+        return false;
+    }
+    for (int i = 0; i < input.count; i++) {
+        input.codes[i] = static_cast<std::uint8_t>((packed[i / 4] >> (2 * (i % 4))) & 3);
+    }
+    return true;
+}
+
+bool readBye(const std::uint8_t* data, std::size_t size, Bye& bye) {
+    PacketReader reader(data, size);
+    return hasType(data, size, PacketType::BYE) && reader.readU32(bye.matchId) && reader.readU8(bye.player) &&
+           reader.atEnd();
+}
+
+bool readSnapshotHeader(const std::uint8_t* data, std::size_t size, SnapshotHeader& header) {
+    PacketReader reader(data, size);
+    return hasType(data, size, PacketType::SNAPSHOT) && reader.readU32(header.matchId) &&
+           reader.readU32(header.tick) && reader.readU32(header.baselineTick) && reader.readU32(header.inputTick) &&
+           reader.readU8(header.inputs);
+}
+
+// Start from the baseline and overwrite the words the mask lists
+bool readSnapshotBody(const std::uint8_t* data, std::size_t size, const std::uint32_t (&baseline)[STATE_WORDS],
+                      std::uint32_t (&words)[STATE_WORDS]) {
+    PacketReader reader(data, size);
+    SnapshotHeader header;
+    if (!readSnapshotHeader(data, size, header) || !reader.skip(SNAPSHOT_HEADER_SIZE)) {
+        return false;
+    }
+    const std::uint8_t* mask = reader.skip(MASK_BYTES);
+    if (!mask) {
+        return false;
+    }
+    for (int i = 0; i < STATE_WORDS; i++) {
+        words[i] = baseline[i];
+        if ((mask[i / 8] >> (i % 8)) & 1u) {
+            if (!reader.readU32(words[i])) {
+                return false;
+            }
+        }
+    }
+    return reader.atEnd();
+}
+
+} // namespace net
@@ -0,0 +1,82 @@
+#include "PaddleAI.h"
+
+// Constructor
+PaddleAI::PaddleAI(ControllerType controllerType, int playerNumber, std::uint64_t seed, const PaddleAIConfig& cfg)
+    : type(controllerType), config(cfg), player(playerNumber), rng(seed, static_cast<std::uint64_t>(playerNumber)),
+      ticksUntilThink(0), targetY(0.0f), sweepingDown(true) {
+}
+
+// Choose where the paddle center should go
+float PaddleAI::pickTarget(const BallState& ball, const PaddleState& paddle) {
+    bool incoming = (player == 1) ? ball.vx < 0 : ball.vx > 0;
+
+    if (!incoming) {
+        // Hold position until the ball heads this way
+        return paddle.y + paddle.height / 2.0f;
+    }
+
+    return ball.y + ball.radius + rng.uniform(-config.aimError, config.aimError);
+}
+
+// Input that moves a paddle center toward a target
+PaddleInput PaddleAI::follow(float center, float targetY, float deadZone) {
+    PaddleInput input;
+    if (center > targetY + deadZone) {
+        input.up = true;
+    } else if (center < targetY - deadZone) {
+        input.down = true;
+    }
+    return input;
+}
+
+// Decide this tick's input
+PaddleInput PaddleAI::think(const SimulationState& state, const SimulationConfig& simConfig) {
+    const PaddleState& paddle = (player == 1) ? state.paddle1 : state.paddle2;
+    return think(state.ball, paddle, simConfig.fieldHeight);
+}
+
+// Decide this tick's input from just the ball and this paddle
+PaddleInput PaddleAI::think(const BallState& ball, const PaddleState& paddle, float fieldHeight) {
+    PaddleInput input;
+
+    switch (type) {
+        case ControllerType::IDLE:
+            break;
+
+        case ControllerType::SWEEP:
+            if (paddle.y <= 0.0f) {
+                sweepingDown = true;
+            } else if (paddle.y + paddle.height >= fieldHeight) {
+                sweepingDown = false;
+            }
+            input.down = sweepingDown;
+            input.up = !sweepingDown;
+            break;
+
+        case ControllerType::AI: {
+            if (--ticksUntilThink <= 0) {
+                targetY = pickTarget(ball, paddle);
+                ticksUntilThink = config.reactionTicks;
+            }
+
+            input = follow(paddle.y + paddle.height / 2.0f, targetY, config.deadZone);
+            break;
+        }
+    }
+
+    return input;
+}
+
+// Parse a controller name
+bool PaddleAI::parseType(const std::string& name, ControllerType& out) {
+    if (name == "ai") {
+        out = ControllerType::AI;
+    } else if (name == "idle") {
+        out = ControllerType::IDLE;
+    } else if (name == "sweep") {
+        out = ControllerType::SWEEP;
+    } else {
+        return false;
+    }
+    return true;
+}
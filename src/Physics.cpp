@@ -0,0 +1,290 @@
+#include "Physics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace physics {
+
+// Move paddle up
+void movePaddleUp(PaddleState& paddle, float deltaTime) {
+    float newY = paddle.y - paddle.speed * deltaTime;
+    paddle.y = (newY >= 0) ? newY : 0.0f;
+}
+
+// Move paddle down
+void movePaddleDown(PaddleState& paddle, float deltaTime, float fieldHeight) {
+    float newY = paddle.y + paddle.speed * deltaTime;
+    float maxY = fieldHeight - paddle.height;
+    paddle.y = (newY <= maxY) ? newY : maxY;
+}
+
+// Apply one tick of input to a paddle
+void updatePaddle(PaddleState& paddle, const PaddleInput& input, float deltaTime, float fieldHeight) {
+    if (input.up) {
+        movePaddleUp(paddle, deltaTime);
+    }
+    if (input.down) {
+        movePaddleDown(paddle, deltaTime, fieldHeight);
+    }
+}
+
+// Update ball position
+bool updateBall(BallState& ball, float deltaTime, float fieldHeight) {
+    ball.x += ball.vx * deltaTime;
+    ball.y += ball.vy * deltaTime;
+
+    // Check wall collisions (top and bottom)
+    if (checkWallCollision(ball, fieldHeight)) {
+        ball.vy = -ball.vy;
+        return true;
+    }
+    return false;
+}
+
+// Check collision with top/bottom walls
+bool checkWallCollision(BallState& ball, float fieldHeight) {
+    float diameter = ball.radius * 2.0f;
+
+    if (ball.y <= 0) {
+        ball.y = 0;
+        return true;
+    }
+
+    if (ball.y + diameter >= fieldHeight) {
+        ball.y = fieldHeight - diameter;
+        return true;
+    }
+
+    return false;
+}
+
+// Check collision with paddle
+bool checkPaddleCollision(BallState& ball, const PaddleState& paddle) {
+    float diameter = ball.radius * 2.0f;
+
+    // Bounding box overlap (same strict test as sf::FloatRect::intersects)
+    bool overlaps = ball.x < paddle.x + paddle.width && paddle.x < ball.x + diameter &&
+                    ball.y < paddle.y + paddle.height && paddle.y < ball.y + diameter;
+    if (!overlaps) {
+        return false;
+    }
+
+    bounceOffPaddle(ball, paddle);
+    return true;
+}
+
+// Paddle response
+void bounceOffPaddle(BallState& ball, const PaddleState& paddle) {
+    float diameter = ball.radius * 2.0f;
+
+    // Calculate relative position where ball hit the paddle
+    float paddleCenter = paddle.y + paddle.height / 2.0f;
+    float ballCenter = ball.y + diameter / 2.0f;
+    float relativeIntersection = (ballCenter - paddleCenter) / (paddle.height / 2.0f);
+
+    // Reverse horizontal direction
+    ball.vx = -ball.vx;
+
+    // Adjust vertical velocity based on where it hit the paddle
+    ball.vy = relativeIntersection * ball.currentSpeed * 0.75f;
+
+    // Increase speed slightly with each hit (capped at a multiple of base speed)
+    ball.currentSpeed = std::min(ball.currentSpeed * ball.speedUpFactor, ball.baseSpeed * ball.maxSpeedFactor);
+
+    // Update velocity magnitude
+    float magnitude = std::sqrt(ball.vx * ball.vx + ball.vy * ball.vy);
+    ball.vx = (ball.vx / magnitude) * ball.currentSpeed;
+    ball.vy = (ball.vy / magnitude) * ball.currentSpeed;
+
+    // Move ball slightly away from paddle to prevent multiple collisions
+    if (ball.vx > 0) {
+        ball.x = paddle.x + paddle.width + 1;
+    } else {
+        ball.x = paddle.x - diameter - 1;
+    }
+}
+
+// Swept circle vs paddle rectangle: a ray from the ball center against the
+// paddle grown by the radius, with rounded corners
+float paddleTimeOfImpact(const BallState& ball, const PaddleState& paddle, float maxTime) {
+    float r = ball.radius;
+    float cx = ball.x + r;
+    float cy = ball.y + r;
+    float left = paddle.x;
+    float right = paddle.x + paddle.width;
+    float top = paddle.y;
+    float bottom = paddle.y + paddle.height;
+
+    // Slab test against the expanded box
+    float tEnter = 0.0f;
+    float tExit = maxTime;
+    if (ball.vx == 0.0f) {
+        if (cx < left - r || cx > right + r) {
+            return -1.0f;
+        }
+    } else {
+        float t1 = (left - r - cx) / ball.vx;
+        float t2 = (right + r - cx) / ball.vx;
+        tEnter = std::max(tEnter, std::min(t1, t2));
+        tExit = std::min(tExit, std::max(t1, t2));
+    }
+    if (ball.vy == 0.0f) {
+        if (cy < top - r || cy > bottom + r) {
+            return -1.0f;
+        }
+    } else {
+        float t1 = (top - r - cy) / ball.vy;
+        float t2 = (bottom + r - cy) / ball.vy;
+        tEnter = std::max(tEnter, std::min(t1, t2));
+        tExit = std::min(tExit, std::max(t1, t2));
+    }
+    if (tEnter > tExit) {
+        return -1.0f;
+    }
+
+    // Entry point on a face (not a corner) is an exact hit
+    float hx = cx + ball.vx * tEnter;
+    float hy = cy + ball.vy * tEnter;
+    if ((hx >= left && hx <= right) || (hy >= top && hy <= bottom)) {
+        return tEnter;
+    }
+
+    // Corner region: solve |center + v*t - corner| = r
+    float cornerX = (hx < left) ? left : right;
+    float cornerY = (hy < top) ? top : bottom;
+    float ox = cx - cornerX;
+    float oy = cy - cornerY;
+    float a = ball.vx * ball.vx + ball.vy * ball.vy;
+    float b = 2.0f * (ox * ball.vx + oy * ball.vy);
+    float c = ox * ox + oy * oy - r * r;
+
+    if (c <= 0.0f) {
+        return tEnter; // Already touching the corner
+    }
+    float discriminant = b * b - 4.0f * a * c;
+    if (a == 0.0f || discriminant < 0.0f) {
+        return -1.0f;
+    }
+
+    float t = (-b - std::sqrt(discriminant)) / (2.0f * a);
+    if (t < tEnter || t > tExit) {
+        return -1.0f;
+    }
+    return t;
+}
+
+// Move the ball through a whole step with continuous collision
+void sweepBall(BallState& ball, const PaddleState& paddle1, const PaddleState& paddle2,
+               float deltaTime, float fieldHeight, bool& wallHit, bool& paddleHit) {
+    const int maxImpacts = 8; // Plenty: a step rarely has more than two
+    float diameter = ball.radius * 2.0f;
+    float remaining = deltaTime;
+
+    for (int i = 0; i < maxImpacts && remaining > 0.0f; i++) {
+        enum { NONE, WALL, PADDLE1, PADDLE2 } hit = NONE;
+        float tHit = remaining;
+
+        // Walls
+        if (ball.vy < 0.0f) {
+            float t = std::max((0.0f - ball.y) / ball.vy, 0.0f);
+            if (t <= tHit) {
+                tHit = t;
+                hit = WALL;
+            }
+        } else if (ball.vy > 0.0f) {
+            float t = std::max((fieldHeight - diameter - ball.y) / ball.vy, 0.0f);
+            if (t <= tHit) {
+                tHit = t;
+                hit = WALL;
+            }
+        }
+
+        // Paddles
+        float t1 = paddleTimeOfImpact(ball, paddle1, tHit);
+        if (t1 >= 0.0f && (hit == NONE || t1 < tHit)) {
+            tHit = t1;
+            hit = PADDLE1;
+        }
+        float t2 = paddleTimeOfImpact(ball, paddle2, tHit);
+        if (t2 >= 0.0f && (hit == NONE || t2 < tHit)) {
+            tHit = t2;
+            hit = PADDLE2;
+        }
+
+        // Advance to the impact (or the end of the step)
+        ball.x += ball.vx * tHit;
+        ball.y += ball.vy * tHit;
+        remaining -= tHit;
+
+        if (hit == NONE) {
+            return;
+        }
+        if (hit == WALL) {
+            ball.y = (ball.vy < 0.0f) ? 0.0f : fieldHeight - diameter;
+            ball.vy = -ball.vy;
+            wallHit = true;
+        } else {
+            bounceOffPaddle(ball, (hit == PADDLE1) ? paddle1 : paddle2);
+            paddleHit = true;
+        }
+    }
+
+    // Out of impact budget: finish the step without further resolution
+    if (remaining > 0.0f) {
+        ball.x += ball.vx * remaining;
+        ball.y += ball.vy * remaining;
+        if (checkWallCollision(ball, fieldHeight)) {
+            ball.vy = -ball.vy;
+            wallHit = true;
+        }
+    }
+}
+
+// Check if ball went out of bounds (scoring)
+int checkScore(const BallState& ball, float fieldWidth) {
+    // Player 1 scores (ball went past right edge)
+    if (ball.x > fieldWidth) {
+        return 1;
+    }
+
+    // Player 2 scores (ball went past left edge)
+    if (ball.x + ball.radius * 2 < 0) {
+        return 2;
+    }
+
+    return 0;
+}
+
+// Run the countdown clock; clears isCountingDown after the last number
+void updateCountdown(bool& isCountingDown, float& countdownTimer, int& countdownNumber, float deltaTime) {
+    countdownTimer -= deltaTime;
+
+    if (countdownTimer <= 0.0f) {
+        countdownNumber--;
+        if (countdownNumber > 0) {
+            countdownTimer = 1.0f;
+        } else {
+            isCountingDown = false;
+        }
+    }
+}
+
+// Reset ball to center with random direction
+void resetBall(BallState& ball, float fieldWidth, float fieldHeight, Random& rng) {
+    // Reset position to center
+    ball.x = fieldWidth / 2.0f - ball.radius;
+    ball.y = fieldHeight / 2.0f - ball.radius;
+
+    // Reset speed
+    ball.currentSpeed = ball.baseSpeed;
+
+    // Random direction (left or right)
+    float directionX = (rng.nextBelow(2) == 0) ? 1.0f : -1.0f;
+
+    // Random angle between -45 and 45 degrees
+    float angle = (static_cast<int>(rng.nextBelow(90)) - 45) * 3.14159f / 180.0f;
+
+    ball.vx = directionX * ball.currentSpeed * std::cos(angle);
+    ball.vy = ball.currentSpeed * std::sin(angle);
+}
+
+} // namespace physics
@@ -0,0 +1,76 @@
+#include "PlayfieldRenderer.h"
+#include <cmath>
+
+namespace {
+const std::size_t VERTICES_PER_RECT = 6; // Two triangles
+}
+
+// Constructor
+PlayfieldRenderer::PlayfieldRenderer(float fieldWidth, float fieldHeight, unsigned segments)
+    : centerLine(sf::Triangles), dynamicBatch(sf::Triangles), ballSegments(segments) {
+    buildCenterLine(fieldWidth, fieldHeight);
+    
+    // Two paddles, then the ball as a triangle fan unrolled into triangles
+    dynamicBatch.resize(2 * VERTICES_PER_RECT + ballSegments * 3);
+}
+
+// Dashed center line: 2x10 dashes every 20 pixels
+void PlayfieldRenderer::buildCenterLine(float fieldWidth, float fieldHeight) {
+    const sf::Color lineColor(100, 100, 100);
+    float x = fieldWidth / 2.0f - 1.0f;
+    
+    for (float y = 0; y < fieldHeight; y += 20.0f) {
+        sf::Vector2f topLeft(x, y);
+        sf::Vector2f topRight(x + 2.0f, y);
+        sf::Vector2f bottomLeft(x, y + 10.0f);
+        sf::Vector2f bottomRight(x + 2.0f, y + 10.0f);
+        
+        centerLine.append(sf::Vertex(topLeft, lineColor));
+        centerLine.append(sf::Vertex(topRight, lineColor));
+        centerLine.append(sf::Vertex(bottomRight, lineColor));
+        centerLine.append(sf::Vertex(topLeft, lineColor));
+        centerLine.append(sf::Vertex(bottomRight, lineColor));
+        centerLine.append(sf::Vertex(bottomLeft, lineColor));
+    }
+}
+
+// Overwrite six vertices with an axis-aligned rectangle
+void PlayfieldRenderer::writeRect(std::size_t first, float x, float y, float width, float height, const sf::Color& color) {
+    sf::Vertex* quad = &dynamicBatch[first];
+    quad[0] = sf::Vertex(sf::Vector2f(x, y), color);
+    quad[1] = sf::Vertex(sf::Vector2f(x + width, y), color);
+    quad[2] = sf::Vertex(sf::Vector2f(x + width, y + height), color);
+    quad[3] = sf::Vertex(sf::Vector2f(x, y), color);
+    quad[4] = sf::Vertex(sf::Vector2f(x + width, y + height), color);
+    quad[5] = sf::Vertex(sf::Vector2f(x, y + height), color);
+}
+
+// Refresh the dynamic batch
+void PlayfieldRenderer::update(const SimulationState& state) {
+    const PaddleState& p1 = state.paddle1;
+    const PaddleState& p2 = state.paddle2;
+    writeRect(0, p1.x, p1.y, p1.width, p1.height, sf::Color::White);
+    writeRect(VERTICES_PER_RECT, p2.x, p2.y, p2.width, p2.height, sf::Color::White);
+    
+    // Ball: same outline as sf::CircleShape (point 0 at the top)
+    const BallState& ball = state.ball;
+    sf::Vector2f center(ball.x + ball.radius, ball.y + ball.radius);
+    std::size_t index = 2 * VERTICES_PER_RECT;
+    const float step = 2.0f * 3.14159265f / ballSegments;
+    
+    for (unsigned i = 0; i < ballSegments; i++) {
+        float a0 = i * step - 3.14159265f / 2.0f;
+        float a1 = (i + 1) * step - 3.14159265f / 2.0f;
+        dynamicBatch[index++] = sf::Vertex(center, sf::Color::White);
+        dynamicBatch[index++] = sf::Vertex(sf::Vector2f(center.x + ball.radius * std::cos(a0),
+                                                        center.y + ball.radius * std::sin(a0)), sf::Color::White);
+        dynamicBatch[index++] = sf::Vertex(sf::Vector2f(center.x + ball.radius * std::cos(a1),
+                                                        center.y + ball.radius * std::sin(a1)), sf::Color::White);
+    }
+}
+
+// Draw the playfield
+void PlayfieldRenderer::render(sf::RenderTarget& target) const {
+    target.draw(centerLine);
+    target.draw(dynamicBatch);
+}
@@ -0,0 +1,159 @@
+#include "ProfileIndex.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+// Constructor
+ProfileIndex::ProfileIndex() : sorted(std::make_shared<std::vector<std::uint32_t>>()) {
+    slots.assign(16, Slot{ 0, EMPTY });
+}
+
+// Hash of a name
+std::size_t ProfileIndex::hashName(std::string_view name) {
+    return std::hash<std::string_view>()(name);
+}
+
+// Slot holding the name, or the empty slot where it would go
+std::size_t ProfileIndex::findSlot(std::string_view name, std::size_t hash) const {
+    std::size_t mask = slots.size() - 1;
+    std::uint32_t tag = static_cast<std::uint32_t>(hash);
+    std::size_t pos = hash & mask;
+    
+    while (true) {
+        const Slot& slot = slots[pos];
+        if (slot.entry == EMPTY) {
+            return pos;
+        }
+        if (slot.hash == tag && names[slot.entry] == name) {
+            return pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+}
+
+// Double the table and re-insert every entry
+void ProfileIndex::grow() {
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, Slot{ 0, EMPTY });
+    
+    std::size_t mask = slots.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.entry == EMPTY) {
+            continue;
+        }
+        // Only 32 bits of the hash are kept, so recompute it for the new mask
+        std::size_t pos = hashName(names[slot.entry]) & mask;
+        while (slots[pos].entry != EMPTY) {
+            pos = (pos + 1) & mask;
+        }
+        slots[pos] = slot;
+    }
+}
+
+// A stored profile to modify; a block some View still holds is copied
+// first. use_count() is only a hint across threads, so a count of one is
+// followed by an acquire fence: the View's reads, which end before it
+// releases the block, then happen before the writes that follow.
+UserProfile& ProfileIndex::writableEntry(std::uint32_t entry) {
+    std::shared_ptr<Block>& block = blocks[entry / BLOCK_SIZE];
+    if (block.use_count() > 1) {
+        block = std::make_shared<Block>(*block);
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return block->profiles[entry % BLOCK_SIZE];
+}
+
+// Remove everything (views keep what they share)
+void ProfileIndex::clear() {
+    blocks.clear();
+    names.clear();
+    sorted = std::make_shared<std::vector<std::uint32_t>>();
+    slots.assign(16, Slot{ 0, EMPTY });
+}
+
+// Make room for a number of profiles without rehashing
+void ProfileIndex::reserve(std::size_t count) {
+    blocks.reserve((count + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    if (sorted.use_count() == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        sorted->reserve(count);
+    }
+    while (count * 10 >= slots.size() * 7) {
+        grow();
+    }
+}
+
+// Find a profile by name
+UserProfile* ProfileIndex::find(std::string_view name) {
+    const Slot& slot = slots[findSlot(name, hashName(name))];
+    return slot.entry == EMPTY ? nullptr : &writableEntry(slot.entry);
+}
+
+// Find a profile by name
+const UserProfile* ProfileIndex::find(std::string_view name) const {
+    const Slot& slot = slots[findSlot(name, hashName(name))];
+    return slot.entry == EMPTY ? nullptr : &entryAt(slot.entry);
+}
+
+// Insert or overwrite
+UserProfile& ProfileIndex::insertOrAssign(UserProfile profile) {
+    std::size_t hash = hashName(profile.username);
+    std::size_t pos = findSlot(profile.username, hash);
+    if (slots[pos].entry != EMPTY) {
+        UserProfile& existing = writableEntry(slots[pos].entry);
+        existing = std::move(profile);
+        return existing;
+    }
+    
+    // Keep the load factor under 0.7
+    if ((names.size() + 1) * 10 >= slots.size() * 7) {
+        grow();
+        pos = findSlot(profile.username, hash);
+    }
+    
+    std::uint32_t entry = static_cast<std::uint32_t>(names.size());
+    if (entry % BLOCK_SIZE == 0) {
+        blocks.push_back(std::make_shared<Block>());
+    }
+    names.push_back(profile.username);
+    UserProfile& stored = writableEntry(entry);
+    stored = std::move(profile);
+    slots[pos] = Slot{ static_cast<std::uint32_t>(hash), entry };
+    
+    // Ascending inserts append; anything else is placed by binary search.
+    // An order a view still shares is copied first.
+    const std::string& name = names[entry];
+    std::size_t rank = (sorted->empty() || names[sorted->back()] < name) ? sorted->size() : lowerBound(name);
+    if (sorted.use_count() > 1) {
+        sorted = std::make_shared<std::vector<std::uint32_t>>(*sorted);
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    sorted->insert(sorted->begin() + rank, entry);
+    return stored;
+}
+
+// Binary search over the sorted side index
+std::size_t ProfileIndex::lowerBound(std::string_view name) const {
+    auto it = std::lower_bound(sorted->begin(), sorted->end(), name,
+                               [this](std::uint32_t entry, std::string_view value) {
+                                   return std::string_view(names[entry]) < value;
+                               });
+    return static_cast<std::size_t>(it - sorted->begin());
+}
+
+// Stable copy of a stored name
+std::string_view ProfileIndex::storedName(std::string_view name) const {
+    const Slot& slot = slots[findSlot(name, hashName(name))];
+    return slot.entry == EMPTY ? std::string_view() : std::string_view(names[slot.entry]);
+}
+
+// Share the current blocks and order
+ProfileIndex::View ProfileIndex::view() const {
+    View shared;
+    shared.blocks.assign(blocks.begin(), blocks.end());
+    shared.sorted = sorted;
+    return shared;
+}
@@ -1,89 +1,459 @@
 #include "ProfileManager.h"
+#include "ProfileWriter.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 
+namespace {
+
+// SAX handler for profiles.json. Accepts the snapshot object
+// {"generation", "lastSequence", "profiles": [...]} and the older bare
+// array, building each UserProfile as its fields stream past - no DOM.
+class ProfileSaxReader : public nlohmann::json_sax<json> {
+private:
+    ProfileIndex& profiles;
+    int depth;
+    int profilesDepth;     // Depth of the profiles array, 0 when outside it
+    bool rootIsObject;
+    bool inProfile;
+    std::string currentKey;
+    UserProfile current;
+    std::uint64_t generation;
+    std::uint64_t lastSequence;
+    std::string error;
+
+    bool atRoot() const { return rootIsObject && depth == 1; }
+    bool atProfileField() const { return inProfile && depth == profilesDepth + 1; }
+    bool atRootChild() const { return rootIsObject && depth == 2; }
+
+    // Integer fields of the root object or of a profile
+    bool setNumber(std::int64_t value) {
+        if (atProfileField()) {
+            if (currentKey == "wins") current.wins = static_cast<int>(value);
+            else if (currentKey == "losses") current.losses = static_cast<int>(value);
+            else if (currentKey == "totalGames") current.totalGames = static_cast<int>(value);
+            else if (currentKey == "rating") current.rating = static_cast<int>(value);
+        } else if (atRoot()) {
+            if (currentKey == "generation") generation = static_cast<std::uint64_t>(value);
+            else if (currentKey == "lastSequence") lastSequence = static_cast<std::uint64_t>(value);
+        }
+        return true;
+    }
+
+public:
+    explicit ProfileSaxReader(ProfileIndex& target)
+        : profiles(target), depth(0), profilesDepth(0), rootIsObject(false), inProfile(false),
+          generation(0), lastSequence(0) {}
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t value) override { return setNumber(value); }
+    bool number_unsigned(number_unsigned_t value) override { return setNumber(static_cast<std::int64_t>(value)); }
+    bool number_float(number_float_t value, const string_t&) override { return setNumber(static_cast<std::int64_t>(value)); }
+    bool binary(binary_t&) override { return true; }
+
+    bool string(string_t& value) override {
+        if (atProfileField() && currentKey == "username") {
+            current.username = std::move(value);
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        depth++;
+        if (depth == 1) {
+            rootIsObject = true;
+        } else if (profilesDepth > 0 && depth == profilesDepth + 1) {
+            inProfile = true;
+            current = UserProfile();
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (atProfileField()) {
+            inProfile = false;
+            if (!current.username.empty()) {
+                // Snapshots are written in name order, so this appends at the end
+                profiles.insertOrAssign(std::move(current));
+            }
+        }
+        depth--;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        depth++;
+        if (depth == 1 || (atRootChild() && currentKey == "profiles")) {
+            profilesDepth = depth;
+        }
+        return true;
+    }
+
+    bool end_array() override {
+        if (depth == profilesDepth) {
+            profilesDepth = 0;
+        }
+        depth--;
+        return true;
+    }
+
+    bool key(string_t& value) override {
+        currentKey = value;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& e) override {
+        error = e.what();
+        return false;
+    }
+
+    std::uint64_t getGeneration() const { return generation; }
+    std::uint64_t getLastSequence() const { return lastSequence; }
+    const std::string& getError() const { return error; }
+};
+
+// Elo points the winner of a match takes from the loser (K = 32)
+int eloTransfer(int winnerRating, int loserRating) {
+    double expected = 1.0 / (1.0 + std::pow(10.0, (loserRating - winnerRating) / 400.0));
+    return static_cast<int>(std::lround(32.0 * (1.0 - expected)));
+}
+
+// True if name starts with prefix
+bool hasPrefix(std::string_view name, std::string_view prefix) {
+    return name.substr(0, prefix.size()) == prefix;
+}
+
+// Smallest string sorting after every name that starts with prefix
+// ("" when there is none, i.e. the range runs to the end)
+std::string prefixEnd(std::string_view prefix) {
+    std::string end(prefix);
+    while (!end.empty() && static_cast<unsigned char>(end.back()) == 0xff) {
+        end.pop_back();
+    }
+    if (!end.empty()) {
+        end.back() = static_cast<char>(static_cast<unsigned char>(end.back()) + 1);
+    }
+    return end;
+}
+
+} // namespace
+
 // Constructor
-ProfileManager::ProfileManager(const std::string& profilePath)
-    : filepath(profilePath) {
+ProfileManager::ProfileManager(const std::string& profilePath, std::uint64_t compactInterval)
+    : ProfileManager(ProfileStoreConfig{ profilePath, ProfileFormat::JSON, compactInterval }) {
+}
+
+// Constructor
+ProfileManager::ProfileManager(const ProfileStoreConfig& config)
+    : base(std::make_shared<BinaryProfileStore>()), filepath(config.path), journalPath(config.path + ".journal"), format(config.format),
+      writer(std::make_unique<ProfileWriter>(filepath, journalPath, format)),
+      generation(0), nextSequence(1), journalEntries(0), compactEvery(config.compactEvery),
+      leaderboardsBuilt(false) {
     loadProfiles();
 }
 
-// Load profiles from JSON file
+// Destructor
+ProfileManager::~ProfileManager() {
+    // ProfileWriter's destructor writes whatever is still queued
+}
+
+// Load the snapshot, then replay the journal on top of it
 bool ProfileManager::loadProfiles() {
-    std::ifstream file(filepath);
+    dropLeaderboards();
+    base = std::make_shared<BinaryProfileStore>();
+    profiles.clear();
+    generation = 0;
+    nextSequence = 1;
+    journalEntries = 0;
+    
+    bool loaded = (format == ProfileFormat::BINARY) ? loadBinarySnapshot() : loadSnapshot();
+    bool journalUsed = replayJournal(nextSequence - 1);
+    
+    if (loaded || journalEntries > 0) {
+        std::cout << "Loaded " << getProfileCount() << " profiles";
+        if (journalEntries > 0) {
+            std::cout << " (" << journalEntries << " journal entries replayed)";
+        }
+        std::cout << "." << std::endl;
+    }
+    
+    // Start from an empty journal so new entries never follow a torn line
+    if (journalUsed) {
+        saveProfiles();
+    }
+    return loaded;
+}
+
+// Load profiles from the JSON snapshot, streaming records straight into the map
+bool ProfileManager::loadSnapshot() {
+    std::ifstream file(filepath, std::ios::binary);
     
     if (!file.is_open()) {
         std::cout << "No existing profiles found. Creating new profile database." << std::endl;
         return false;
     }
     
-    try {
-        json j;
-        file >> j;
-        file.close();
+    ProfileSaxReader reader(profiles);
+    if (!json::sax_parse(file, &reader)) {
+        std::cerr << "Error parsing profiles.json: " << reader.getError() << std::endl;
+        return false;
+    }
+    generation = reader.getGeneration();
+    nextSequence = reader.getLastSequence() + 1;
+    return true;
+}
+
+// Map the binary snapshot; on first use, import a profiles.json next to it
+bool ProfileManager::loadBinarySnapshot() {
+    // A fresh store, as the old one may still be shared with a queued snapshot
+    auto store = std::make_shared<BinaryProfileStore>();
+    if (store->open(filepath)) {
+        generation = store->getGeneration();
+        nextSequence = store->getLastSequence() + 1;
+        base = std::move(store);
+        return true;
+    }
+    
+    std::string jsonPath = filepath;
+    std::size_t dot = jsonPath.find_last_of('.');
+    if (dot != std::string::npos && jsonPath.find_first_of("/\\", dot) == std::string::npos) {
+        jsonPath.erase(dot);
+    }
+    jsonPath += ".json";
+    
+    if (jsonPath != filepath && std::ifstream(jsonPath).good()) {
+        std::cout << "Converting " << jsonPath << " to " << filepath << std::endl;
+        return importJson(jsonPath);
+    }
+    
+    std::cout << "No existing profiles found. Creating new profile database." << std::endl;
+    return false;
+}
+
+// Apply journal entries newer than the snapshot; stops at a torn last line.
+// Returns true if the journal had any content.
+bool ProfileManager::replayJournal(std::uint64_t snapshotSequence) {
+    std::ifstream file(journalPath);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    bool hasContent = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        hasContent = true;
+        json entry = json::parse(line, nullptr, false);
+        if (entry.is_discarded() || !entry.is_object() || !entry.contains("seq") ||
+            !entry["seq"].is_number_unsigned()) {
+            std::cerr << "Ignoring damaged profile journal tail in " << journalPath << std::endl;
+            break;
+        }
         
-        // Parse JSON array of profiles
-        if (j.is_array()) {
-            for (const auto& item : j) {
-                UserProfile profile;
-                profile.username = item["username"].get<std::string>();
-                profile.wins = item["wins"].get<int>();
-                profile.losses = item["losses"].get<int>();
-                profile.totalGames = item["totalGames"].get<int>();
-                
-                profiles[profile.username] = profile;
+        std::uint64_t sequence = entry["seq"].get<std::uint64_t>();
+        if (sequence <= snapshotSequence) {
+            continue; // Already in the snapshot (crash before truncation)
+        }
+        if (applyEntry(entry)) {
+            journalEntries++;
+        }
+        if (sequence >= nextSequence) {
+            nextSequence = sequence + 1;
+        }
+    }
+    return hasContent;
+}
+
+// Apply one journal entry to the in-memory profiles
+bool ProfileManager::applyEntry(const json& entry) {
+    try {
+        std::string op = entry.at("op").get<std::string>();
+        if (op == "create") {
+            std::string username = entry.at("user").get<std::string>();
+            if (!profileExists(username)) {
+                rankProfile(profiles.insertOrAssign(UserProfile(username)));
             }
+        } else if (op == "stats") {
+            applyResult(entry.at("user").get<std::string>(), entry.at("won").get<bool>());
+        } else if (op == "match") {
+            applyMatch(entry.at("winner").get<std::string>(), entry.at("loser").get<std::string>());
+        } else {
+            return false;
         }
-        
-        std::cout << "Loaded " << profiles.size() << " profiles." << std::endl;
         return true;
         
     } catch (const json::exception& e) {
-        std::cerr << "Error parsing profiles.json: " << e.what() << std::endl;
+        std::cerr << "Skipping bad profile journal entry: " << e.what() << std::endl;
         return false;
     }
 }
 
-// Save profiles to JSON file
-bool ProfileManager::saveProfiles() {
-    try {
-        json j = json::array();
-        
-        // Convert profiles map to JSON array
-        for (const auto& pair : profiles) {
-            json profileJson;
-            profileJson["username"] = pair.second.username;
-            profileJson["wins"] = pair.second.wins;
-            profileJson["losses"] = pair.second.losses;
-            profileJson["totalGames"] = pair.second.totalGames;
-            
-            j.push_back(profileJson);
+// Count one game for a profile
+void ProfileManager::applyResult(std::string_view username, bool won) {
+    UserProfile* profile = getProfile(username);
+    if (profile) {
+        unrankProfile(*profile);
+        profile->totalGames++;
+        if (won) {
+            profile->wins++;
+        } else {
+            profile->losses++;
         }
-        
-        // Write to file with pretty formatting
-        std::ofstream file(filepath);
-        if (!file.is_open()) {
-            std::cerr << "Failed to open file for writing: " << filepath << std::endl;
-            return false;
+        rankProfile(*profile);
+    }
+}
+
+// Count a match for both players and move rating from loser to winner
+void ProfileManager::applyMatch(std::string_view winner, std::string_view loser) {
+    UserProfile* winnerProfile = getProfile(winner);
+    UserProfile* loserProfile = getProfile(loser);
+    if (!winnerProfile || !loserProfile || winnerProfile == loserProfile) {
+        // Ratings only move between two real players
+        applyResult(winner, true);
+        applyResult(loser, false);
+        return;
+    }
+    
+    unrankProfile(*winnerProfile);
+    unrankProfile(*loserProfile);
+    winnerProfile->wins++;
+    winnerProfile->totalGames++;
+    loserProfile->losses++;
+    loserProfile->totalGames++;
+    
+    int points = eloTransfer(winnerProfile->rating, loserProfile->rating);
+    winnerProfile->rating += points;
+    loserProfile->rating -= points;
+    rankProfile(*winnerProfile);
+    rankProfile(*loserProfile);
+}
+
+// Journal a change, compacting when the journal has grown long enough
+void ProfileManager::appendEntry(json entry) {
+    entry["seq"] = nextSequence++;
+    writer->append(entry.dump());
+    
+    journalEntries++;
+    if (compactEvery > 0 && journalEntries >= compactEvery) {
+        saveProfiles();
+    }
+}
+
+// Every profile in name order: the mapped base merged with the overlay
+ProfileSnapshot ProfileSnapshotSource::collect() const {
+    ProfileSnapshot snapshot;
+    snapshot.generation = generation;
+    snapshot.lastSequence = lastSequence;
+    snapshot.profiles.reserve(base->size() + overlay.size());
+    
+    std::size_t index = 0;
+    std::size_t rank = 0;
+    while (index < base->size() || rank < overlay.size()) {
+        if (rank == overlay.size()) {
+            snapshot.profiles.push_back(base->profileAt(index++));
+            continue;
+        }
+        const UserProfile& profile = overlay.byName(rank);
+        if (index == base->size()) {
+            snapshot.profiles.push_back(profile);
+            rank++;
+            continue;
         }
         
-        file << j.dump(4); // 4-space indentation
-        file.close();
-        
-        std::cout << "Saved " << profiles.size() << " profiles." << std::endl;
-        return true;
-        
+        int order = base->nameAt(index).compare(profile.username);
+        if (order < 0) {
+            snapshot.profiles.push_back(base->profileAt(index++));
+        } else {
+            // The overlay copy shadows the base record of the same name
+            if (order == 0) {
+                index++;
+            }
+            snapshot.profiles.push_back(profile);
+            rank++;
+        }
+    }
+    return snapshot;
+}
+
+// The base and the overlay as they are now; no profile is copied
+ProfileSnapshotSource ProfileManager::shareSnapshot() const {
+    ProfileSnapshotSource source;
+    source.base = base;
+    source.overlay = profiles.view();
+    return source;
+}
+
+// Queue a full snapshot; the journal is emptied once it is written. The
+// writer merges and copies the profiles on its own thread.
+bool ProfileManager::saveProfiles() {
+    PONG_TRACE_SCOPE("ProfileManager::saveProfiles");
+    ProfileSnapshotSource source = shareSnapshot();
+    source.generation = ++generation;
+    source.lastSequence = nextSequence - 1;
+    writer->submit(std::move(source));
+    journalEntries = 0;
+    return true;
+}
+
+// Wait for queued saves to reach the disk
+bool ProfileManager::flush() {
+    return writer->flush();
+}
+
+// Merge profiles from a JSON file, then write a fresh snapshot
+bool ProfileManager::importJson(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+    
+    ProfileIndex imported;
+    ProfileSaxReader reader(imported);
+    if (!json::sax_parse(file, &reader)) {
+        std::cerr << "Error parsing " << path << ": " << reader.getError() << std::endl;
+        return false;
+    }
+    
+    // Overwritten profiles would leave leaderboard keys behind; rebuild later
+    dropLeaderboards();
+    for (std::size_t rank = 0; rank < imported.size(); rank++) {
+        profiles.insertOrAssign(std::move(imported.byName(rank)));
+    }
+    std::cout << "Imported " << imported.size() << " profiles from " << path << std::endl;
+    return saveProfiles();
+}
+
+// Write every profile as profiles.json
+bool ProfileManager::exportJson(const std::string& path) const {
+    ProfileSnapshotSource source = shareSnapshot();
+    source.generation = generation;
+    source.lastSequence = nextSequence - 1;
+    ProfileSnapshot snapshot = source.collect();
+    
+    try {
+        return ProfileWriter::writeAtomically(path, ProfileWriter::serialize(snapshot, ProfileFormat::JSON));
     } catch (const json::exception& e) {
-        std::cerr << "Error saving profiles: " << e.what() << std::endl;
+        std::cerr << "Error exporting profiles: " << e.what() << std::endl;
         return false;
     }
 }
 
-// Get a profile by username
-UserProfile* ProfileManager::getProfile(const std::string& username) {
-    auto it = profiles.find(username);
-    if (it != profiles.end()) {
-        return &(it->second);
+// Get a profile by username; base records are copied into the overlay on first access
+UserProfile* ProfileManager::getProfile(std::string_view username) {
+    UserProfile* profile = profiles.find(username);
+    if (profile) {
+        return profile;
+    }
+    
+    std::size_t index;
+    if (base->find(username, index)) {
+        return &profiles.insertOrAssign(base->profileAt(index));
     }
     return nullptr;
 }
@@ -100,37 +470,273 @@ bool ProfileManager::createProfile(const std::string& username) {
         return false;
     }
     
-    UserProfile newProfile(username);
-    profiles[username] = newProfile;
+    rankProfile(profiles.insertOrAssign(UserProfile(username)));
     
     std::cout << "Created profile: " << username << std::endl;
-    return saveProfiles();
+    appendEntry({{"op", "create"}, {"user", username}});
+    return true;
 }
 
 // Update stats for a profile
 void ProfileManager::updateStats(const std::string& username, bool won) {
-    UserProfile* profile = getProfile(username);
-    if (profile) {
-        profile->totalGames++;
-        if (won) {
-            profile->wins++;
-        } else {
-            profile->losses++;
-        }
-        saveProfiles();
+    if (profileExists(username)) {
+        applyResult(username, won);
+        appendEntry({{"op", "stats"}, {"user", username}, {"won", won}});
+    }
+}
+
+// Update winner and loser with a single journal entry
+void ProfileManager::recordMatchResult(const std::string& winner, const std::string& loser) {
+    if (profileExists(winner) || profileExists(loser)) {
+        applyMatch(winner, loser);
+        appendEntry({{"op", "match"}, {"winner", winner}, {"loser", loser}});
     }
 }
 
 // Get all profile names
 std::vector<std::string> ProfileManager::getProfileNames() const {
     std::vector<std::string> names;
-    for (const auto& pair : profiles) {
-        names.push_back(pair.first);
+    names.reserve(base->size() + profiles.size());
+    
+    std::size_t index = 0;
+    std::size_t rank = 0;
+    while (index < base->size() || rank < profiles.size()) {
+        if (rank == profiles.size() || (index < base->size() && base->nameAt(index) < profiles.byName(rank).username)) {
+            names.emplace_back(base->nameAt(index++));
+        } else {
+            const std::string& name = profiles.byName(rank++).username;
+            if (index < base->size() && base->nameAt(index) == name) {
+                index++;
+            }
+            names.push_back(name);
+        }
     }
     return names;
 }
 
+// Number of profiles (base records plus overlay profiles not in the base)
+std::size_t ProfileManager::getProfileCount() const {
+    std::size_t count = base->size();
+    std::size_t index;
+    for (std::size_t rank = 0; rank < profiles.size(); rank++) {
+        if (!base->find(profiles.byName(rank).username, index)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Profiles from a name onwards, merging the base and the overlay
+std::size_t ProfileManager::getProfilesFrom(std::string_view name, std::size_t count,
+                                            std::vector<UserProfile>& page, std::string_view prefix) const {
+    page.clear();
+    
+    // Names with the prefix sort at or after the prefix itself
+    std::string_view start = std::max(name, prefix);
+    std::size_t index = base->lowerBound(start);
+    std::size_t rank = profiles.lowerBound(start);
+    
+    while (page.size() < count && (index < base->size() || rank < profiles.size())) {
+        bool fromBase = rank == profiles.size() ||
+                        (index < base->size() && base->nameAt(index) < profiles.byName(rank).username);
+        std::string_view next = fromBase ? base->nameAt(index) : std::string_view(profiles.byName(rank).username);
+        if (!hasPrefix(next, prefix)) {
+            break;
+        }
+        
+        if (fromBase) {
+            page.push_back(base->profileAt(index++));
+        } else {
+            // The overlay copy shadows the base record of the same name
+            if (index < base->size() && base->nameAt(index) == next) {
+                index++;
+            }
+            page.push_back(profiles.byName(rank++));
+        }
+    }
+    return page.size();
+}
+
+// Profiles just before a name, walking both sources backwards
+std::size_t ProfileManager::getProfilesBefore(std::string_view name, std::size_t count,
+                                              std::vector<UserProfile>& page, std::string_view prefix) const {
+    page.clear();
+    
+    // Start no later than the end of the prefix's range
+    std::string end = prefixEnd(prefix);
+    std::string_view limit = name;
+    if (!end.empty() && (limit.empty() || std::string_view(end) < limit)) {
+        limit = end;
+    }
+    std::size_t index = limit.empty() ? base->size() : base->lowerBound(limit);
+    std::size_t rank = limit.empty() ? profiles.size() : profiles.lowerBound(limit);
+    
+    while (page.size() < count && (index > 0 || rank > 0)) {
+        bool fromBase = rank == 0 ||
+                        (index > 0 && base->nameAt(index - 1) > profiles.byName(rank - 1).username);
+        std::string_view next = fromBase ? base->nameAt(index - 1) : std::string_view(profiles.byName(rank - 1).username);
+        if (!hasPrefix(next, prefix)) {
+            break;
+        }
+        
+        if (fromBase) {
+            page.push_back(base->profileAt(--index));
+        } else {
+            if (index > 0 && base->nameAt(index - 1) == next) {
+                index--;
+            }
+            page.push_back(profiles.byName(--rank));
+        }
+    }
+    std::reverse(page.begin(), page.end());
+    return page.size();
+}
+
 // Check if profile exists
-bool ProfileManager::profileExists(const std::string& username) const {
-    return profiles.find(username) != profiles.end();
+bool ProfileManager::profileExists(std::string_view username) const {
+    std::size_t index;
+    return profiles.find(username) != nullptr || base->find(username, index);
+}
+
+// Copy a profile out without moving it into the overlay
+bool ProfileManager::readProfile(std::string_view username, UserProfile& profile) const {
+    if (const UserProfile* overlay = profiles.find(username)) {
+        profile = *overlay;
+        return true;
+    }
+    std::size_t index;
+    if (base->find(username, index)) {
+        profile = base->profileAt(index);
+        return true;
+    }
+    return false;
+}
+
+// A profile's place on one leaderboard (false if it isn't ranked there)
+bool ProfileManager::leaderboardKey(LeaderboardKind kind, const UserProfile& profile, std::string_view name,
+                                    RankIndex::Key& key) {
+    key.name = name;
+    switch (kind) {
+        case LeaderboardKind::WINS:
+            key.score = profile.wins;
+            return true;
+            
+        case LeaderboardKind::WIN_RATE: {
+            if (profile.totalGames < WIN_RATE_MIN_GAMES) {
+                return false;
+            }
+            // Parts per million, then games played as the tie-break
+            std::int64_t rate = static_cast<std::int64_t>(profile.wins) * 1000000 / profile.totalGames;
+            key.score = rate * (std::int64_t(1) << 32) + profile.totalGames;
+            return true;
+        }
+            
+        case LeaderboardKind::RATING:
+            key.score = profile.rating;
+            return true;
+    }
+    return false;
+}
+
+// Rank every profile once; shadowed base records are skipped
+void ProfileManager::buildLeaderboards() {
+    std::vector<RankIndex::Key> keys[LEADERBOARD_KINDS];
+    RankIndex::Key key;
+    
+    auto addProfile = [&](const UserProfile& profile, std::string_view name) {
+        for (std::size_t kind = 0; kind < LEADERBOARD_KINDS; kind++) {
+            if (leaderboardKey(static_cast<LeaderboardKind>(kind), profile, name, key)) {
+                keys[kind].push_back(key);
+            }
+        }
+    };
+    
+    // Read-only access, so no block is copied; overlay keys use the stored
+    // names, which stay put when a block is
+    const ProfileIndex& overlay = profiles;
+    for (std::size_t i = 0; i < base->size(); i++) {
+        if (!overlay.find(base->nameAt(i))) {
+            addProfile(base->profileAt(i), base->nameAt(i));
+        }
+    }
+    for (std::size_t rank = 0; rank < overlay.size(); rank++) {
+        const UserProfile& profile = overlay.byName(rank);
+        addProfile(profile, overlay.storedName(profile.username));
+    }
+    
+    for (std::size_t kind = 0; kind < LEADERBOARD_KINDS; kind++) {
+        leaderboards[kind].build(std::move(keys[kind]));
+    }
+    leaderboardsBuilt = true;
+}
+
+// Forget the leaderboards; the next query rebuilds them
+void ProfileManager::dropLeaderboards() {
+    for (RankIndex& board : leaderboards) {
+        board.clear();
+    }
+    leaderboardsBuilt = false;
+}
+
+// Add an overlay profile to the leaderboards it qualifies for
+void ProfileManager::rankProfile(const UserProfile& profile) {
+    if (!leaderboardsBuilt) {
+        return;
+    }
+    RankIndex::Key key;
+    std::string_view name = profiles.storedName(profile.username);
+    for (std::size_t kind = 0; kind < LEADERBOARD_KINDS; kind++) {
+        if (leaderboardKey(static_cast<LeaderboardKind>(kind), profile, name, key)) {
+            leaderboards[kind].insert(key);
+        }
+    }
+}
+
+// Remove a profile's current keys before its stats change
+void ProfileManager::unrankProfile(const UserProfile& profile) {
+    if (!leaderboardsBuilt) {
+        return;
+    }
+    RankIndex::Key key;
+    for (std::size_t kind = 0; kind < LEADERBOARD_KINDS; kind++) {
+        if (leaderboardKey(static_cast<LeaderboardKind>(kind), profile, profile.username, key)) {
+            leaderboards[kind].erase(key);
+        }
+    }
+}
+
+// Number of profiles on a leaderboard
+std::size_t ProfileManager::getLeaderboardSize(LeaderboardKind kind) {
+    if (!leaderboardsBuilt) {
+        buildLeaderboards();
+    }
+    return leaderboards[static_cast<std::size_t>(kind)].size();
+}
+
+// Profiles at ranks first .. first + count - 1
+std::size_t ProfileManager::getLeaderboard(LeaderboardKind kind, std::size_t first, std::size_t count,
+                                           std::vector<UserProfile>& page) {
+    page.clear();
+    const RankIndex& board = leaderboards[static_cast<std::size_t>(kind)];
+    std::size_t size = getLeaderboardSize(kind);
+    
+    for (std::size_t rank = first; rank < size && page.size() < count; rank++) {
+        page.emplace_back();
+        readProfile(board.at(rank).name, page.back());
+    }
+    return page.size();
+}
+
+// 0-based rank of a profile (false if it is missing or not ranked)
+bool ProfileManager::getLeaderboardRank(LeaderboardKind kind, std::string_view username, std::size_t& rank) {
+    if (!leaderboardsBuilt) {
+        buildLeaderboards();
+    }
+    UserProfile profile;
+    RankIndex::Key key;
+    if (!readProfile(username, profile) || !leaderboardKey(kind, profile, username, key)) {
+        return false;
+    }
+    rank = leaderboards[static_cast<std::size_t>(kind)].rankOf(key);
+    return true;
 }
@@ -0,0 +1,219 @@
+#include "ProfileWriter.h"
+#include "Trace.h"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Write all bytes (replacing or appending) and force them to disk
+bool writeAndSync(const std::string& path, const std::string& contents, bool append) {
+#ifdef _WIN32
+    int mode = append ? _O_APPEND : _O_TRUNC;
+    int fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | mode | _O_BINARY, _S_IREAD | _S_IWRITE);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = _write(fd, contents.data(), static_cast<unsigned>(contents.size())) == static_cast<int>(contents.size());
+    ok = ok && _commit(fd) == 0;
+    ok = (_close(fd) == 0) && ok;
+    return ok;
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = true;
+    std::size_t written = 0;
+    while (ok && written < contents.size()) {
+        ssize_t n = ::write(fd, contents.data() + written, contents.size() - written);
+        if (n < 0) {
+            ok = false;
+        } else {
+            written += static_cast<std::size_t>(n);
+        }
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+    return ok;
+#endif
+}
+
+// Make the rename itself durable (POSIX only; NTFS journals it)
+void syncDirectory(const std::string& path) {
+#ifndef _WIN32
+    std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    if (dir.empty()) {
+        dir = ".";
+    }
+    int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+} // namespace
+
+// Constructor
+ProfileWriter::ProfileWriter(const std::string& snapshotFile, const std::string& journalFile, ProfileFormat snapshotFormat)
+    : snapshotPath(snapshotFile), journalPath(journalFile), format(snapshotFormat), hasSnapshot(false),
+      writing(false), stopping(false), lastWriteOk(true) {
+    worker = std::thread(&ProfileWriter::run, this);
+}
+
+// Destructor
+ProfileWriter::~ProfileWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorker.notify_one();
+    worker.join();
+}
+
+// Queue a journal line
+void ProfileWriter::append(const std::string& line) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingJournal += line;
+        pendingJournal += '\n';
+    }
+    wakeWorker.notify_one();
+}
+
+// Queue a snapshot
+void ProfileWriter::submit(ProfileSnapshotSource source) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingSnapshot = std::move(source);
+        hasSnapshot = true;
+        
+        // Lines still waiting are already part of the snapshot, but are
+        // only dropped once it is on disk
+        coveredJournal += pendingJournal;
+        pendingJournal.clear();
+    }
+    wakeWorker.notify_one();
+}
+
+// Wait for the queue to drain
+bool ProfileWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    writeDone.wait(lock, [this] { return !hasSnapshot && pendingJournal.empty() && !writing; });
+    return lastWriteOk;
+}
+
+// Writer thread: snapshot (then journal truncation) first, then journal lines
+void ProfileWriter::run() {
+    trace::setThreadName("profile writer");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeWorker.wait(lock, [this] { return hasSnapshot || !pendingJournal.empty() || stopping; });
+        if (!hasSnapshot && pendingJournal.empty()) {
+            break; // Stopping with nothing left to write
+        }
+        
+        // Lines queued now were all submitted after any queued snapshot
+        bool snapshotTaken = hasSnapshot;
+        ProfileSnapshotSource snapshot;
+        std::string covered;
+        if (snapshotTaken) {
+            snapshot = std::move(pendingSnapshot);
+            pendingSnapshot = ProfileSnapshotSource();
+            hasSnapshot = false;
+            covered.swap(coveredJournal);
+        }
+        std::string lines;
+        lines.swap(pendingJournal);
+        writing = true;
+        lock.unlock();
+        
+        bool ok = true;
+        if (snapshotTaken) {
+            PONG_TRACE_SCOPE("ProfileWriter::writeSnapshot");
+            try {
+                ok = writeAtomically(snapshotPath, serialize(snapshot.collect(), format));
+            } catch (const json::exception& e) {
+                std::cerr << "Error saving profiles: " << e.what() << std::endl;
+                ok = false;
+            }
+            snapshot = ProfileSnapshotSource(); // Stop sharing the blocks, so editing them copies nothing
+            
+            // Only drop the journal once the snapshot that covers it is durable;
+            // without it, the lines it covered still have to be journalled
+            if (ok && !writeAndSync(journalPath, std::string(), false)) {
+                std::cerr << "Failed to truncate profile journal: " << journalPath << std::endl;
+            } else if (!ok) {
+                lines.insert(0, covered);
+            }
+        }
+        if (!lines.empty()) {
+            PONG_TRACE_SCOPE("ProfileWriter::appendJournal");
+            if (!writeAndSync(journalPath, lines, true)) {
+                std::cerr << "Failed to append to profile journal: " << journalPath << std::endl;
+                ok = false;
+            }
+        }
+        
+        lock.lock();
+        writing = false;
+        lastWriteOk = ok;
+        writeDone.notify_all();
+    }
+}
+
+// Snapshot as JSON {"generation", "lastSequence", "profiles": [...]} or binary
+std::string ProfileWriter::serialize(const ProfileSnapshot& snapshot, ProfileFormat format) {
+    if (format == ProfileFormat::BINARY) {
+        return BinaryProfileStore::encode(snapshot);
+    }
+    
+    json profilesJson = json::array();
+    for (const UserProfile& profile : snapshot.profiles) {
+        json profileJson;
+        profileJson["username"] = profile.username;
+        profileJson["wins"] = profile.wins;
+        profileJson["losses"] = profile.losses;
+        profileJson["totalGames"] = profile.totalGames;
+        profileJson["rating"] = profile.rating;
+        profilesJson.push_back(profileJson);
+    }
+    
+    json j;
+    j["generation"] = snapshot.generation;
+    j["lastSequence"] = snapshot.lastSequence;
+    j["profiles"] = std::move(profilesJson);
+    return j.dump(4); // 4-space indentation
+}
+
+// Temp file + fsync + rename
+bool ProfileWriter::writeAtomically(const std::string& path, const std::string& contents) {
+    std::string tempPath = path + ".tmp";
+    if (!writeAndSync(tempPath, contents, false)) {
+        std::cerr << "Failed to write profiles to " << tempPath << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    
+    // std::filesystem::rename replaces the target on every platform
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "Failed to replace " << path << ": " << error.message() << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    syncDirectory(path);
+    return true;
+}
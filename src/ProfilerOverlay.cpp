@@ -0,0 +1,107 @@
+#include "ProfilerOverlay.h"
+#include <cstdio>
+
+namespace {
+
+const float GRAPH_HEIGHT = 100.0f;
+const float PIXELS_PER_MS = GRAPH_HEIGHT / 33.3f;   // Full height is a 30 FPS frame
+const unsigned TEXT_INTERVAL = 15;                  // Frames between text refreshes
+
+const sf::Color PHASE_COLORS[FrameProfiler::PHASE_COUNT] = {
+    sf::Color(80, 160, 255),    // events
+    sf::Color(80, 220, 120),    // update
+    sf::Color(255, 170, 60),    // render
+    sf::Color(130, 130, 130)    // display
+};
+
+} // namespace
+
+// Constructor
+ProfilerOverlay::ProfilerOverlay(const sf::Font& font, float x, float y)
+    : bars(sf::Triangles, FrameProfiler::CAPACITY * FrameProfiler::PHASE_COUNT * 6),
+      guides(sf::Lines, 4), graphX(x + 10), graphBottom(y + 10 + GRAPH_HEIGHT), framesUntilText(0) {
+
+    background.setPosition(x, y);
+    background.setSize(sf::Vector2f(FrameProfiler::CAPACITY + 20.0f, GRAPH_HEIGHT + 110.0f));
+    background.setFillColor(sf::Color(0, 0, 0, 190));
+
+    // 60 FPS and 30 FPS frame budgets
+    const float budgets[2] = { 16.7f, 33.3f };
+    for (std::size_t i = 0; i < 2; i++) {
+        float lineY = graphBottom - budgets[i] * PIXELS_PER_MS;
+        guides[i * 2].position = sf::Vector2f(graphX, lineY);
+        guides[i * 2 + 1].position = sf::Vector2f(graphX + FrameProfiler::CAPACITY, lineY);
+        guides[i * 2].color = guides[i * 2 + 1].color = sf::Color(255, 255, 255, 90);
+    }
+
+    statsText.setStyle(font, 13, sf::Color::White);
+    statsText.setPosition(graphX, graphBottom + 6);
+}
+
+// One quad as two triangles
+void ProfilerOverlay::writeBar(std::size_t first, float left, float top, float bottom, const sf::Color& color) {
+    sf::Vertex* quad = &bars[first];
+    quad[0].position = sf::Vector2f(left, top);
+    quad[1].position = sf::Vector2f(left + 1, top);
+    quad[2].position = sf::Vector2f(left, bottom);
+    quad[3].position = sf::Vector2f(left + 1, top);
+    quad[4].position = sf::Vector2f(left + 1, bottom);
+    quad[5].position = sf::Vector2f(left, bottom);
+    for (int i = 0; i < 6; i++) {
+        quad[i].color = color;
+    }
+}
+
+// Stack each frame's phases into a bar, newest on the right
+void ProfilerOverlay::update(const FrameProfiler& profiler) {
+    std::size_t count = profiler.copyRecent(recent, FrameProfiler::CAPACITY);
+    std::size_t offset = FrameProfiler::CAPACITY - count;
+
+    for (std::size_t column = 0; column < FrameProfiler::CAPACITY; column++) {
+        float left = graphX + column;
+        float bottom = graphBottom;
+        for (int phase = 0; phase < FrameProfiler::PHASE_COUNT; phase++) {
+            float height = 0.0f;
+            if (column >= offset) {
+                height = recent[column - offset].phaseMs[phase] * PIXELS_PER_MS;
+            }
+            float top = bottom - height;
+            if (top < graphBottom - GRAPH_HEIGHT) {
+                top = graphBottom - GRAPH_HEIGHT;   // Clip long frames at the top
+            }
+            writeBar((column * FrameProfiler::PHASE_COUNT + phase) * 6, left, top, bottom, PHASE_COLORS[phase]);
+            bottom = top;
+        }
+    }
+
+    if (framesUntilText == 0) {
+        updateText(profiler);
+        framesUntilText = TEXT_INTERVAL;
+    }
+    framesUntilText--;
+}
+
+// p50 / p99 / max lines for the frame and each phase
+void ProfilerOverlay::updateText(const FrameProfiler& profiler) {
+    FrameProfiler::Stats total;
+    FrameProfiler::Stats phases[FrameProfiler::PHASE_COUNT];
+    std::size_t frames = profiler.summarize(total, phases);
+
+    char buffer[512];
+    int length = std::snprintf(buffer, sizeof(buffer), "%-8s p50 %5.1f  p99 %5.1f  max %5.1f ms  (%zu frames)\n",
+                               "frame", total.p50, total.p99, total.max, frames);
+    for (int phase = 0; phase < FrameProfiler::PHASE_COUNT && length > 0; phase++) {
+        length += std::snprintf(buffer + length, sizeof(buffer) - length, "%-8s p50 %5.1f  p99 %5.1f  max %5.1f\n",
+                                FrameProfiler::phaseName(static_cast<FrameProfiler::Phase>(phase)),
+                                phases[phase].p50, phases[phase].p99, phases[phase].max);
+    }
+    statsText.setString(buffer);
+}
+
+// Draw background, guides, bars and numbers
+void ProfilerOverlay::render(sf::RenderTarget& target) const {
+    target.draw(background);
+    target.draw(bars);
+    target.draw(guides);
+    target.draw(statsText);
+}
@@ -0,0 +1,176 @@
+#include "RankIndex.h"
+#include <algorithm>
+
+// Constructor
+RankIndex::RankIndex() : root(NIL), seed(0x9e3779b9u) {
+}
+
+// Higher score first, then alphabetical
+bool RankIndex::before(const Key& a, const Key& b) {
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    return a.name < b.name;
+}
+
+// Recompute a node's subtree size from its children
+void RankIndex::resize(std::uint32_t node) {
+    nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right);
+}
+
+// xorshift32; priorities only need to look random, and a fixed seed keeps
+// the tree shape reproducible
+std::uint32_t RankIndex::nextPriority() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+// Take a node from the free list or the end of the pool
+std::uint32_t RankIndex::newNode(const Key& key, std::uint32_t priority) {
+    std::uint32_t node;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        node = static_cast<std::uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+    nodes[node] = Node{ key, priority, NIL, NIL, 1 };
+    return node;
+}
+
+// Split a subtree into keys ranked before key and the rest
+void RankIndex::split(std::uint32_t node, const Key& key, std::uint32_t& left, std::uint32_t& right) {
+    if (node == NIL) {
+        left = right = NIL;
+        return;
+    }
+    if (before(nodes[node].key, key)) {
+        split(nodes[node].right, key, nodes[node].right, right);
+        left = node;
+    } else {
+        split(nodes[node].left, key, left, nodes[node].left);
+        right = node;
+    }
+    resize(node);
+}
+
+// Join two subtrees where every key of left ranks before every key of right
+std::uint32_t RankIndex::merge(std::uint32_t left, std::uint32_t right) {
+    if (left == NIL) {
+        return right;
+    }
+    if (right == NIL) {
+        return left;
+    }
+    if (nodes[left].priority > nodes[right].priority) {
+        nodes[left].right = merge(nodes[left].right, right);
+        resize(left);
+        return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    resize(right);
+    return right;
+}
+
+// Remove key from a subtree, fixing sizes on the way back up
+bool RankIndex::eraseFrom(std::uint32_t& node, const Key& key) {
+    if (node == NIL) {
+        return false;
+    }
+    bool erased;
+    if (before(key, nodes[node].key)) {
+        erased = eraseFrom(nodes[node].left, key);
+    } else if (before(nodes[node].key, key)) {
+        erased = eraseFrom(nodes[node].right, key);
+    } else {
+        std::uint32_t removed = node;
+        node = merge(nodes[node].left, nodes[node].right);
+        freeNodes.push_back(removed);
+        return true;
+    }
+    if (erased) {
+        resize(node);
+    }
+    return erased;
+}
+
+// Balanced subtree over sorted keys. Priorities fall with depth so the
+// result is a valid treap for later random-priority inserts.
+std::uint32_t RankIndex::buildRange(const std::vector<Key>& keys, std::size_t begin, std::size_t end,
+                                    std::uint32_t depth) {
+    if (begin == end) {
+        return NIL;
+    }
+    std::size_t middle = begin + (end - begin) / 2;
+    std::uint32_t priority = ((31u - std::min(depth, 31u)) << 27) | (nextPriority() >> 5);
+    std::uint32_t node = newNode(keys[middle], priority);
+
+    std::uint32_t left = buildRange(keys, begin, middle, depth + 1);
+    std::uint32_t right = buildRange(keys, middle + 1, end, depth + 1);
+    nodes[node].left = left;
+    nodes[node].right = right;
+    resize(node);
+    return node;
+}
+
+// Remove every key
+void RankIndex::clear() {
+    nodes.clear();
+    freeNodes.clear();
+    root = NIL;
+}
+
+// Sort once and build a balanced tree
+void RankIndex::build(std::vector<Key> keys) {
+    clear();
+    std::sort(keys.begin(), keys.end(), before);
+    nodes.reserve(keys.size());
+    root = buildRange(keys, 0, keys.size(), 0);
+}
+
+// Insert by splitting at the key's position
+void RankIndex::insert(const Key& key) {
+    std::uint32_t left;
+    std::uint32_t right;
+    split(root, key, left, right);
+    root = merge(merge(left, newNode(key, nextPriority())), right);
+}
+
+// Erase an exact key
+bool RankIndex::erase(const Key& key) {
+    return eraseFrom(root, key);
+}
+
+// Count keys ranked before key
+std::size_t RankIndex::rankOf(const Key& key) const {
+    std::size_t rank = 0;
+    std::uint32_t node = root;
+    while (node != NIL) {
+        if (before(nodes[node].key, key)) {
+            rank += sizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        } else {
+            node = nodes[node].left;
+        }
+    }
+    return rank;
+}
+
+// Walk down by subtree sizes
+const RankIndex::Key& RankIndex::at(std::size_t rank) const {
+    std::uint32_t node = root;
+    while (true) {
+        std::size_t leftSize = sizeOf(nodes[node].left);
+        if (rank < leftSize) {
+            node = nodes[node].left;
+        } else if (rank == leftSize) {
+            return nodes[node].key;
+        } else {
+            rank -= leftSize + 1;
+            node = nodes[node].right;
+        }
+    }
+}
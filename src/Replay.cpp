@@ -0,0 +1,372 @@
+#include "Replay.h"
+#include "AllocationTracker.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+const char REPLAY_MAGIC[8] = { 'P', 'O', 'N', 'G', 'R', 'P', 'L', '\0' };
+const std::uint32_t REPLAY_VERSION = 1;
+
+// Little-endian writers
+void writeU32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+void writeU64(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+}
+
+void writeFloat(std::vector<std::uint8_t>& out, float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU32(out, bits);
+}
+
+void writeString(std::vector<std::uint8_t>& out, const std::string& value) {
+    writeU32(out, static_cast<std::uint32_t>(value.size()));
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+void writeVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// Bounds-checked little-endian reader
+class ByteReader {
+private:
+    const std::vector<std::uint8_t>& bytes;
+    std::size_t pos;
+
+public:
+    ByteReader(const std::vector<std::uint8_t>& data, std::size_t start = 0) : bytes(data), pos(start) {}
+
+    bool readU32(std::uint32_t& value) {
+        if (pos + 4 > bytes.size()) return false;
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= static_cast<std::uint32_t>(bytes[pos++]) << (8 * i);
+        }
+        return true;
+    }
+
+    bool readU64(std::uint64_t& value) {
+        if (pos + 8 > bytes.size()) return false;
+        value = 0;
+        for (int i = 0; i < 8; i++) {
+            value |= static_cast<std::uint64_t>(bytes[pos++]) << (8 * i);
+        }
+        return true;
+    }
+
+    bool readFloat(float& value) {
+        std::uint32_t bits;
+        if (!readU32(bits)) return false;
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool readInt(int& value) {
+        std::uint32_t bits;
+        if (!readU32(bits)) return false;
+        value = static_cast<int>(bits);
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        std::uint32_t length;
+        if (!readU32(length) || pos + length > bytes.size()) return false;
+        value.assign(bytes.begin() + pos, bytes.begin() + pos + length);
+        pos += length;
+        return true;
+    }
+
+    bool readVarint(std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= bytes.size()) return false;
+            std::uint8_t byte = bytes[pos++];
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    bool readByte(std::uint8_t& value) {
+        if (pos >= bytes.size()) return false;
+        value = bytes[pos++];
+        return true;
+    }
+
+    std::size_t position() const { return pos; }
+};
+
+// Pack both paddles' keys into 4 bits
+std::uint8_t encodeInput(const SimulationInput& input) {
+    return static_cast<std::uint8_t>((input.player1.up ? 1 : 0) | (input.player1.down ? 2 : 0) |
+                                     (input.player2.up ? 4 : 0) | (input.player2.down ? 8 : 0));
+}
+
+SimulationInput decodeInput(std::uint8_t code) {
+    SimulationInput input;
+    input.player1.up = (code & 1) != 0;
+    input.player1.down = (code & 2) != 0;
+    input.player2.up = (code & 4) != 0;
+    input.player2.down = (code & 8) != 0;
+    return input;
+}
+
+// Config fields that affect the simulation, in file order
+void writeConfig(std::vector<std::uint8_t>& out, const SimulationConfig& config) {
+    writeFloat(out, config.fieldWidth);
+    writeFloat(out, config.fieldHeight);
+    writeFloat(out, config.ballRadius);
+    writeFloat(out, config.ballSpeed);
+    writeFloat(out, config.speedUpFactor);
+    writeFloat(out, config.maxSpeedFactor);
+    writeFloat(out, config.paddleWidth);
+    writeFloat(out, config.paddleHeight);
+    writeFloat(out, config.paddleSpeed);
+    writeFloat(out, config.paddle1X);
+    writeFloat(out, config.paddle2X);
+    writeFloat(out, config.paddleStartY);
+    writeU32(out, static_cast<std::uint32_t>(config.maxScore));
+    writeU32(out, static_cast<std::uint32_t>(config.tickRate));
+    writeU32(out, config.continuousCollision ? 1 : 0);
+}
+
+bool readConfig(ByteReader& in, SimulationConfig& config) {
+    std::uint32_t continuous = 0;
+    bool ok = in.readFloat(config.fieldWidth) && in.readFloat(config.fieldHeight) &&
+              in.readFloat(config.ballRadius) && in.readFloat(config.ballSpeed) &&
+              in.readFloat(config.speedUpFactor) && in.readFloat(config.maxSpeedFactor) &&
+              in.readFloat(config.paddleWidth) && in.readFloat(config.paddleHeight) &&
+              in.readFloat(config.paddleSpeed) && in.readFloat(config.paddle1X) &&
+              in.readFloat(config.paddle2X) && in.readFloat(config.paddleStartY) &&
+              in.readInt(config.maxScore) && in.readInt(config.tickRate) && in.readU32(continuous);
+    config.continuousCollision = continuous != 0;
+    return ok && config.tickRate > 0;
+}
+
+} // namespace
+
+// Constructor
+ReplayRecorder::ReplayRecorder()
+    : recording(false), runCode(0), runLength(0) {
+}
+
+// Begin a new recording
+void ReplayRecorder::start(const SimulationConfig& config, std::uint64_t seed,
+                           const std::string& player1Name, const std::string& player2Name) {
+    data.config = config;
+    data.seed = seed;
+    data.player1Name = player1Name;
+    data.player2Name = player2Name;
+    data.tickCount = 0;
+    data.finalChecksum = 0;
+    data.inputRuns.clear();
+    data.inputRuns.reserve(4096); // Keeps typical matches allocation-free while playing
+
+    runCode = 0;
+    runLength = 0;
+    recording = true;
+}
+
+// Close the current run of identical inputs
+void ReplayRecorder::flushRun() {
+    if (runLength > 0) {
+        data.inputRuns.push_back(runCode);
+        writeVarint(data.inputRuns, runLength);
+    }
+    runLength = 0;
+}
+
+// Append one tick of input
+void ReplayRecorder::record(const SimulationInput& input) {
+    if (!recording) {
+        return;
+    }
+
+    std::uint8_t code = encodeInput(input);
+    if (runLength > 0 && code != runCode) {
+        flushRun();
+    }
+    runCode = code;
+    runLength++;
+    data.tickCount++;
+}
+
+// Stop recording and write the file
+bool ReplayRecorder::save(const std::string& path, const SimulationState& finalState) {
+    if (!recording) {
+        return false;
+    }
+    flushRun();
+    recording = false;
+    data.finalChecksum = replay::checksum(finalState);
+
+    std::vector<std::uint8_t> bytes(REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC));
+    writeU32(bytes, REPLAY_VERSION);
+    writeConfig(bytes, data.config);
+    writeU64(bytes, data.seed);
+    writeString(bytes, data.player1Name);
+    writeString(bytes, data.player2Name);
+    writeU64(bytes, data.tickCount);
+    writeU64(bytes, data.finalChecksum);
+    bytes.insert(bytes.end(), data.inputRuns.begin(), data.inputRuns.end());
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open replay for writing: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    std::cout << "Saved replay (" << data.tickCount << " ticks, " << bytes.size() << " bytes): " << path << std::endl;
+    return file.good();
+}
+
+// Constructor
+ReplayPlayer::ReplayPlayer()
+    : readPos(0), runCode(0), runRemaining(0), ticksRead(0) {
+}
+
+// Load a replay file
+bool ReplayPlayer::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open replay: " << path << std::endl;
+        return false;
+    }
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (bytes.size() < sizeof(REPLAY_MAGIC) || std::memcmp(bytes.data(), REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0) {
+        std::cerr << "Not a replay file: " << path << std::endl;
+        return false;
+    }
+
+    ByteReader in(bytes, sizeof(REPLAY_MAGIC));
+    std::uint32_t version = 0;
+    if (!in.readU32(version) || version != REPLAY_VERSION) {
+        std::cerr << "Unsupported replay version in " << path << std::endl;
+        return false;
+    }
+
+    ReplayData loaded;
+    if (!readConfig(in, loaded.config) || !in.readU64(loaded.seed) ||
+        !in.readString(loaded.player1Name) || !in.readString(loaded.player2Name) ||
+        !in.readU64(loaded.tickCount) || !in.readU64(loaded.finalChecksum)) {
+        std::cerr << "Truncated replay header in " << path << std::endl;
+        return false;
+    }
+    loaded.inputRuns.assign(bytes.begin() + in.position(), bytes.end());
+
+    data = loaded;
+    rewind();
+    return true;
+}
+
+// Next tick's input
+bool ReplayPlayer::nextInput(SimulationInput& input) {
+    if (ticksRead >= data.tickCount) {
+        return false;
+    }
+
+    if (runRemaining == 0) {
+        ByteReader in(data.inputRuns, readPos);
+        if (!in.readByte(runCode) || !in.readVarint(runRemaining) || runRemaining == 0) {
+            std::cerr << "Corrupt replay input stream at tick " << ticksRead << std::endl;
+            ticksRead = data.tickCount;
+            return false;
+        }
+        readPos = in.position();
+    }
+
+    input = decodeInput(runCode);
+    runRemaining--;
+    ticksRead++;
+    return true;
+}
+
+// Start from the first tick again
+void ReplayPlayer::rewind() {
+    readPos = 0;
+    runCode = 0;
+    runRemaining = 0;
+    ticksRead = 0;
+}
+
+namespace replay {
+
+// FNV-1a over the gameplay-relevant fields
+std::uint64_t checksum(const SimulationState& state) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, std::size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+
+    const float floats[] = {
+        state.ball.x, state.ball.y, state.ball.vx, state.ball.vy, state.ball.currentSpeed,
+        state.paddle1.y, state.paddle2.y, state.countdownTimer
+    };
+    const std::int64_t ints[] = {
+        state.score1, state.score2, state.countdownNumber, state.isCountingDown ? 1 : 0,
+        state.matchOver ? 1 : 0, static_cast<std::int64_t>(state.tick)
+    };
+    mix(floats, sizeof(floats));
+    mix(ints, sizeof(ints));
+    return hash;
+}
+
+// Re-simulate as fast as possible and compare the end state
+bool runHeadless(const std::string& path, std::ostream& out) {
+    ReplayPlayer player;
+    if (!player.load(path)) {
+        return false;
+    }
+    const ReplayData& data = player.getData();
+
+    Simulation simulation(data.config);
+    simulation.resetMatch(data.seed);
+    float dt = simulation.getTickDuration();
+
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t allocationsBefore = alloc::allocationCount();
+    SimulationInput input;
+    while (player.nextInput(input)) {
+        simulation.step(input, dt);
+    }
+    std::uint64_t allocations = alloc::allocationCount() - allocationsBefore;
+    auto end = std::chrono::steady_clock::now();
+
+    const SimulationState& state = simulation.getState();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double matchSeconds = static_cast<double>(data.tickCount) / data.config.tickRate;
+    bool exact = checksum(state) == data.finalChecksum;
+
+    out << data.player1Name << " vs " << data.player2Name << ": " << state.score1 << " - " << state.score2
+        << " (" << data.tickCount << " ticks, seed " << data.seed << ")" << std::endl;
+    out << "Re-simulated " << matchSeconds << " s of play in " << seconds * 1000.0 << " ms ("
+        << (seconds > 0.0 ? matchSeconds / seconds : 0.0) << "x real time)" << std::endl;
+    if (alloc::isTracking()) {
+        out << "Heap allocations while stepping: " << allocations << std::endl;
+    }
+    out << (exact ? "Replay is bit-exact." : "MISMATCH: final state differs from the recording.") << std::endl;
+    return exact;
+}
+
+} // namespace replay
@@ -0,0 +1,156 @@
+#include "Simulation.h"
+#include "Physics.h"
+#include "Trace.h"
+#include <algorithm>
+
+// Constructor
+Simulation::Simulation(const SimulationConfig& cfg)
+    : config(cfg), state() {
+    state.ball.radius = config.ballRadius;
+    state.ball.baseSpeed = config.ballSpeed;
+    state.ball.currentSpeed = config.ballSpeed;
+    state.ball.speedUpFactor = config.speedUpFactor;
+    state.ball.maxSpeedFactor = config.maxSpeedFactor;
+
+    state.paddle1.width = config.paddleWidth;
+    state.paddle1.height = config.paddleHeight;
+    state.paddle1.speed = config.paddleSpeed;
+    state.paddle2 = state.paddle1;
+
+    resetMatch(0);
+}
+
+// Advance the match by one step
+StepResult Simulation::step(const SimulationInput& input, float deltaTime) {
+    PONG_TRACE_SCOPE("Simulation::step");
+    StepResult result;
+
+    if (state.matchOver) {
+        return result;
+    }
+
+    // Handle countdown
+    if (state.isCountingDown) {
+        physics::updateCountdown(state.isCountingDown, state.countdownTimer, state.countdownNumber, deltaTime);
+
+        // Paddles can move during the countdown, the ball can't
+        physics::updatePaddle(state.paddle1, input.player1, deltaTime, config.fieldHeight);
+        physics::updatePaddle(state.paddle2, input.player2, deltaTime, config.fieldHeight);
+        state.tick++;
+        return result;
+    }
+
+    // Update paddles
+    physics::updatePaddle(state.paddle1, input.player1, deltaTime, config.fieldHeight);
+    physics::updatePaddle(state.paddle2, input.player2, deltaTime, config.fieldHeight);
+
+    // Update ball and check wall/paddle collisions
+    if (config.continuousCollision) {
+        physics::sweepBall(state.ball, state.paddle1, state.paddle2, deltaTime, config.fieldHeight,
+                           result.wallHit, result.paddleHit);
+    } else {
+        result.wallHit = physics::updateBall(state.ball, deltaTime, config.fieldHeight);
+
+        if (physics::checkPaddleCollision(state.ball, state.paddle1)) {
+            result.paddleHit = true;
+        }
+        if (physics::checkPaddleCollision(state.ball, state.paddle2)) {
+            result.paddleHit = true;
+        }
+    }
+
+    // Check scoring
+    result.scorer = physics::checkScore(state.ball, config.fieldWidth);
+    if (result.scorer == 1) {
+        state.score1++;
+    } else if (result.scorer == 2) {
+        state.score2++;
+    }
+
+    if (result.scorer != 0) {
+        if (state.score1 >= config.maxScore || state.score2 >= config.maxScore) {
+            state.matchOver = true;
+            result.matchOver = true;
+        } else {
+            resetRound();
+        }
+    }
+
+    state.tick++;
+    return result;
+}
+
+// Reset everything for a new match
+void Simulation::resetMatch(std::uint64_t seed) {
+    state.seed = seed;
+    state.rng.seed(seed);
+    state.score1 = 0;
+    state.score2 = 0;
+    state.matchOver = false;
+    state.tick = 0;
+
+    state.paddle1.x = config.paddle1X;
+    state.paddle1.y = config.paddleStartY;
+    state.paddle2.x = config.paddle2X;
+    state.paddle2.y = config.paddleStartY;
+
+    resetRound();
+}
+
+// Reset round (ball position and countdown)
+void Simulation::resetRound() {
+    physics::resetBall(state.ball, config.fieldWidth, config.fieldHeight, state.rng);
+
+    state.isCountingDown = true;
+    state.countdownTimer = 1.0f;
+    state.countdownNumber = 3;
+}
+
+// Length of one fixed tick in seconds
+float Simulation::getTickDuration() const {
+    return 1.0f / static_cast<float>(config.tickRate);
+}
+
+// Blend paddle and ball positions between two consecutive ticks
+SimulationState interpolateState(const SimulationState& from, const SimulationState& to, float alpha) {
+    SimulationState blended = to;
+    if (from.tick + 1 != to.tick || from.score1 != to.score1 || from.score2 != to.score2) {
+        return blended;
+    }
+    blended.paddle1.y = from.paddle1.y + (to.paddle1.y - from.paddle1.y) * alpha;
+    blended.paddle2.y = from.paddle2.y + (to.paddle2.y - from.paddle2.y) * alpha;
+    blended.ball.x = from.ball.x + (to.ball.x - from.ball.x) * alpha;
+    blended.ball.y = from.ball.y + (to.ball.y - from.ball.y) * alpha;
+    return blended;
+}
+
+// Constructor
+FixedTimestep::FixedTimestep(float step, int maxSteps)
+    : stepSize(step), accumulator(0.0f), maxStepsPerFrame(maxSteps) {
+}
+
+// Bank frame time and return how many whole ticks are due
+int FixedTimestep::advance(float frameTime) {
+    accumulator += frameTime;
+
+    int steps = static_cast<int>(accumulator / stepSize);
+    if (steps > maxStepsPerFrame) {
+        // Too far behind (debugger, window drag) - drop the backlog instead of spiralling
+        steps = maxStepsPerFrame;
+        accumulator = 0.0f;
+        return steps;
+    }
+
+    accumulator -= steps * stepSize;
+    return steps;
+}
+
+// Drop banked time
+void FixedTimestep::reset() {
+    accumulator = 0.0f;
+}
+
+// Interpolation factor between the last two ticks
+float FixedTimestep::getAlpha() const {
+    return std::min(accumulator / stepSize, 1.0f);
+}
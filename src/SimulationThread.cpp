@@ -0,0 +1,119 @@
+#include "SimulationThread.h"
+#include "Trace.h"
+#include <SFML/System.hpp>
+#include <algorithm>
+
+// Constructor
+SimulationThread::SimulationThread(InputSampler& inputSampler)
+    : input(inputSampler), replay(nullptr), recorder(nullptr), stepSize(simulation.getTickDuration()),
+      stopping(false), running(false) {
+}
+
+// Destructor
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+// Take over the match and start ticking. The starting state is published
+// first, so the game has something to draw before the first tick.
+void SimulationThread::start(const Simulation& match, ReplayPlayer* replayPlayer, ReplayRecorder* replayRecorder) {
+    stop();
+    simulation = match;
+    replay = replayPlayer;
+    recorder = replayRecorder;
+    stepSize = simulation.getTickDuration();
+
+    TickSnapshot& first = snapshots.writeSlot();
+    first = TickSnapshot();
+    first.previous = simulation.getState();
+    first.state = simulation.getState();
+    first.publishedAt = InputSampler::now();
+    snapshots.publish();
+
+    stopping.store(false);
+    running = true;
+    thread = std::thread(&SimulationThread::run, this);
+}
+
+// Join the thread and hand the match back
+const Simulation& SimulationThread::stop() {
+    if (running) {
+        stopping.store(true);
+        thread.join();
+        running = false;
+    }
+    return simulation;
+}
+
+// Newest snapshot, if it is new
+const TickSnapshot* SimulationThread::takeLatest() {
+    return snapshots.take() ? &snapshots.read() : nullptr;
+}
+
+// Interpolation factor for drawing now
+float SimulationThread::getAlpha() const {
+    const TickSnapshot& latest = snapshots.read();
+    std::uint64_t now = InputSampler::now();
+    float since = (now > latest.publishedAt) ? static_cast<float>(now - latest.publishedAt) / 1e9f : 0.0f;
+    return std::min(latest.alpha + since / stepSize, 1.0f);
+}
+
+// Tick loop: run the ticks that are due, publish them, then sleep until
+// the next one. Stops by itself when the match or the replay ends.
+void SimulationThread::run() {
+    trace::setThreadName("simulation");
+    FixedTimestep timestep(stepSize);
+    std::uint64_t last = InputSampler::now();
+    std::uint32_t hits = 0;
+    std::uint32_t points = 0;
+    bool replayEnded = false;
+    bool done = false;
+
+    while (!done && !stopping.load()) {
+        std::uint64_t now = InputSampler::now();
+        int steps = timestep.advance(static_cast<float>(now - last) / 1e9f);
+        last = now;
+
+        if (steps > 0) {
+            PONG_TRACE_SCOPE("SimulationThread::ticks");
+            SimulationState previous = simulation.getState();
+            for (int i = 0; i < steps && !done; i++) {
+                SimulationInput keys = input.keysForStep(i, steps, now, timestep);
+                if (replay && !replay->nextInput(keys)) {
+                    replayEnded = true;
+                    done = true;
+                    break;
+                }
+                if (recorder) {
+                    recorder->record(keys);
+                }
+
+                previous = simulation.getState();
+                StepResult result = simulation.step(keys, stepSize);
+                if (result.wallHit || result.paddleHit) {
+                    hits++;
+                }
+                if (result.scorer != 0) {
+                    points++;
+                }
+                done = result.matchOver;
+            }
+
+            TickSnapshot& snapshot = snapshots.writeSlot();
+            snapshot.previous = previous;
+            snapshot.state = simulation.getState();
+            snapshot.publishedAt = InputSampler::now();
+            snapshot.alpha = timestep.getAlpha();
+            snapshot.hits = hits;
+            snapshot.points = points;
+            snapshot.firstKeyChange = input.takeFirstChange();
+            snapshot.replayEnded = replayEnded;
+            snapshot.done = done;
+            snapshots.publish();
+        }
+
+        if (!done) {
+            sf::sleep(sf::seconds(stepSize * (1.0f - timestep.getAlpha())));
+        }
+    }
+}
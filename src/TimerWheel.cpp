@@ -0,0 +1,158 @@
+#include "TimerWheel.h"
+#include <limits>
+
+// Constructor
+TimerWheel::TimerWheel(std::uint64_t resolutionNs, std::uint32_t capacity)
+    : resolution(resolutionNs > 0 ? resolutionNs : 1), current(0), due(capacity, 0), deadline(capacity, 0),
+      next(capacity, NONE), prev(capacity, NONE), list(capacity, NONE), heads(OVERDUE_LIST + 1, NONE), occupied(),
+      pending(0) {
+}
+
+// Arm a timer; the deadline is rounded up to a whole step
+void TimerWheel::schedule(std::uint32_t timer, std::uint64_t deadlineNs) {
+    if (list[timer] != NONE) {
+        unlink(timer);
+    }
+    deadline[timer] = deadlineNs;
+    due[timer] = deadlineNs / resolution + (deadlineNs % resolution != 0 ? 1 : 0);
+    place(timer);
+}
+
+// Disarm a timer
+void TimerWheel::cancel(std::uint32_t timer) {
+    if (list[timer] != NONE) {
+        unlink(timer);
+    }
+}
+
+// Step through time, cascading each level as its slot comes round and
+// collecting the level 0 slot of every step
+void TimerWheel::advance(std::uint64_t nowNs, std::vector<std::uint32_t>& expired) {
+    std::uint64_t target = nowNs / resolution;
+
+    while (heads[OVERDUE_LIST] != NONE) {
+        std::uint32_t timer = heads[OVERDUE_LIST];
+        unlink(timer);
+        expired.push_back(timer);
+    }
+
+    while (current < target) {
+        if (pending == 0) {
+            current = target;
+            break;
+        }
+        current++;
+
+        // Higher levels first, so their timers can fall all the way down
+        for (int level = LEVELS - 1; level > 0; level--) {
+            if ((current & ((1ULL << (SLOT_BITS * level)) - 1)) == 0) {
+                cascade(level);
+            }
+        }
+
+        // A cascaded timer due on this very step lands in the overdue list
+        while (heads[OVERDUE_LIST] != NONE) {
+            std::uint32_t timer = heads[OVERDUE_LIST];
+            unlink(timer);
+            expired.push_back(timer);
+        }
+        std::uint32_t slot = static_cast<std::uint32_t>(current & SLOT_MASK);
+        while (heads[slot] != NONE) {
+            std::uint32_t timer = heads[slot];
+            unlink(timer);
+            expired.push_back(timer);
+        }
+    }
+}
+
+// Next armed level 0 slot, or the next level 1 cascade if that comes first
+std::uint64_t TimerWheel::nextExpiry() const {
+    if (heads[OVERDUE_LIST] != NONE) {
+        return current * resolution;
+    }
+    if (pending == 0) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    std::uint64_t boundary = ((current >> SLOT_BITS) + 1) << SLOT_BITS;
+    for (std::uint64_t step = current + 1; step < boundary; step++) {
+        std::uint32_t slot = static_cast<std::uint32_t>(step & SLOT_MASK);
+        std::uint64_t word = occupied[slot / 64] >> (slot % 64);
+        if (word == 0) {
+            step += 63 - slot % 64;   // Rest of this word is empty
+            continue;
+        }
+        if (word & 1u) {
+            return step * resolution;
+        }
+    }
+    return boundary * resolution;
+}
+
+// Push onto the front of a list
+void TimerWheel::link(std::uint32_t timer, std::uint32_t listIndex) {
+    std::uint32_t head = heads[listIndex];
+    next[timer] = head;
+    prev[timer] = NONE;
+    if (head != NONE) {
+        prev[head] = timer;
+    }
+    heads[listIndex] = timer;
+    list[timer] = listIndex;
+    if (listIndex < static_cast<std::uint32_t>(SLOTS)) {
+        occupied[listIndex / 64] |= 1ULL << (listIndex % 64);
+    }
+    pending++;
+}
+
+// Remove from whichever list holds it
+void TimerWheel::unlink(std::uint32_t timer) {
+    std::uint32_t listIndex = list[timer];
+    if (prev[timer] != NONE) {
+        next[prev[timer]] = next[timer];
+    } else {
+        heads[listIndex] = next[timer];
+    }
+    if (next[timer] != NONE) {
+        prev[next[timer]] = prev[timer];
+    }
+    if (listIndex < static_cast<std::uint32_t>(SLOTS) && heads[listIndex] == NONE) {
+        occupied[listIndex / 64] &= ~(1ULL << (listIndex % 64));
+    }
+    list[timer] = NONE;
+    pending--;
+}
+
+// File a timer under the lowest level whose span reaches its deadline
+void TimerWheel::place(std::uint32_t timer) {
+    std::uint64_t step = due[timer];
+    if (step <= current) {
+        link(timer, OVERDUE_LIST);
+        return;
+    }
+
+    std::uint64_t delta = step - current;
+    for (int level = 0; level < LEVELS; level++) {
+        if (delta < (1ULL << (SLOT_BITS * (level + 1)))) {
+            std::uint32_t slot = static_cast<std::uint32_t>((step >> (SLOT_BITS * level)) & SLOT_MASK);
+            link(timer, static_cast<std::uint32_t>(level * SLOTS) + slot);
+            return;
+        }
+    }
+
+    // Beyond the top level: park in its furthest slot and re-file on the way down
+    int top = LEVELS - 1;
+    std::uint32_t slot = static_cast<std::uint32_t>(((current >> (SLOT_BITS * top)) - 1) & SLOT_MASK);
+    link(timer, static_cast<std::uint32_t>(top * SLOTS) + slot);
+}
+
+// The current slot of a level has come round: re-file its timers lower down
+void TimerWheel::cascade(int level) {
+    std::uint32_t slot = static_cast<std::uint32_t>((current >> (SLOT_BITS * level)) & SLOT_MASK);
+    std::uint32_t listIndex = static_cast<std::uint32_t>(level * SLOTS) + slot;
+    while (heads[listIndex] != NONE) {
+        std::uint32_t timer = heads[listIndex];
+        unlink(timer);
+        place(timer);
+    }
+}
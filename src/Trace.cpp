@@ -0,0 +1,160 @@
+#include "Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace trace {
+
+namespace detail {
+    std::atomic<bool> recording(false);
+}
+
+namespace {
+
+struct Event {
+    const char* name;
+    std::uint64_t startNs;
+    std::uint64_t durationNs;
+};
+
+// Fixed-size block of events. A full one gets a successor linked after
+// it, so recording never moves or copies the events already kept.
+const std::size_t CHUNK_EVENTS = 16384;
+
+struct Chunk {
+    Event events[CHUNK_EVENTS];
+    std::size_t count = 0;
+    std::unique_ptr<Chunk> next;
+};
+
+// One per thread that ever recorded; owned by the registry so the events
+// survive the thread
+struct ThreadBuffer {
+    std::uint32_t id;
+    std::string name;
+    std::unique_ptr<Chunk> first;
+    Chunk* last;
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+thread_local ThreadBuffer* localBuffer = nullptr;
+
+// The calling thread's buffer, registered on first use
+ThreadBuffer& threadBuffer() {
+    if (!localBuffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        localBuffer = buffers.back().get();
+        localBuffer->id = static_cast<std::uint32_t>(buffers.size());
+        localBuffer->name = "thread " + std::to_string(localBuffer->id);
+        localBuffer->first = std::make_unique<Chunk>();
+        localBuffer->last = localBuffer->first.get();
+    }
+    return *localBuffer;
+}
+
+// JSON string contents (zone and thread names are ours, but be safe)
+void writeEscaped(std::FILE* file, const char* text) {
+    for (; *text; text++) {
+        if (*text == '"' || *text == '\\') {
+            std::fputc('\\', file);
+        }
+        if (static_cast<unsigned char>(*text) >= 0x20) {
+            std::fputc(*text, file);
+        }
+    }
+}
+
+} // namespace
+
+// Report whether the macros are compiled in
+bool isCompiledIn() {
+#ifdef PONG_ENABLE_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Begin recording
+void start() {
+    now(); // Fix the time origin
+    detail::recording.store(true, std::memory_order_relaxed);
+}
+
+// Name the calling thread (a no-op in builds without the macros, so no
+// buffer is ever allocated there)
+void setThreadName(const char* name) {
+#ifdef PONG_ENABLE_TRACE
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.name = name;
+#else
+    (void)name;
+#endif
+}
+
+// Monotonic nanoseconds since the first call
+std::uint64_t now() {
+    static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+}
+
+// Append a finished zone to this thread's buffer
+void record(const char* name, std::uint64_t startNs, std::uint64_t endNs) {
+    ThreadBuffer& buffer = threadBuffer();
+    if (buffer.last->count == CHUNK_EVENTS) {
+        buffer.last->next = std::make_unique<Chunk>();
+        buffer.last = buffer.last->next.get();
+    }
+    buffer.last->events[buffer.last->count++] = Event{ name, startNs, endNs - startNs };
+}
+
+// Write complete ("X") events plus thread names, in microseconds
+bool writeFile(const std::string& path) {
+    detail::recording.store(false, std::memory_order_relaxed);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::size_t eventCount = 0;
+    const char* separator = "\n";
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers) {
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                     separator, buffer->id);
+        writeEscaped(file, buffer->name.c_str());
+        std::fprintf(file, "\"}}");
+        separator = ",\n";
+
+        for (const Chunk* chunk = buffer->first.get(); chunk; chunk = chunk->next.get()) {
+            for (std::size_t i = 0; i < chunk->count; i++) {
+                const Event& event = chunk->events[i];
+                std::fprintf(file, ",\n{\"name\":\"");
+                writeEscaped(file, event.name);
+                std::fprintf(file, "\",\"cat\":\"pong\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                             buffer->id, event.startNs / 1000.0, event.durationNs / 1000.0);
+            }
+            eventCount += chunk->count;
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    if (std::fclose(file) != 0) {
+        std::cerr << "Failed to write trace file: " << path << std::endl;
+        return false;
+    }
+    std::cout << "Wrote " << eventCount << " trace events to " << path << std::endl;
+    return true;
+}
+
+} // namespace trace
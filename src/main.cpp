@@ -1,7 +1,63 @@
 #include "Game.h"
+#include "Replay.h"
+#include "Trace.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 
-int main() {
+// Print command line help
+static void printUsage() {
+    std::cout << "Usage: pong [--seed N] [--record FILE] [--replay FILE [--headless]] [--assert-zero-alloc]\n"
+              << "            [--profile-format json|binary] [--import-profiles FILE] [--export-profiles FILE]\n"
+              << "            [--trace FILE] [--connect HOST[:PORT] [--latency MS] [--jitter MS] [--loss PERCENT]\n"
+              << "            [--rollback N]]\n"
+              << "  --seed N        Seed the first match with N (then N+1, ...) to reproduce it exactly\n"
+              << "  --record FILE   Save each match's per-tick inputs to FILE\n"
+              << "  --replay FILE   Watch a recorded match\n"
+              << "  --headless      With --replay: re-simulate without a window, as fast as possible\n"
+              << "  --assert-zero-alloc  Exit with an error if a PLAYING frame allocates after the first\n"
+              << "                  second (needs a PONG_TRACK_ALLOCATIONS build; pair with --replay)\n"
+              << "  --profile-format F   json (assets/profiles.json, default) or binary (assets/profiles.bin,\n"
+              << "                  memory-mapped; imports profiles.json on first use)\n"
+              << "  --import-profiles FILE  Merge profiles from a JSON file into the store and exit\n"
+              << "  --export-profiles FILE  Write every profile to a JSON file and exit\n"
+              << "  --trace FILE    Record timing zones and write them to FILE on exit, for chrome://tracing\n"
+              << "                  or ui.perfetto.dev (needs a PONG_ENABLE_TRACE build)\n"
+              << "  --connect HOST[:PORT]  Play online via pong-server (default port " << net::DEFAULT_PORT << "); your\n"
+              << "                  paddle and the ball are predicted, so they respond without waiting on the network\n"
+              << "  --latency MS    With --connect: delay every packet by MS each way, for testing\n"
+              << "  --jitter MS     With --connect: plus up to MS more, at random\n"
+              << "  --loss PERCENT  With --connect: drop this share of packets each way\n"
+              << "  --rollback N    With --connect: most ticks one correction re-simulates (default 32)\n"
+              << std::endl;
+}
+
+// Run whichever mode the options select; returns the exit code
+static int runMode(const GameOptions& options, bool headless, const std::string& importPath,
+                   const std::string& exportPath) {
+    // Profile interchange runs without a window
+    if (!importPath.empty() || !exportPath.empty()) {
+        ProfileManager profiles(options.profileStore);
+        bool ok = true;
+        if (!importPath.empty()) {
+            ok = profiles.importJson(importPath) && ok;
+        }
+        if (!exportPath.empty()) {
+            ok = profiles.exportJson(exportPath) && ok;
+        }
+        return profiles.flush() && ok ? 0 : 1;
+    }
+    
+    // Headless replay never opens a window
+    if (headless) {
+        if (options.replayPath.empty()) {
+            std::cerr << "--headless requires --replay FILE" << std::endl;
+            return 1;
+        }
+        return replay::runHeadless(options.replayPath, std::cout) ? 0 : 1;
+    }
+    
     std::cout << "==================================" << std::endl;
     std::cout << "    PONG CLONE - SFML C++17      " << std::endl;
     std::cout << "==================================" << std::endl;
@@ -9,9 +65,13 @@ int main() {
     
     try {
         // Create and run the game
-        Game game;
+        Game game(options);
         game.run();
         
+        if (!game.passedAllocationCheck()) {
+            return 1;
+        }
+        
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
@@ -20,3 +80,86 @@ int main() {
     std::cout << "\nThanks for playing!" << std::endl;
     return 0;
 }
+
+int main(int argc, char* argv[]) {
+    GameOptions options;
+    bool headless = false;
+    std::string importPath;
+    std::string exportPath;
+    std::string tracePath;
+    
+    // Parse command line
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.fixedSeed = true;
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            options.recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            options.replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--assert-zero-alloc") == 0) {
+            options.assertZeroAlloc = true;
+        } else if (std::strcmp(argv[i], "--profile-format") == 0 && i + 1 < argc) {
+            std::string format = argv[++i];
+            if (format == "binary") {
+                options.profileStore.format = ProfileFormat::BINARY;
+                options.profileStore.path = "assets/profiles.bin";
+            } else if (format != "json") {
+                std::cerr << "Unknown profile format: " << format << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--import-profiles") == 0 && i + 1 < argc) {
+            importPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--export-profiles") == 0 && i + 1 < argc) {
+            exportPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--connect") == 0 && i + 1 < argc) {
+            std::string address = argv[++i];
+            std::size_t colon = address.rfind(':');
+            options.connectHost = address.substr(0, colon);
+            if (colon != std::string::npos) {
+                options.connectPort = static_cast<unsigned short>(std::atoi(address.c_str() + colon + 1));
+            }
+        } else if (std::strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+            options.link.latency = std::strtof(argv[++i], nullptr) / 1000.0f;
+        } else if (std::strcmp(argv[i], "--jitter") == 0 && i + 1 < argc) {
+            options.link.jitter = std::strtof(argv[++i], nullptr) / 1000.0f;
+        } else if (std::strcmp(argv[i], "--loss") == 0 && i + 1 < argc) {
+            options.link.loss = std::strtof(argv[++i], nullptr) / 100.0f;
+        } else if (std::strcmp(argv[i], "--rollback") == 0 && i + 1 < argc) {
+            options.prediction.rollbackWindow = std::atoi(argv[++i]);
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    
+    if (options.assertZeroAlloc && !alloc::isTracking()) {
+        std::cerr << "--assert-zero-alloc needs a build with FEATURE_FLAGS=-DPONG_TRACK_ALLOCATIONS" << std::endl;
+        return 1;
+    }
+    
+    if (!options.connectHost.empty() && (options.connectPort == 0 || options.prediction.rollbackWindow <= 0)) {
+        std::cerr << "--connect needs a port in 1-65535 and --rollback a positive tick count" << std::endl;
+        return 1;
+    }
+    
+    if (!tracePath.empty()) {
+        if (!trace::isCompiledIn()) {
+            std::cerr << "--trace needs a build with FEATURE_FLAGS=-DPONG_ENABLE_TRACE" << std::endl;
+            return 1;
+        }
+        trace::setThreadName("main");
+        trace::start();
+    }
+    
+    // Every mode has joined its threads by the time it returns
+    int status = runMode(options, headless, importPath, exportPath);
+    if (!tracePath.empty() && !trace::writeFile(tracePath)) {
+        status = 1;
+    }
+    return status;
+}
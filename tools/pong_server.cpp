@@ -0,0 +1,359 @@
+#include "ClientPrediction.h"
+#include "GameServer.h"
+#include "NetClient.h"
+#include "PaddleAI.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+volatile std::sig_atomic_t interrupted = 0;
+
+void handleSignal(int) {
+    interrupted = 1;
+}
+
+// Print command line help
+void printUsage() {
+    std::cout << "Usage: pong-server [options]\n"
+              << "  --port N            UDP port (default " << net::DEFAULT_PORT << "; any free port with --loopback)\n"
+              << "  --max-matches N     Concurrent matches (default 512)\n"
+              << "  --workers N         Threads stepping matches (default 2)\n"
+              << "  --snapshot-every N  Ticks between snapshots (default 2)\n"
+              << "  --tick-rate N       Simulation ticks per second (default 120)\n"
+              << "  --max-score N       Points needed to win (default 5)\n"
+              << "  --seed N            Base seed; match i is seeded from (N, i) (default 1)\n"
+              << "  --timeout F         Seconds of silence before a player is dropped (default 5)\n"
+              << "  --seconds F         Stop after F seconds (default: until Ctrl+C; 10 with --loopback)\n"
+              << "  --quiet             No periodic status lines\n"
+              << "  --trace FILE        Record timing zones and write them to FILE on exit, for chrome://tracing\n"
+              << "  --loopback N        Also run N AI clients against this server over 127.0.0.1,\n"
+              << "                      rejoining as matches end, and report what they received\n"
+              << "                      and how well they predicted\n"
+              << "  --latency MS        Loopback clients: delay every packet by MS each way (default 0)\n"
+              << "  --jitter MS         Loopback clients: plus up to MS more, at random (default 0)\n"
+              << "  --loss PERCENT      Loopback clients: drop this share of packets each way (default 0)\n"
+              << "  --rollback N        Loopback clients: most ticks one correction re-simulates (default 32)\n"
+              << std::endl;
+}
+
+// How the loopback clients connect and predict
+struct LoopbackConfig {
+    int clients = 0;
+    LinkConditions link;
+    PredictionConfig prediction;
+};
+
+// What the loopback clients saw
+struct LoopbackTotals {
+    NetClientStats client;
+    PredictionStats prediction;
+    std::uint64_t matchesSeenFinished = 0;
+    std::uint64_t connections = 0;
+};
+
+void addStats(NetClientStats& total, const NetClientStats& stats) {
+    total.packetsIn += stats.packetsIn;
+    total.bytesIn += stats.bytesIn;
+    total.packetsOut += stats.packetsOut;
+    total.bytesOut += stats.bytesOut;
+    total.snapshots += stats.snapshots;
+    total.snapshotBytes += stats.snapshotBytes;
+    total.staleSnapshots += stats.staleSnapshots;
+    total.undecodable += stats.undecodable;
+    total.linkDropped += stats.linkDropped;
+}
+
+void addStats(PredictionStats& total, const PredictionStats& stats) {
+    total.ticksPredicted += stats.ticksPredicted;
+    total.snapshotsChecked += stats.snapshotsChecked;
+    total.mispredictions += stats.mispredictions;
+    total.fullReplays += stats.fullReplays;
+    total.ticksResimulated += stats.ticksResimulated;
+    total.deepestRollback = std::max(total.deepestRollback, stats.deepestRollback);
+    total.resyncs += stats.resyncs;
+    total.ticksAdded += stats.ticksAdded;
+    total.ticksDropped += stats.ticksDropped;
+    total.localCorrections += stats.localCorrections;
+    total.largestBallCorrection = std::max(total.largestBallCorrection, stats.largestBallCorrection);
+}
+
+// One AI player: a connection, its prediction and the brain driving its paddle
+struct LoopbackPlayer {
+    std::unique_ptr<NetClient> client;
+    std::unique_ptr<ClientPrediction> prediction;
+    std::unique_ptr<PaddleAI> ai;
+};
+
+// Open a fresh connection for a player slot
+void connectPlayer(LoopbackPlayer& player, unsigned short port, const LoopbackConfig& loopback) {
+    player.client = std::make_unique<NetClient>();
+    player.client->setLinkConditions(loopback.link);
+    player.client->connect(sf::IpAddress::LocalHost, port);
+    player.prediction.reset();
+    player.ai.reset();
+}
+
+// Play AI clients against the server at its tick rate until time runs out.
+// Each one plays like the game does: it predicts ahead of the server,
+// reconciles with every snapshot and its AI reacts to the predicted state.
+LoopbackTotals runLoopbackClients(unsigned short port, const LoopbackConfig& loopback, int tickRate,
+                                  double seconds) {
+    LoopbackTotals totals;
+    std::vector<LoopbackPlayer> players(static_cast<std::size_t>(loopback.clients));
+    for (LoopbackPlayer& player : players) {
+        connectPlayer(player, port, loopback);
+        totals.connections++;
+    }
+
+    auto tickLength = std::chrono::nanoseconds(1000000000LL / tickRate);
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
+    auto nextTick = start;
+    std::uint64_t seed = 1;
+
+    while (!interrupted && std::chrono::steady_clock::now() < deadline) {
+        for (LoopbackPlayer& player : players) {
+            NetClient& client = *player.client;
+            bool newSnapshot = client.update();
+
+            if (client.getStatus() == NetClient::Status::CLOSED) {
+                if (client.hasSnapshot() && client.getLatestState().matchOver) {
+                    totals.matchesSeenFinished++;
+                }
+                addStats(totals.client, client.getStats());
+                if (player.prediction) {
+                    addStats(totals.prediction, player.prediction->getStats());
+                }
+                connectPlayer(player, port, loopback);
+                totals.connections++;
+                continue;
+            }
+            if (client.getStatus() != NetClient::Status::PLAYING) {
+                continue;
+            }
+
+            if (!player.prediction) {
+                player.prediction = std::make_unique<ClientPrediction>(client.getConfig(), client.getPlayer(),
+                                                                       loopback.prediction);
+                player.ai = std::make_unique<PaddleAI>(ControllerType::AI, client.getPlayer(), seed++);
+            }
+            ClientPrediction& prediction = *player.prediction;
+            if (newSnapshot) {
+                prediction.reconcile(client.getLatestState(), client.getLatestInputs(), client.getLatestInputTick());
+            }
+
+            int steps = prediction.adjustSteps(1);
+            for (int i = 0; i < steps; i++) {
+                PaddleInput input = player.ai->think(prediction.getState(), client.getConfig());
+                client.sendInput(static_cast<std::uint32_t>(prediction.getTick()), input);
+                prediction.advance(input);
+            }
+        }
+
+        nextTick += tickLength;
+        std::this_thread::sleep_until(nextTick);
+    }
+
+    for (LoopbackPlayer& player : players) {
+        addStats(totals.client, player.client->getStats());
+        if (player.prediction) {
+            addStats(totals.prediction, player.prediction->getStats());
+        }
+        player.client->disconnect();
+    }
+    return totals;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+    bool portGiven = false;
+    LoopbackConfig loopback;
+    double seconds = 0;
+    std::string tracePath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (arg == "--quiet") {
+            config.reportInterval = 0;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return 1;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "--port") {
+            config.port = static_cast<unsigned short>(std::atoi(value.c_str()));
+            portGiven = true;
+        } else if (arg == "--max-matches") {
+            config.maxMatches = std::atoi(value.c_str());
+        } else if (arg == "--workers") {
+            config.workers = std::atoi(value.c_str());
+        } else if (arg == "--snapshot-every") {
+            config.snapshotInterval = std::atoi(value.c_str());
+        } else if (arg == "--tick-rate") {
+            config.simulation.tickRate = std::atoi(value.c_str());
+        } else if (arg == "--max-score") {
+            config.simulation.maxScore = std::atoi(value.c_str());
+        } else if (arg == "--seed") {
+            config.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--timeout") {
+            config.clientTimeout = std::strtof(value.c_str(), nullptr);
+        } else if (arg == "--seconds") {
+            seconds = std::strtod(value.c_str(), nullptr);
+        } else if (arg == "--loopback") {
+            loopback.clients = std::atoi(value.c_str());
+        } else if (arg == "--latency") {
+            loopback.link.latency = std::strtof(value.c_str(), nullptr) / 1000.0f;
+        } else if (arg == "--jitter") {
+            loopback.link.jitter = std::strtof(value.c_str(), nullptr) / 1000.0f;
+        } else if (arg == "--loss") {
+            loopback.link.loss = std::strtof(value.c_str(), nullptr) / 100.0f;
+        } else if (arg == "--rollback") {
+            loopback.prediction.rollbackWindow = std::atoi(value.c_str());
+        } else if (arg == "--trace") {
+            tracePath = value;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (config.simulation.tickRate <= 0 || config.maxMatches <= 0 || config.workers <= 0 ||
+        config.snapshotInterval <= 0 || loopback.prediction.rollbackWindow <= 0) {
+        std::cerr << "--tick-rate, --max-matches, --workers, --snapshot-every and --rollback must be positive"
+                  << std::endl;
+        return 1;
+    }
+    if (loopback.clients > 0) {
+        if (!portGiven) {
+            config.port = sf::Socket::AnyPort;
+        }
+        if (seconds <= 0) {
+            seconds = 10;
+        }
+    }
+
+    if (!tracePath.empty()) {
+        if (!trace::isCompiledIn()) {
+            std::cerr << "--trace needs a build with FEATURE_FLAGS=-DPONG_ENABLE_TRACE" << std::endl;
+            return 1;
+        }
+        trace::setThreadName("main");
+        trace::start();
+    }
+
+    GameServer server(config);
+    if (!server.start()) {
+        return 1;
+    }
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::thread serverThread([&server] {
+        trace::setThreadName("server");
+        server.run();
+    });
+
+    LoopbackTotals totals;
+    auto start = std::chrono::steady_clock::now();
+    if (loopback.clients > 0) {
+        std::cout << "Running " << loopback.clients << " loopback clients for " << seconds << " s" << std::endl;
+        totals = runLoopbackClients(server.getPort(), loopback, config.simulation.tickRate, seconds);
+    } else {
+        while (!interrupted &&
+               (seconds <= 0 || std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    server.stop();
+    serverThread.join();
+
+    // run() has joined the match workers, so every zone is in
+    bool traceWritten = tracePath.empty() || trace::writeFile(tracePath);
+
+    ServerStats stats = server.getStats();
+    std::printf("\nServer: %llu matches started, %llu finished, %llu abandoned, %llu joins rejected\n",
+                static_cast<unsigned long long>(stats.matchesStarted),
+                static_cast<unsigned long long>(stats.matchesFinished),
+                static_cast<unsigned long long>(stats.matchesAbandoned),
+                static_cast<unsigned long long>(stats.rejectedJoins));
+    std::printf("        %.0f packets/s in, %.0f packets/s out (%.1f KB/s), %llu send failures, %llu bad packets\n",
+                stats.packetsIn / elapsed, stats.packetsOut / elapsed, stats.bytesOut / elapsed / 1024.0,
+                static_cast<unsigned long long>(stats.sendFailures), static_cast<unsigned long long>(stats.badPackets));
+    if (stats.snapshotsSent > 0) {
+        std::printf("        %llu snapshots, %.1f bytes avg (%llu sent in full), %llu late inputs\n",
+                    static_cast<unsigned long long>(stats.snapshotsSent),
+                    static_cast<double>(stats.snapshotBytes) / stats.snapshotsSent,
+                    static_cast<unsigned long long>(stats.fullSnapshots),
+                    static_cast<unsigned long long>(stats.lateInputs));
+    }
+    if (stats.ticks > 0) {
+        const LatencyHistogram& lateness = stats.tickLateness;
+        std::printf("        %llu match ticks on %d workers (%llu skipped), late by p50 %.0f us, p99 %.0f us, "
+                    "p99.9 %.0f us, max %.0f us\n",
+                    static_cast<unsigned long long>(stats.ticks), server.getWorkerCount(),
+                    static_cast<unsigned long long>(stats.ticksSkipped), lateness.percentile(0.5) / 1000.0,
+                    lateness.percentile(0.99) / 1000.0, lateness.percentile(0.999) / 1000.0,
+                    lateness.max() / 1000.0);
+    }
+
+    if (loopback.clients == 0) {
+        return traceWritten ? 0 : 1;
+    }
+    const NetClientStats& client = totals.client;
+    std::printf("Clients: %llu connections, %llu matches seen to the end\n",
+                static_cast<unsigned long long>(totals.connections),
+                static_cast<unsigned long long>(totals.matchesSeenFinished));
+    std::printf("        %llu snapshots received (%.1f bytes avg), %llu stale, %llu undecodable\n",
+                static_cast<unsigned long long>(client.snapshots),
+                client.snapshots ? static_cast<double>(client.snapshotBytes) / client.snapshots : 0.0,
+                static_cast<unsigned long long>(client.staleSnapshots),
+                static_cast<unsigned long long>(client.undecodable));
+    if (loopback.link.isActive()) {
+        std::printf("        link: %.0f ms +%.0f ms jitter, %.1f%% loss (%llu packets dropped)\n",
+                    loopback.link.latency * 1000.0f, loopback.link.jitter * 1000.0f, loopback.link.loss * 100.0f,
+                    static_cast<unsigned long long>(client.linkDropped));
+    }
+
+    const PredictionStats& prediction = totals.prediction;
+    std::printf("Prediction: %llu ticks predicted, %llu of %llu snapshots mispredicted (%.1f%%)\n",
+                static_cast<unsigned long long>(prediction.ticksPredicted),
+                static_cast<unsigned long long>(prediction.mispredictions),
+                static_cast<unsigned long long>(prediction.snapshotsChecked),
+                prediction.snapshotsChecked ? 100.0 * prediction.mispredictions / prediction.snapshotsChecked : 0.0);
+    std::uint64_t rollbacks = prediction.mispredictions + prediction.fullReplays;
+    std::printf("        %llu ticks re-simulated (%.1f per rollback, deepest %d), %llu beyond the window, %llu resyncs\n",
+                static_cast<unsigned long long>(prediction.ticksResimulated),
+                rollbacks ? static_cast<double>(prediction.ticksResimulated) / rollbacks : 0.0,
+                prediction.deepestRollback, static_cast<unsigned long long>(prediction.fullReplays),
+                static_cast<unsigned long long>(prediction.resyncs));
+    std::printf("        own paddle corrected %llu times, largest ball correction %.1f px, clock +%llu/-%llu ticks\n",
+                static_cast<unsigned long long>(prediction.localCorrections), prediction.largestBallCorrection,
+                static_cast<unsigned long long>(prediction.ticksAdded),
+                static_cast<unsigned long long>(prediction.ticksDropped));
+
+    bool ok = client.snapshots > 0 && client.undecodable == 0;
+    std::cout << (ok ? "Loopback OK" : "Loopback FAILED") << std::endl;
+    return ok && traceWritten ? 0 : 1;
+}
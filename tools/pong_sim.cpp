@@ -0,0 +1,127 @@
+#include "BatchSimulator.h"
+#include "Replay.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Print command line help
+static void printUsage() {
+    std::cout << "Usage: pong-sim [options]\n"
+              << "  --matches N         Matches to play (default 1000)\n"
+              << "  --threads N         Worker threads (default: all cores)\n"
+              << "  --seed N            Base seed; match i is seeded from (N, i) (default 1)\n"
+              << "  --p1 TYPE           Left paddle: ai, idle or sweep (default ai)\n"
+              << "  --p2 TYPE           Right paddle: ai, idle or sweep (default ai)\n"
+              << "  --ball-speed F      Base ball speed in px/s (default 300)\n"
+              << "  --speed-up F        Speed multiplier per paddle hit (default 1.05)\n"
+              << "  --speed-cap F       Max speed as a multiple of base speed (default 1.5)\n"
+              << "  --max-score N       Points needed to win (default 5)\n"
+              << "  --tick-rate N       Simulation ticks per second (default 120)\n"
+              << "  --ai-error F        AI aim error in px (default 60)\n"
+              << "  --ai-reaction N     Ticks between AI decisions (default 8)\n"
+              << "  --discrete          Classic overlap collision instead of swept collision\n"
+              << "  --soa               Step matches in structure-of-arrays lanes with the SIMD kernel\n"
+              << "  --soa-scalar        Same lanes, scalar reference kernel (for comparison)\n"
+              << "  --lanes N           SoA lanes per worker (default 64)\n"
+              << "  --record FILE       Play one AI match (the first of the batch) and save it as a replay\n"
+              << "  --replay FILE       Re-simulate a replay headlessly and check it is bit-exact\n"
+              << "  --verify            Check the SIMD kernel is bit-identical to the scalar one and exit\n"
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BatchConfig config;
+    bool verify = false;
+    std::string recordPath;
+    std::string replayPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+
+        // Flags without a value
+        if (arg == "--soa" || arg == "--soa-scalar") {
+            config.useSoa = true;
+            config.useSimd = (arg == "--soa");
+            continue;
+        }
+        if (arg == "--discrete") {
+            config.simulation.continuousCollision = false;
+            continue;
+        }
+        if (arg == "--verify") {
+            verify = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return 1;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "--matches") {
+            config.matches = std::atoi(value.c_str());
+        } else if (arg == "--threads") {
+            config.threads = std::atoi(value.c_str());
+        } else if (arg == "--seed") {
+            config.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--p1" || arg == "--p2") {
+            ControllerType& type = (arg == "--p1") ? config.player1 : config.player2;
+            if (!PaddleAI::parseType(value, type)) {
+                std::cerr << "Unknown controller: " << value << std::endl;
+                return 1;
+            }
+        } else if (arg == "--ball-speed") {
+            config.simulation.ballSpeed = std::strtof(value.c_str(), nullptr);
+        } else if (arg == "--speed-up") {
+            config.simulation.speedUpFactor = std::strtof(value.c_str(), nullptr);
+        } else if (arg == "--speed-cap") {
+            config.simulation.maxSpeedFactor = std::strtof(value.c_str(), nullptr);
+        } else if (arg == "--max-score") {
+            config.simulation.maxScore = std::atoi(value.c_str());
+        } else if (arg == "--tick-rate") {
+            config.simulation.tickRate = std::atoi(value.c_str());
+        } else if (arg == "--ai-error") {
+            config.ai.aimError = std::strtof(value.c_str(), nullptr);
+        } else if (arg == "--ai-reaction") {
+            config.ai.reactionTicks = std::atoi(value.c_str());
+        } else if (arg == "--record") {
+            recordPath = value;
+        } else if (arg == "--replay") {
+            replayPath = value;
+        } else if (arg == "--lanes") {
+            config.lanesPerWorker = std::atoi(value.c_str());
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (config.matches <= 0 || config.simulation.maxScore <= 0 || config.simulation.tickRate <= 0) {
+        std::cerr << "--matches, --max-score and --tick-rate must be positive" << std::endl;
+        return 1;
+    }
+
+    if (!replayPath.empty()) {
+        return replay::runHeadless(replayPath, std::cout) ? 0 : 1;
+    }
+    if (!recordPath.empty()) {
+        return BatchSimulator(config).recordMatch(0, recordPath) ? 0 : 1;
+    }
+    if (verify) {
+        return BatchSimulator::verifySimd(config.simulation, 1024, 2000, config.seed, std::cout) ? 0 : 1;
+    }
+
+    std::cout << "Simulating " << config.matches << " matches..." << std::endl;
+
+    BatchSimulator simulator(config);
+    BatchReport report = simulator.run();
+    BatchSimulator::printReport(report, config, std::cout);
+
+    return 0;
+}